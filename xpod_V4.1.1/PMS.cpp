@@ -6,6 +6,9 @@
  * 
  * @editor  Percy Smith, percy.smith@colorado.edu
  * @date    July 31, 2025
+ * @log     Oct 2026: byte-per-call state machine replaced by poll()/parse(): drain
+ *          the UART, block scan for 0x42 0x4D, verify, keep the newest frame
+ *          Oct 2026: frames summed as they are decoded, takeMean() averages them
  ******************************************************************************/
 #include "Arduino.h"
 #include "PMS.h"
@@ -55,126 +58,163 @@ void PMS::requestRead()
   }
 }
 
-// Non-blocking function for parse response.
+// Non-blocking: drains everything the UART holds and parses every whole frame in it.
+// Returns the number of new checksum-verified frames; the newest is latest().
+uint8_t PMS::poll()
+{
+  uint8_t count = 0;
+  int pending;
+  while ((pending = _stream->available()) > 0)
+  {
+    // parse() always leaves less than one frame behind, so there is room for one more
+    uint8_t room = sizeof(_rx) - _fill;
+    uint8_t n = (pending < room) ? pending : room;
+    for (uint8_t i = 0; i < n; i++)
+    {
+      _rx[_fill++] = _stream->read();
+    }
+    count += parse();
+  }
+
+  return count;
+}
+
+// Non-blocking function for parse response: true if a new frame came in.
 bool PMS::read(DATA& data)
 {
-  _data = &data;
-  loop();
-  
-  return _status == STATUS_OK;
+  if (poll() == 0) return false;
+
+  data = _latest;
+  return true;
 }
 
 // Blocking function for parse response. Default timeout is 1s.
 bool PMS::readUntil(DATA& data, uint16_t timeout)
 {
-  _data = &data;
   uint32_t start = millis();
   do
   {
-    loop();
-    if (_status == STATUS_OK) break;
+    if (read(data)) return true;
   } while (millis() - start < timeout);
 
-  return _status == STATUS_OK;
+  return false;
 }
 
-void PMS::loop()
+// Mean of every frame decoded since the last call (rounded), into data; the sums
+// start over. Returns the number of frames averaged - 0 leaves data as it was.
+uint16_t PMS::takeMean(DATA& data)
 {
-  _status = STATUS_WAITING;
-  if (_stream->available())
+  uint16_t count = _summed;
+  if (count == 0) return 0;
+
+  // Particle counts only come in PMS5003 frames - averaged over those alone
+  uint16_t value[VALUES];
+  for (uint8_t i = 0; i < VALUES; i++)
   {
-    uint8_t ch = _stream->read();
+    uint16_t n = (i < 6) ? count : _summedParticles;
+    value[i] = n ? (_sum[i] + n / 2) / n : 0;
+    _sum[i] = 0;
+  }
+  toData(value, _summedParticles > 0, data);
 
-    switch (_index)
+  _summed = 0;
+  _summedParticles = 0;
+  return count;
+}
+
+// Finds and checks every whole frame in _rx, then keeps only what follows the last
+// one (or a possible start of a frame). Resyncs after noise, a truncated frame or a
+// bad checksum by scanning for the next 0x42 - a byte at a time only inside a frame
+// that failed. Returns the number of good frames.
+uint8_t PMS::parse()
+{
+  uint8_t count = 0;
+  uint8_t start = 0;
+  while (start < _fill)
+  {
+    const uint8_t* head = (const uint8_t*)memchr(_rx + start, 0x42, _fill - start);
+    if (head == NULL)
     {
-    case 0:
-      if (ch != 0x42)
-      {
-        return;
-      }
-      _calculatedChecksum = ch;
+      start = _fill;
       break;
+    }
+    start = head - _rx;
+    if (_fill - start < HEADER_BYTES) break;
 
-    case 1:
-      if (ch != 0x4D)
-      {
-        _index = 0;
-        return;
-      }
-      _calculatedChecksum += ch;
-      break;
+    uint16_t frameLen = makeWord(_rx[start + 2], _rx[start + 3]);
+    // Unsupported sensor, different frame length, transmission error e.t.c.
+    if (_rx[start + 1] != 0x4D || (frameLen != 2 * 9 + 2 && frameLen != 2 * 13 + 2))
+    {
+      start++;
+      continue;
+    }
+    if (_fill - start < HEADER_BYTES + frameLen) break;
 
-    case 2:
-      _calculatedChecksum += ch;
-      _frameLen = ch << 8;
-      break;
+    const uint8_t* frame = _rx + start;
+    uint16_t calculatedChecksum = 0;
+    for (uint8_t i = 0; i < HEADER_BYTES + frameLen - 2; i++)
+    {
+      calculatedChecksum += frame[i];
+    }
+    if (calculatedChecksum != makeWord(frame[HEADER_BYTES + frameLen - 2], frame[HEADER_BYTES + frameLen - 1]))
+    {
+      if (_checksumErrors < 0xFFFF) _checksumErrors++;
+      start++;
+      continue;
+    }
 
-    case 3:
-      _frameLen |= ch;
-      // Unsupported sensor, different frame length, transmission error e.t.c.
-      if (_frameLen != 2 * 9 + 2 && _frameLen != 2 * 13 + 2)
-      {
-        _index = 0;
-        return;
-      }
-      _calculatedChecksum += ch;
-      break;
+    decode(frame + HEADER_BYTES, frameLen);
+    _latestMs = millis();
+    if (_frames < 0xFFFF) _frames++;
+    count++;
+    start += HEADER_BYTES + frameLen;
+  }
 
-    default:
-      if (_index == _frameLen + 2)
-      {
-        _checksum = ch << 8;
-      }
-      else if (_index == _frameLen + 2 + 1)
-      {
-        _checksum |= ch;
-
-        if (_calculatedChecksum == _checksum)
-        {
-          _status = STATUS_OK;
-
-          // Standard Particles, CF=1.
-          _data->pm10_standard = makeWord(_payload[0], _payload[1]);
-          _data->pm25_standard = makeWord(_payload[2], _payload[3]);
-          _data->pm100_standard = makeWord(_payload[4], _payload[5]);
-
-          // Atmospheric Environment.
-          _data->pm10_env = makeWord(_payload[6], _payload[7]);
-          _data->pm25_env = makeWord(_payload[8], _payload[9]);
-          _data->pm100_env = makeWord(_payload[10], _payload[11]);
-
-          // Total particles
-          uint8_t dataWords = _frameLen/2 - 1; // subtract checksum
-          if (dataWords >= 12) {
-            _data->particles_03um = makeWord(_payload[12], _payload[13]);
-            _data->particles_05um = makeWord(_payload[14], _payload[15]);
-            _data->particles_10um = makeWord(_payload[16], _payload[17]);
-            _data->particles_25um = makeWord(_payload[18], _payload[19]);
-            _data->particles_50um = makeWord(_payload[20], _payload[21]);
-            _data->particles_100um = makeWord(_payload[22], _payload[23]);
-            _data->hasParticles = true;
-          }
-          else {
-            _data->hasParticles = false;
-          }
-        }
-        _index = 0;
-        return;
-      }
-      else
-      {
-        _calculatedChecksum += ch;
-        uint8_t payloadIndex = _index - 4;
-
-        if (payloadIndex < sizeof(_payload))
-        {
-          _payload[payloadIndex] = ch;
-        }
-      }
+  _fill -= start;
+  memmove(_rx, _rx + start, _fill);
+  return count;
+}
 
-      break;
-    }
+// Payload of a verified frame into _latest, and onto the sums.
+void PMS::decode(const uint8_t* payload, uint16_t frameLen)
+{
+  // Standard Particles (CF=1), Atmospheric Environment, then (PMS5003) total particles
+  uint8_t dataWords = frameLen/2 - 1; // subtract checksum
+  bool hasParticles = dataWords >= 12;
+  uint8_t words = hasParticles ? VALUES : 6;
+  uint16_t value[VALUES] = {};
+  for (uint8_t i = 0; i < words; i++)
+  {
+    value[i] = makeWord(payload[2 * i], payload[2 * i + 1]);
+  }
+  toData(value, hasParticles, _latest);
 
-    _index++;
+  // Stops summing rather than wrap (no takeMean() for ~18 hours at 1 frame/s)
+  if (_summed == 0xFFFF) return;
+  for (uint8_t i = 0; i < words; i++)
+  {
+    _sum[i] += value[i];
   }
+  _summed++;
+  if (hasParticles) _summedParticles++;
+}
+
+// Values in frame order into a DATA.
+void PMS::toData(const uint16_t* value, bool hasParticles, DATA& data)
+{
+  data.pm10_standard = value[0];
+  data.pm25_standard = value[1];
+  data.pm100_standard = value[2];
+
+  data.pm10_env = value[3];
+  data.pm25_env = value[4];
+  data.pm100_env = value[5];
+
+  data.particles_03um = value[6];
+  data.particles_05um = value[7];
+  data.particles_10um = value[8];
+  data.particles_25um = value[9];
+  data.particles_50um = value[10];
+  data.particles_100um = value[11];
+  data.hasParticles = hasParticles;
 }
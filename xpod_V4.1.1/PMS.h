@@ -6,6 +6,10 @@
  * 
  * @editor  Percy Smith, percy.smith@colorado.edu
  * @date    July 31, 2025
+ * @log     Oct 2026: poll() drains every byte the UART holds and keeps the newest
+ *          checksum-verified frame (+ its millis()); no more one byte per call
+ *          Oct 2026: every verified frame is also summed; takeMean() hands over the
+ *          mean of the frames since its last call (active mode averaging)
  ******************************************************************************/
 #ifndef PMS_H
 #define PMS_H
@@ -49,25 +53,44 @@ public:
   void passiveMode();
 
   void requestRead();
+  uint8_t poll();
+  const DATA& latest() const { return _latest; }
+  uint32_t latestMs() const { return _latestMs; }
+  uint16_t frames() const { return _frames; }
+  uint16_t checksumErrors() const { return _checksumErrors; }
+  uint16_t takeMean(DATA& data);
+
   bool read(DATA& data);
   bool readUntil(DATA& data, uint16_t timeout = SINGLE_RESPONSE_TIME);
 
 private:
-  enum STATUS { STATUS_WAITING, STATUS_OK };
   enum MODE { MODE_ACTIVE, MODE_PASSIVE };
 
-  uint8_t _payload[24];
+  static const uint8_t HEADER_BYTES = 4;     // 0x42 0x4D + frame length
+  static const uint8_t MAX_FRAME = 4 + 2 * 13 + 2;
+  static const uint8_t RX_BYTES = 2 * MAX_FRAME;
+  static const uint8_t VALUES = 12;          // uint16_t fields of DATA, in order
+
   Stream* _stream;
-  DATA* _data;
-  STATUS _status;
   MODE _mode = MODE_ACTIVE;
 
-  uint8_t _index = 0;
-  uint16_t _frameLen;
-  uint16_t _checksum;
-  uint16_t _calculatedChecksum;
+  // Bytes drained from the UART that don't make a whole frame yet (from _rx[0])
+  uint8_t _rx[RX_BYTES];
+  uint8_t _fill = 0;
+
+  DATA _latest = {};
+  uint32_t _latestMs = 0;
+  uint16_t _frames = 0;
+  uint16_t _checksumErrors = 0;
+
+  // Sums of the frames since the last takeMean()
+  uint32_t _sum[VALUES] = {};
+  uint16_t _summed = 0;
+  uint16_t _summedParticles = 0;
 
-  void loop();
+  uint8_t parse();
+  void decode(const uint8_t* frame, uint16_t frameLen);
+  static void toData(const uint16_t* value, bool hasParticles, DATA& data);
 };
 
 #endif
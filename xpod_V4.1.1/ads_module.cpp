@@ -12,6 +12,16 @@
  ******************************************************************************/
 #include "ads_module.h"
 
+#if ADS_RDY_ENABLED
+  // Set from the ALERT/RDY interrupts (bit = addr - 0x48); Wire can't run inside an
+  // ISR on AVR, so the ADS task reads the chip & pushes into the ring instead
+  static volatile uint8_t ads_rdy_flags = 0;
+  static void ads_rdy_isr_48() { ads_rdy_flags |= 0x01; }
+  static void ads_rdy_isr_49() { ads_rdy_flags |= 0x02; }
+  static void ads_rdy_isr_4A() { ads_rdy_flags |= 0x04; }
+  static void ads_rdy_isr_4B() { ads_rdy_flags |= 0x08; }
+#endif //ADS_RDY_ENABLED
+
 /**************************************************************************/
  /*!
  *    @brief  ADS_Module object; Assigns addresses & channels to ADS1115 modules
@@ -57,8 +67,24 @@ ADS_Module::ADS_Module()
   ads_module[AS_AUXILIARY].addr = 0x4A;
   ads_module[AS_AUXILIARY].channel = 2;
 
-  for (int i = 0; i < ADS_SENSOR_COUNT; i++)
+  for (int i = 0; i < ADS_SENSOR_COUNT; i++)  {
     ads_module[i].status = false;
+    frame[i] = 0;
+  }
+  frame_index = ADS_SENSOR_COUNT;
+
+  // Group the channel map by chip so parallel mode can run every chip at once
+  chip_count = 0;
+  for (int i = 0; i < ADS_SENSOR_COUNT; i++)
+  {
+    int chip = 0;
+    while (chip < chip_count && chip_addr[chip] != ads_module[i].addr)
+      chip++;
+    if (chip == chip_count && chip_count < ADS_CHIP_COUNT)
+      chip_addr[chip_count++] = ads_module[i].addr;
+  }
+  for (int chip = 0; chip < ADS_CHIP_COUNT; chip++)
+    chip_sensor[chip] = ADS_SENSOR_COUNT;
 } //ADS_Module()
 
 /**************************************************************************/
@@ -76,6 +102,10 @@ bool ADS_Module::begin()
       ads_module[i].status = true;
   }
 
+  #if ADS_RDY_ENABLED
+    begin_rdy();
+  #endif //ADS_RDY_ENABLED
+
   for (int i = 0; i < ADS_SENSOR_COUNT; i++)
   {
     if (ads_module[i].status == false)
@@ -174,4 +204,396 @@ ADS_Data ADS_Module::return_updated()
   delay(100);
 
   return dataset;
-} //ADS_Data ADS_Module::return_updated()
\ No newline at end of file
+} //ADS_Data ADS_Module::return_updated()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Mux setting of a sensor; Alphasense pair are differential, rest single-ended
+ *        @param  ads_sensor_id index of the sensor (in id_e form)
+ *    @return ADS1X15_REG_CONFIG_MUX_* value for startADCReading()
+ */
+/**************************************************************************/
+uint16_t ADS_Module::mux_for(ads_sensor_id_e ads_sensor_id)
+{
+  if (ads_sensor_id == AS_AUXILIARY)
+    return ADS1X15_REG_CONFIG_MUX_DIFF_0_1;
+  if (ads_sensor_id == AS_WORKER)
+    return ADS1X15_REG_CONFIG_MUX_DIFF_2_3;
+
+  return MUX_BY_CHANNEL[ads_module[ads_sensor_id].channel];
+} //uint16_t ADS_Module::mux_for(ads_sensor_id_e ads_sensor_id)
+
+/**************************************************************************/
+ /*!
+ *    @brief  Puts a sensor's error value in the frame (65535, Alphasense pair -999)
+ *        @param  id  sensor id
+ */
+/**************************************************************************/
+void ADS_Module::fail(uint8_t id)
+{
+  bool differential = (id == AS_AUXILIARY || id == AS_WORKER);
+  frame[id] = differential ? -999 : (int16_t)65535;
+  HEALTH_COUNT(SENTINEL);
+} //void ADS_Module::fail(uint8_t id)
+
+/**************************************************************************/
+ /*!
+ *    @brief  Checks a sensor's single-shot conversion once and reads it if done.
+ *            A NACK gives the sensor its error value for this frame (and the chip
+ *            moves on) instead of leaving the frame waiting on it forever
+ *        @param  id  sensor id
+ *    @return True once the sensor has its value for this frame
+ */
+/**************************************************************************/
+bool ADS_Module::read_result(uint8_t id)
+{
+  ADS1115_Rdy *adc = &ads_module[id].module;
+  uint16_t config, result;
+
+  if (adc->read_register(ADS1X15_REG_POINTER_CONFIG, &config))  {
+    if (!(config & ADS1X15_REG_CONFIG_OS_MASK))
+      return false;           //still converting
+    if (adc->read_register(ADS1X15_REG_POINTER_CONVERT, &result))  {
+      frame[id] = result;
+      return true;
+    } //if (adc->read_register(ADS1X15_REG_POINTER_CONVERT, &result))
+  } //if (adc->read_register(ADS1X15_REG_POINTER_CONFIG, &config))
+
+  HEALTH_COUNT(I2C_ADS);
+  fail(id);
+  return true;
+} //bool ADS_Module::read_result(uint8_t id)
+
+/**************************************************************************/
+ /*!
+ *    @brief  Starts a single-shot conversion of one sensor without waiting on it
+ *            Sensors whose ADS1115 failed begin() get their error value instead
+ *        @param  ads_sensor_id index of the sensor (in id_e form)
+ */
+/**************************************************************************/
+void ADS_Module::start_conversion(ads_sensor_id_e ads_sensor_id)
+{
+  ads_module_t *sensor = &ads_module[ads_sensor_id];
+
+  if (!sensor->status)  {
+    fail(ads_sensor_id);
+    return;
+  } //if (!sensor->status)
+
+  sensor->module.startADCReading(mux_for(ads_sensor_id), /*continuous=*/false);
+} //void ADS_Module::start_conversion(ads_sensor_id_e ads_sensor_id)
+
+/**************************************************************************/
+ /*!
+ *    @brief  Starts the next sensor (enum order, from "from" on) that lives on a chip;
+ *            sensors on a dead chip get their error value and are skipped
+ *        @param  chip  index into chip_addr
+ *        @param  from  first sensor id to consider
+ */
+/**************************************************************************/
+void ADS_Module::start_chip(uint8_t chip, uint8_t from)
+{
+  uint8_t id = from;
+  while (id < ADS_SENSOR_COUNT)
+  {
+    if (ads_module[id].addr == chip_addr[chip])  {
+      start_conversion((ads_sensor_id_e)id);
+      if (ads_module[id].status)
+        break;
+    } //if (ads_module[id].addr == chip_addr[chip])
+    id++;
+  }
+  chip_sensor[chip] = id;
+} //void ADS_Module::start_chip(uint8_t chip, uint8_t from)
+
+/**************************************************************************/
+ /*!
+ *    @brief  Begins a new frame; parallel mode starts a conversion on every chip,
+ *            otherwise only the first sensor's conversion is started
+ */
+/**************************************************************************/
+void ADS_Module::start()
+{
+  #if ADS_RDY_ENABLED
+    frame_ms = millis();    //chips are already converting continuously
+  #elif ADS_PARALLEL_ENABLED
+    for (uint8_t chip = 0; chip < chip_count; chip++)
+      start_chip(chip, 0);
+  #else
+    frame_index = 0;
+    start_conversion((ads_sensor_id_e)frame_index);
+  #endif //ADS_PARALLEL_ENABLED
+} //void ADS_Module::start()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Checks the converting sensor(s) once; stores each finished result and
+ *            moves that chip on to its next mux channel. Never waits on the ADS1115.
+ *    @return True once every sensor of the frame has a result
+ */
+/**************************************************************************/
+bool ADS_Module::poll()
+{
+  #if ADS_RDY_ENABLED
+    service_rdy();
+    return (millis() - frame_ms) >= (ADS_PERIOD_MS - SCHED_TICK_MS);
+  #elif ADS_PARALLEL_ENABLED
+    bool done = true;
+    for (uint8_t chip = 0; chip < chip_count; chip++)
+    {
+      uint8_t id = chip_sensor[chip];
+      if (id >= ADS_SENSOR_COUNT)
+        continue;
+
+      if (read_result(id))
+        start_chip(chip, id + 1);
+
+      if (chip_sensor[chip] < ADS_SENSOR_COUNT)
+        done = false;
+    }
+    return done;
+  #else
+    while (frame_index < ADS_SENSOR_COUNT)
+    {
+      ads_module_t *sensor = &ads_module[frame_index];
+      if (sensor->status && !read_result(frame_index))
+        return false;
+
+      frame_index++;
+      if (frame_index < ADS_SENSOR_COUNT)
+        start_conversion((ads_sensor_id_e)frame_index);
+    } //while (frame_index < ADS_SENSOR_COUNT)
+
+    return true;
+  #endif //ADS_PARALLEL_ENABLED
+} //bool ADS_Module::poll()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Returns the finished frame (call once poll() is true); in ALERT/RDY
+ *            mode each channel is the average of the samples taken this interval
+ *    @return ADS_Data structured dataset
+ */
+/**************************************************************************/
+ADS_Data ADS_Module::collect()
+{
+  #if ADS_RDY_ENABLED
+    for (uint8_t id = 0; id < ADS_SENSOR_COUNT; id++)
+    {
+      if (ads_module[id].status)
+        frame[id] = decimate(id);
+      else
+        fail(id);
+    }
+  #endif //ADS_RDY_ENABLED
+
+  return to_dataset();
+} //ADS_Data ADS_Module::collect()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Maps the raw frame onto the ADS_Data fields
+ *    @return ADS_Data structured dataset
+ */
+/**************************************************************************/
+ADS_Data ADS_Module::to_dataset()
+{
+  ADS_Data dataset;
+  dataset.Fig1 = frame[FIG1];
+  dataset.Fig2 = frame[FIG2];
+  dataset.Fig3 = frame[FIG3];
+  dataset.Fig3_heater = frame[FIG3_HEATER];
+  dataset.Fig4 = frame[FIG4];
+  dataset.Fig4_heater = frame[FIG4_HEATER];
+  #if MQ_ENABLED
+    dataset.Mq = frame[MQ];
+  #endif //MQ_ENABLED
+  #if PID_ENABLED
+    dataset.Pid = frame[PID];
+  #endif //PID_ENABLED
+  dataset.Misc2611 = frame[MISC2611];
+  dataset.Auxiliary = frame[AS_AUXILIARY];
+  dataset.Worker = frame[AS_WORKER];
+
+  return dataset;
+} //ADS_Data ADS_Module::to_dataset()
+
+
+/**************************************************************************/
+ /*!
+ *    @brief  Writes only the config register (continuous, RDY asserted per conversion)
+ *            so the chip restarts on a new mux channel; startADCReading() also 
+ *            rewrites both threshold registers, which only has to happen once
+ *        @param  mux ADS1X15_REG_CONFIG_MUX_* value
+ */
+/**************************************************************************/
+void ADS1115_Rdy::set_mux(uint16_t mux)
+{
+  uint16_t config = ADS1X15_REG_CONFIG_CQUE_1CONV | ADS1X15_REG_CONFIG_CLAT_NONLAT |
+                    ADS1X15_REG_CONFIG_CPOL_ACTVLOW | ADS1X15_REG_CONFIG_CMODE_TRAD |
+                    ADS1X15_REG_CONFIG_MODE_CONTIN | m_gain | m_dataRate | mux;
+  uint8_t buffer[3] = {ADS1X15_REG_POINTER_CONFIG, (uint8_t)(config >> 8), (uint8_t)(config & 0xFF)};
+  m_i2c_dev->write(buffer, 3);
+} //void ADS1115_Rdy::set_mux(uint16_t mux)
+
+/**************************************************************************/
+ /*!
+ *    @brief  Reads a 16 bit register
+ *        @param  reg    ADS1X15_REG_POINTER_*
+ *        @param  value  where the register goes (untouched on failure)
+ *    @return False if the chip NACKed or sent less than 2 bytes
+ */
+/**************************************************************************/
+bool ADS1115_Rdy::read_register(uint8_t reg, uint16_t *value)
+{
+  uint8_t buffer[2] = {reg, 0};
+  if (!m_i2c_dev->write_then_read(buffer, 1, buffer, 2))
+    return false;
+  *value = ((uint16_t)buffer[0] << 8) | buffer[1];
+  return true;
+} //bool ADS1115_Rdy::read_register(uint8_t reg, uint16_t *value)
+
+#if ADS_RDY_ENABLED
+/**************************************************************************/
+ /*!
+ *    @brief  Puts every chip in continuous mode at ADS_RDY_DATA_RATE on its first
+ *            sensor and hooks its ALERT/RDY pin (ADS_RDY_PINS) to an interrupt
+ *    @return True if every chip of the channel map is running
+ */
+/**************************************************************************/
+bool ADS_Module::begin_rdy()
+{
+  static const uint8_t rdy_pins[ADS_CHIP_COUNT] = ADS_RDY_PINS;
+  static void (*const rdy_isr[ADS_CHIP_COUNT])(void) = {
+    ads_rdy_isr_48, ads_rdy_isr_49, ads_rdy_isr_4A, ads_rdy_isr_4B
+  };
+  bool running = true;
+
+  memset(ring, 0, sizeof(ring));
+  for (uint8_t id = 0; id < ADS_SENSOR_COUNT; id++)
+  {
+    if (ads_module[id].status)
+      ads_module[id].module.setDataRate(ADS_RDY_DATA_RATE);
+    else
+      start_conversion((ads_sensor_id_e)id);   //just fills in the error value
+  }
+
+  for (uint8_t chip = 0; chip < chip_count; chip++)
+  {
+    uint8_t id = 0;
+    while (id < ADS_SENSOR_COUNT && !(ads_module[id].addr == chip_addr[chip] && ads_module[id].status))
+      id++;
+    chip_sensor[chip] = id;
+    if (id >= ADS_SENSOR_COUNT)  {
+      running = false;
+      continue;
+    } //if (id >= ADS_SENSOR_COUNT)
+
+    uint8_t n = chip_addr[chip] - ADS1X15_ADDRESS;
+    pinMode(rdy_pins[n], INPUT_PULLUP);     //ALERT/RDY is open drain
+    attachInterrupt(digitalPinToInterrupt(rdy_pins[n]), rdy_isr[n], FALLING);
+    ads_module[id].module.startADCReading(mux_for((ads_sensor_id_e)id), /*continuous=*/true);
+  }
+  frame_ms = millis();
+
+  return running;
+} //bool ADS_Module::begin_rdy()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Next sensor sharing a chip with id (wraps around; id itself if alone)
+ *        @param  id  sensor currently muxed on the chip
+ *    @return sensor id to mux next
+ */
+/**************************************************************************/
+uint8_t ADS_Module::next_on_chip(uint8_t id)
+{
+  for (uint8_t step = 1; step < ADS_SENSOR_COUNT; step++)
+  {
+    uint8_t next = (id + step) % ADS_SENSOR_COUNT;
+    if (ads_module[next].addr == ads_module[id].addr && ads_module[next].status)
+      return next;
+  }
+  return id;
+} //uint8_t ADS_Module::next_on_chip(uint8_t id)
+
+/**************************************************************************/
+ /*!
+ *    @brief  For every chip that raised ALERT/RDY: reads the result (conversion
+ *            register only - no config polling), pushes it into that sensor's 
+ *            ring and muxes the chip on to its next sensor
+ */
+/**************************************************************************/
+void ADS_Module::service_rdy()
+{
+  noInterrupts();
+  uint8_t ready = ads_rdy_flags;
+  interrupts();
+
+  for (uint8_t chip = 0; chip < chip_count; chip++)
+  {
+    uint8_t bit = 1 << (chip_addr[chip] - ADS1X15_ADDRESS);
+    uint8_t id = chip_sensor[chip];
+    if (!(ready & bit) || id >= ADS_SENSOR_COUNT)
+      continue;
+
+    uint16_t result;
+    if (ads_module[id].module.read_register(ADS1X15_REG_POINTER_CONVERT, &result))
+      push(id, result);
+    else
+      HEALTH_COUNT(I2C_ADS);
+    uint8_t next = next_on_chip(id);
+    if (next != id)
+      ads_module[next].module.set_mux(mux_for((ads_sensor_id_e)next));
+    chip_sensor[chip] = next;
+
+    // Clear after the mux write: any RDY edge from here on belongs to "next"
+    noInterrupts();
+    ads_rdy_flags &= ~bit;
+    interrupts();
+  }
+} //void ADS_Module::service_rdy()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Adds one result to a sensor's ring buffer
+ *        @param  id     sensor id
+ *        @param  value  raw ADS1115 result
+ */
+/**************************************************************************/
+void ADS_Module::push(uint8_t id, int16_t value)
+{
+  ads_ring_t *r = &ring[id];
+  r->sample[r->head] = value;
+  r->head = (r->head + 1) & (ADS_RING_DEPTH - 1);
+  if (r->fresh < ADS_RING_DEPTH)
+    r->fresh++;
+} //void ADS_Module::push(uint8_t id, int16_t value)
+
+/**************************************************************************/
+ /*!
+ *    @brief  Averages the samples pushed since the last call (newest ADS_RING_DEPTH
+ *            at most) and starts a new interval
+ *        @param  id  sensor id
+ *    @return rounded mean, or the error value if nothing arrived (ALERT/RDY
+ *            unwired, stuck or on the wrong pin - not a frozen old reading)
+ */
+/**************************************************************************/
+int16_t ADS_Module::decimate(uint8_t id)
+{
+  ads_ring_t *r = &ring[id];
+  if (r->fresh == 0)  {
+    fail(id);
+    return frame[id];
+  } //if (r->fresh == 0)
+
+  int32_t sum = 0;
+  for (uint8_t k = 1; k <= r->fresh; k++)
+    sum += r->sample[(r->head - k) & (ADS_RING_DEPTH - 1)];
+  int32_t half = (sum < 0) ? -(r->fresh / 2) : (r->fresh / 2);
+  int16_t mean = (sum + half) / r->fresh;
+
+  r->fresh = 0;
+  return mean;
+} //int16_t ADS_Module::decimate(uint8_t id)
+#endif //ADS_RDY_ENABLED
@@ -18,8 +18,12 @@
 #include <stdint.h>
 
 #include "xpod_node.h"
+#include "health_module.h"
 
 
+/****************** SET ADDR & CONST ********************/
+#define ADS_CHIP_COUNT        4   //GND 0x48, 5V 0x49, SDA 0x4A, SCL 0x4B
+
 /****************** STRUCTS, OBJECTS ********************/
 /*! Index: FIG1, FIG2, FIG3, FIG4, FIG3_HEATER, FIG4_HEATER, MISC2611, AS_WORKER, AS_AUXILIARY, COUNT */
 enum ads_sensor_id_e
@@ -42,15 +46,31 @@ enum ads_sensor_id_e
     ADS_SENSOR_COUNT
 }; //enum ads_sensor_id_e
 
+/*! Adafruit_ADS1115 + the bare config write continuous (ALERT/RDY) mode needs,
+ *  and a register read that reports a NACK (readRegister() can't) */
+class ADS1115_Rdy : public Adafruit_ADS1115 {
+  public:
+    void set_mux(uint16_t mux);
+    bool read_register(uint8_t reg, uint16_t *value);
+};
+
 /*! (per each sensor) addr, channel, status, module (ADS1115) */
 struct ads_module_t
 {
     uint8_t addr;
     int8_t channel;
     bool status;
-    Adafruit_ADS1115 module;
+    ADS1115_Rdy module;
 }; //struct ads_module_t
 
+/*! Last ADS_RING_DEPTH results of one channel + how many arrived this interval */
+struct ads_ring_t
+{
+    int16_t sample[ADS_RING_DEPTH];
+    uint8_t head;             //next slot to write
+    uint8_t fresh;            //samples pushed since the last collect() (saturates at depth)
+}; //struct ads_ring_t
+
 /*! ADS data structure (ALL DATA) as uint16_t */
 struct ADS_Data
 {
@@ -84,8 +104,40 @@ class ADS_Module {
 
     ADS_Data return_updated();
 
+    // Non-blocking frame for the scheduler: start() -> poll() until true -> collect()
+    void start();
+    bool poll();
+    ADS_Data collect();
+
   private:
+    uint16_t mux_for(ads_sensor_id_e ads_sensor_id);
+    void fail(uint8_t id);
+    bool read_result(uint8_t id);
+    void start_conversion(ads_sensor_id_e ads_sensor_id);
+    void start_chip(uint8_t chip, uint8_t from);
+    ADS_Data to_dataset();
+
+    #if ADS_RDY_ENABLED
+      bool begin_rdy();
+      void service_rdy();
+      uint8_t next_on_chip(uint8_t id);
+      void push(uint8_t id, int16_t value);
+      int16_t decimate(uint8_t id);
+    #endif //ADS_RDY_ENABLED
+
     ads_module_t ads_module[ADS_SENSOR_COUNT];
+    int16_t frame[ADS_SENSOR_COUNT];     //raw result per sensor of the current frame
+    uint8_t frame_index;                 //sensor currently converting (ADS_SENSOR_COUNT = done)
+
+    // Parallel mode: each chip works down its own sensors (enum order) independently
+    uint8_t chip_addr[ADS_CHIP_COUNT];   //addresses found in the channel map
+    uint8_t chip_sensor[ADS_CHIP_COUNT]; //sensor converting on each chip (ADS_SENSOR_COUNT = done)
+    uint8_t chip_count;
+
+    #if ADS_RDY_ENABLED
+      ads_ring_t ring[ADS_SENSOR_COUNT];  //oversampled results, decimated in collect()
+      uint32_t frame_ms;                  //start of the averaging interval
+    #endif //ADS_RDY_ENABLED
 };
 
 #endif //_ADS_MODULE_H
\ No newline at end of file
@@ -17,6 +17,7 @@
 BME_Module::BME_Module()
 {
   status = false;
+  started = false;
 }
 
 /**************************************************************************/
@@ -43,14 +44,57 @@ bool BME_Module::begin()
 
 /**************************************************************************/
  /*!
- *    @brief  Updates T, P, RH, GR readings 
+ *    @brief  Updates T, P, RH, GR readings (blocks for TPH + gas heater)
  *    @return BME_Data updated readings of T, P, RH, GR
  */
 /**************************************************************************/
 BME_Data BME_Module::return_updated() 
+{
+  start();
+  return collect();
+}; //BME_Data BME_Module::return_updated()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Starts a forced-mode TPH + gas measurement and returns right away
+ *    @return true/false - did the BME680 accept the measurement?
+ */
+/**************************************************************************/
+bool BME_Module::start()
+{
+  started = (bme_sensor.beginReading() != 0);
+  if (!started)
+    HEALTH_COUNT(I2C_BME);
+  return started;
+} //bool BME_Module::start()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Checks (no I2C) whether the TPH conversion & heater phase are over
+ *    @return true once collect() will not block
+ */
+/**************************************************************************/
+bool BME_Module::poll()
+{
+  if (!started)
+    return true;
+  return bme_sensor.remainingReadingMillis() == Adafruit_BME680::reading_complete;
+} //bool BME_Module::poll()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Reads out the measurement started by start()
+ *    @return BME_Data updated readings of T, P, RH, GR (-99/0 on failure)
+ */
+/**************************************************************************/
+BME_Data BME_Module::collect()
 {
   BME_Data data_buffer; 
-  if (!bme_sensor.performReading())  {
+  bool read = started && bme_sensor.endReading();
+  if (started && !read)
+    HEALTH_COUNT(I2C_BME);
+  if (!read)  {
+    HEALTH_COUNT(SENTINEL);
     data_buffer.T = -99;
     data_buffer.P = 0;
     data_buffer.RH = -99;
@@ -60,7 +104,8 @@ BME_Data BME_Module::return_updated()
     data_buffer.P = bme_sensor.pressure;
     data_buffer.RH = bme_sensor.humidity;
     data_buffer.GR = bme_sensor.gas_resistance;
-  } //if (!bme_sensor.performReading()) 
+  } //if (!read)
+  started = false;
 
   return data_buffer;
-}; //BME_Data BME_Module::return_updated()
+} //BME_Data BME_Module::collect()
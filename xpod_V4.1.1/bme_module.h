@@ -15,6 +15,7 @@
 #include <Adafruit_BME680.h>
 
 #include "xpod_node.h"
+#include "health_module.h"
 
 /****************** STRUCTS, OBJECTS ********************/
 /*! BME680 data structure (ALL DATA) as respective datatypes */
@@ -33,9 +34,15 @@ class BME_Module {
 
     BME_Data return_updated();
 
+    // Split reading: start() -> poll() until true -> collect(); the heater runs in between
+    bool start();
+    bool poll();
+    BME_Data collect();
+
   private:
     Adafruit_BME680 bme_sensor;
     bool status;
+    bool started;     //beginReading() accepted, endReading() still owed
 };
 
 #endif //_BME_MODULE_H
\ No newline at end of file
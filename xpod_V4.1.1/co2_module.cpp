@@ -2,59 +2,109 @@
  * @file    co2_module.cpp
  * @brief   Splits CO2 firmware from ino 
  *
- * @cite    YPOD Original .ino (by ???)
+ * @cite    YPOD Original .ino (by ???); frame check from ELT_S300_Library S300I2C
  *
  * @author  Percy Smith, percy.smith@colorado.edu
  * @date    July 25, 2025 
  * @log     for some reason it wrote to "long" data type and then "float" (weird) -- changed to uint16_t
+ *          Oct 2026: one request + 7 byte read per call, no delay(); frame checked, last good
+ *          value cached (getS300CO2() no longer touches the bus)
 ******************************************************************************/
 #include "co2_module.h"
 
+/**************************************************************************/
+ /*!
+ *    @brief  No reading until the first good frame
+ */
+/**************************************************************************/
+ELT_S300::ELT_S300()
+{
+  ppm = 0;
+  ppm_ms = 0;
+  have_ppm = false;
+}
+
 /**************************************************************************/
  /*!
  *    @brief  begins Wire object
  */
 /**************************************************************************/
-ELT_S300::begin()
+void ELT_S300::begin()
 {
   Wire.begin(); //just in case lol
 }
 
 /**************************************************************************/
  /*!
- *    @brief  Reads incoming I2C communication with the CO2 Sensor
- *    @return uint16_t of CO2 reading
+ *    @brief  Asks the S300 for its latest measurement and checks the frame: status
+ *            0x08 and no 0xFF in the reserved bytes (what a floating bus reads).
+ *            A good frame replaces the cached value; a bad one leaves it as it was.
+ *            Never waits - call every CO2_UPDATE_MS
+ *    @return True if a good frame came back
+ */
+/**************************************************************************/
+bool ELT_S300::read()
+{
+  uint8_t frame[CO2_FRAME_BYTES];
+  if (!wire_setup(CO2_I2C_ADDR, CO2_ACKNOWLEDGE_ADDR, CO2_FRAME_BYTES))  {
+    while (Wire.available())
+      Wire.read();
+    HEALTH_COUNT(I2C_CO2);
+    return false;
+  } //if (!wire_setup(...))
+  for (uint8_t i = 0; i < CO2_FRAME_BYTES; i++)
+    frame[i] = Wire.read();
+
+  if (frame[0] != CO2_STATUS_OK || frame[3] == 0xFF || frame[4] == 0xFF || frame[5] == 0xFF || frame[6] == 0xFF)  {
+    HEALTH_COUNT(I2C_CO2);
+    return false;
+  } //if (bad frame)
+  ppm = ((uint16_t)frame[1] << 8) | frame[2];
+  ppm_ms = millis();
+  have_ppm = true;
+  return true;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Last good CO2 reading (read()) - no I2C traffic
+ *    @return uint16_t of CO2 reading (ppm, 0 before the first good frame)
  */
 /**************************************************************************/
 uint16_t ELT_S300::getS300CO2() {
-  int i = 1;
-  uint16_t reading;
-  wire_setup(CO2_I2C_ADDR, CO2_ACKNOWLEDGE_ADDR, 7);
-
-  while (Wire.available()) {
-    byte val = Wire.read();
-    if (i == 2) {
-      reading = val;
-      reading = reading << 8;
-      delay(10);
-    }
-    if (i == 3) {
-      reading = reading | val;
-      delay(10);
-    }
-    i = i + 1;
-  }
-  return reading;
+  return ppm;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return ms since the cached reading came in (0xFFFFFFFF if none yet)
+ */
+/**************************************************************************/
+uint32_t ELT_S300::age_ms()
+{
+  return have_ppm ? millis() - ppm_ms : 0xFFFFFFFF;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return True if the cached reading is younger than CO2_STALE_MS
+ */
+/**************************************************************************/
+bool ELT_S300::fresh()
+{
+  return age_ms() < CO2_STALE_MS;
 }
 
 /**************************************************************************/
  /*!
  *    @brief  sets up the I2C comms with ELT S300 CO2 Sensor
+ *    @return false if the command was NACKed or fewer than "from" bytes came back
  */
 /**************************************************************************/
-void ELT_S300::wire_setup(int address, byte cmd, int from) {
+bool ELT_S300::wire_setup(int address, byte cmd, int from) {
   Wire.beginTransmission(address);
   Wire.write(cmd);
-  Wire.endTransmission();
-  Wire.requestFrom(address, from);
-}
\ No newline at end of file
+  uint8_t err = Wire.endTransmission();
+  uint8_t got = Wire.requestFrom(address, from);
+  return err == 0 && got == from;
+}
@@ -7,6 +7,8 @@
  * @author  Percy Smith, percy.smith@colorado.edu
  * @date    July 25, 2025 
  * @log     for some reason it wrote to "long" data type and then "float" (weird) -- changed to uint16_t
+ *          Oct 2026: no delay() per byte; read() checks the frame (status 0x08, no 0xFF
+ *          bytes - as S300I2C::getCO2ppm()) & caches the last good value with its millis()
 ******************************************************************************/
 #ifndef _CO2_MODULE_H
 #define _CO2_MODULE_H
@@ -16,6 +18,7 @@
 #include <Wire.h>             //P - last tested with "Wire@1.0"
 
 #include "xpod_node.h"
+#include "health_module.h"
 
 /****************** SET ADDR & CONST ********************/
 // Available Commands
@@ -25,17 +28,30 @@
 // Limitations 
 #define MAX_I2C_SPD           400000
 #define REC_I2C_SPD           100000
+// Frame: status, CO2 MSB, CO2 LSB, 4 reserved
+#define CO2_FRAME_BYTES       7
+#define CO2_STATUS_OK         0x08
+#define CO2_UPDATE_MS         3000    //S300 measures every 3 s - reading faster only repeats it
+#define CO2_STALE_MS          (3 * CO2_UPDATE_MS)   //no good frame for this long: no value
 
 
 /****************** CLASSES ********************/
 /*! ELT_S300 class to include functionality from YPOD's .ino */
 class ELT_S300 {
   public:
-    begin();
+    ELT_S300();
+    void begin();
+    bool read();
     uint16_t getS300CO2();
+    uint32_t age_ms();
+    bool fresh();
 
   private:
-    void wire_setup(int address, byte cmd, int from);
+    bool wire_setup(int address, byte cmd, int from);
+
+    uint16_t ppm;               //last good reading
+    uint32_t ppm_ms;            //...and when it came
+    bool have_ppm;
 };
 
 #endif  //_CO2_MODULE_H
\ No newline at end of file
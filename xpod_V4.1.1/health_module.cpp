@@ -0,0 +1,194 @@
+/*******************************************************************************
+ * @file    health_module.cpp
+ * @brief   Pod health telemetry (HEALTH_ENABLED): reset cause & EEPROM boot
+ *          counter at boot, tick time/jitter per row, free stack & error counters
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include "health_module.h"
+
+#include <EEPROM.h>
+#include <FreeStack.h>
+#include <avr/wdt.h>
+
+#if HEALTH_ENABLED
+  Health_Module health;
+
+  #if defined(__AVR__)
+    // Runs before main(): keeps MCUSR & clears it (else the next reset still shows
+    // these bits), and stops the watchdog a watchdog reset leaves running
+    uint8_t health_mcusr __attribute__((section(".noinit")));
+    void health_save_mcusr(void) __attribute__((naked, used, section(".init3")));
+    void health_save_mcusr(void)
+    {
+      health_mcusr = MCUSR;
+      MCUSR = 0;
+      wdt_disable();
+    }
+  #endif //defined(__AVR__)
+#endif //HEALTH_ENABLED
+
+/**************************************************************************/
+ /*!
+ *    @brief  Nothing known until begin()
+ */
+/**************************************************************************/
+Health_Module::Health_Module()
+{
+  boot_count = 0;
+  mcusr = 0;
+  stack_low = 0xFFFF;
+  memset(counters, 0, sizeof(counters));
+  next_row();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Takes the reset cause, counts this boot in EEPROM (HEALTH_EEPROM_ADDR)
+ *            and paints the free stack. Call last in setup() - the libraries'
+ *            begin()s allocate on the heap, which would cover the paint
+ */
+/**************************************************************************/
+void Health_Module::begin()
+{
+  #if defined(__AVR__)
+    mcusr = health_mcusr;
+  #else
+    mcusr = MCUSR;
+    MCUSR = 0;
+  #endif //defined(__AVR__)
+
+  uint32_t stored;
+  EEPROM.get(HEALTH_EEPROM_ADDR, stored);
+  boot_count = (stored == 0xFFFFFFFF) ? 1 : stored + 1;   //erased EEPROM reads 0xFF
+  EEPROM.put(HEALTH_EEPROM_ADDR, boot_count);
+
+  FillStack();
+} //void Health_Module::begin()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Folds one scheduler tick into this row's window
+ *        @param  tick_us  how long the tick's steps took
+ *        @param  late_ms  how far after its slot the tick started
+ */
+/**************************************************************************/
+void Health_Module::tick(uint32_t tick_us, uint16_t late_ms)
+{
+  if (ticks < 0xFFFF)  {
+    ticks++;
+    tick_sum_us += tick_us;
+  } //if (ticks < 0xFFFF)
+  if (tick_us > tick_worst_us)
+    tick_worst_us = tick_us;
+  if (late_ms > late_worst_ms)
+    late_worst_ms = late_ms;
+
+  #if !HAS_UNUSED_STACK
+    int free_stack = FreeStack();
+    if (free_stack < stack_low)
+      stack_low = (free_stack < 0) ? 0 : free_stack;
+  #endif //!HAS_UNUSED_STACK
+} //void Health_Module::tick()
+
+/**************************************************************************/
+ /*!
+ *    @brief  One more of an error (HEALTH_COUNT())
+ *        @param  counter  which error
+ */
+/**************************************************************************/
+void Health_Module::count(health_counter_e counter)
+{
+  if (counters[counter] < 0xFFFF)
+    counters[counter]++;
+} //void Health_Module::count()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Starts the next row's tick window (counters keep counting)
+ */
+/**************************************************************************/
+void Health_Module::next_row()
+{
+  ticks = 0;
+  tick_sum_us = 0;
+  tick_worst_us = 0;
+  late_worst_ms = 0;
+} //void Health_Module::next_row()
+
+/**************************************************************************/
+ /*!
+ *    @return boots since the EEPROM was erased, this one included
+ */
+/**************************************************************************/
+uint32_t Health_Module::boots()
+{
+  return boot_count;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return MCUSR at boot (HEALTH_RESET_* bits)
+ */
+/**************************************************************************/
+uint8_t Health_Module::reset_cause()
+{
+  return mcusr;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return mean time of this row's ticks (us, 0 if none)
+ */
+/**************************************************************************/
+uint32_t Health_Module::tick_mean_us()
+{
+  return ticks ? tick_sum_us / ticks : 0;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return longest tick of this row (us)
+ */
+/**************************************************************************/
+uint32_t Health_Module::tick_max_us()
+{
+  return tick_worst_us;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return latest tick start of this row, after its slot (ms)
+ */
+/**************************************************************************/
+uint16_t Health_Module::jitter_ms()
+{
+  return late_worst_ms;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Least free stack since boot. AVR: the paint left untouched (one scan,
+ *            ~1 ms); elsewhere the lowest FreeStack() seen at the end of a tick
+ *    @return bytes
+ */
+/**************************************************************************/
+uint16_t Health_Module::stack_free()
+{
+  #if HAS_UNUSED_STACK
+    return UnusedStack();
+  #else
+    return stack_low;
+  #endif //HAS_UNUSED_STACK
+}
+
+/**************************************************************************/
+ /*!
+ *    @return errors of one kind since boot
+ */
+/**************************************************************************/
+uint16_t Health_Module::counter(health_counter_e counter)
+{
+  return counters[counter];
+}
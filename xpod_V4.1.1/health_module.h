@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * @file    health_module.h
+ * @brief   Pod health telemetry (HEALTH_ENABLED): boot count & reset cause,
+ *          scheduler tick time & jitter, free stack and error counters, logged
+ *          as extra columns of every row (row_schema.h XPOD_ROW_HEALTH).
+ *          Disabled, HEALTH_COUNT() compiles to a no-op statement
+ *
+ * @cite    MCUSR capture in .init3 from the avr-libc FAQ ("How do I detect a
+ *          watchdog reset?"); FillStack()/UnusedStack() from SdFat's FreeStack.h
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _HEALTH_MODULE_H
+#define _HEALTH_MODULE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "xpod_node.h"
+
+/****************** SET ADDR & CONST ********************/
+// Reset cause column: MCUSR bits at boot (0 = the bootloader cleared them)
+#define HEALTH_RESET_POWER_ON 0x01    //PORF
+#define HEALTH_RESET_EXTERNAL 0x02    //EXTRF - reset pin / upload
+#define HEALTH_RESET_BROWNOUT 0x04    //BORF
+#define HEALTH_RESET_WATCHDOG 0x08    //WDRF
+#define HEALTH_RESET_JTAG     0x10    //JTRF
+
+/****************** STRUCTS, OBJECTS ********************/
+// X(counter): one error counter, cumulative since boot (its column: row_schema.h XPOD_ROW_HEALTH)
+#define HEALTH_COUNTERS(X) \
+  X(I2C_ADS)        /*ADS1115 read that got a NACK*/                        \
+  X(I2C_CO2)        /*S300 request NACKed, short or bad frame*/             \
+  X(I2C_BME)        /*BME680 measurement not started / not read*/           \
+  X(I2C_QUAD)       /*MCP3424 conversion not started, or not read in 1 s*/  \
+  X(SENTINEL)       /*reading logged as its error value (65535/-999/-99)*/  \
+  X(PMS_TIMEOUT)    /*no PMS frame in SINGLE_RESPONSE_TIME (averaging: a row & TOTAL_RESPONSE_TIME)*/ \
+  X(SD_RETRY)       /*failed mount/open attempt*/                           \
+  X(SD_LOST)        /*row dropped: card out & SD_SPOOL_ENABLED queue full*/
+
+#define HEALTH_ENUM(counter)          HEALTH_##counter,
+/*! Index of each error counter */
+enum health_counter_e
+{
+  HEALTH_COUNTERS(HEALTH_ENUM)
+  HEALTH_COUNTER_COUNT
+}; //enum health_counter_e
+
+/****************** CLASSES ********************/
+/*! Boot-time facts, the current row's tick timing & the error counters */
+class Health_Module {
+  public:
+    Health_Module();
+    void begin();
+    void tick(uint32_t tick_us, uint16_t late_ms);
+    void count(health_counter_e counter);
+    void next_row();
+
+    uint32_t boots();
+    uint8_t reset_cause();
+    uint32_t tick_mean_us();
+    uint32_t tick_max_us();
+    uint16_t jitter_ms();
+    uint16_t stack_free();
+    uint16_t counter(health_counter_e counter);
+
+  private:
+    uint32_t boot_count;
+    uint8_t mcusr;
+    uint16_t ticks;               //this row's window
+    uint32_t tick_sum_us;
+    uint32_t tick_worst_us;
+    uint16_t late_worst_ms;
+    uint16_t stack_low;           //lowest FreeStack() seen (no stack painting)
+    uint16_t counters[HEALTH_COUNTER_COUNT];  //stop at 0xFFFF
+};
+
+#if HEALTH_ENABLED
+  extern Health_Module health;
+  #define HEALTH_COUNT(counter)       health.count(HEALTH_##counter)
+#else
+  #define HEALTH_COUNT(counter)       ((void)0)
+#endif //HEALTH_ENABLED
+
+#endif //_HEALTH_MODULE_H
@@ -0,0 +1,354 @@
+/*******************************************************************************
+ * @file    bench_pack.cpp
+ * @brief   Linux benchmark: how small a V4 CSV log gets as packed binary blocks
+ *          (SD_BINARY_PACKED_ENABLED). Reads the log back into records (dense or
+ *          change-based, SD_DEADBAND_ENABLED), packs them with the firmware's
+ *          Row_Pack, unpacks every block again and checks each record came back
+ *          bit for bit; then compares CSV, fixed-size binary & packed sizes
+ *
+ *          usage: bench_pack MPOD00_2026_10_17.CSV
+ *          (built with the pod's xpod_node.h: the labels have to match its columns)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "../record_module.h"
+
+/*! One stored column of the record, in schema (= pack) order */
+struct column_t
+{
+  const char *label;
+  uint8_t type;                   //XPOD_BIN_*
+  uint8_t scale;
+  uint8_t valid;
+  uint16_t offset;
+  int csv;                        //column in the log, -1 = not there
+  uint32_t bytes;                 //packed bytes of this column's deltas
+};
+
+#define BENCH_COLUMN(member, label, type, en, src, scale, valid) \
+  ROW_CAT(BENCH_COLUMN_, en)(member, label, type, scale, valid)
+#define BENCH_COLUMN_1(member, label, type, scale, valid) \
+  {label, XPOD_BIN_##type, scale, valid, offsetof(xpod_fields_t, member), -1, 0},
+#define BENCH_COLUMN_0(member, label, type, scale, valid)
+#define BENCH_COLUMN_STAT(...) ROW_STAT(BENCH_COLUMN, __VA_ARGS__)
+
+static column_t columns[] = { XPOD_LOG_SCHEMA(BENCH_COLUMN) };
+#define COLUMNS               (sizeof(columns) / sizeof(columns[0]))
+
+/****************** CSV ********************/
+// Cells of one line: the text between ','s (as xpod_expand)
+static void split(const std::string &line, std::vector<std::string> &cells)
+{
+  cells.clear();
+  size_t from = 0;
+  for (size_t at; (at = line.find(',', from)) != std::string::npos; from = at + 1)
+    cells.push_back(line.substr(from, at - from));
+  if (from < line.size())
+    cells.push_back(line.substr(from));
+} //static void split()
+
+// Up to the next '\n'; the erased tail of a preallocated file is not text
+static bool read_line(FILE *in, std::string &line, uint64_t &bytes)
+{
+  int c;
+  line.clear();
+  while ((c = fgetc(in)) != EOF)
+  {
+    if (c == 0xFF || c == 0x00)
+      continue;
+    bytes++;
+    if (c == '\n')
+      return true;
+    if (c != '\r')
+      line += (char)c;
+  }
+  return !line.empty();
+} //static bool read_line()
+
+// Decimal text with up to scale fraction digits -> value * 10^scale
+static int64_t parse_scaled(const char *text, uint8_t scale)
+{
+  bool neg = (*text == '-');
+  if (neg)
+    text++;
+  int64_t v = 0;
+  for (; *text >= '0' && *text <= '9'; text++)
+    v = v * 10 + (*text - '0');
+  if (*text == '.')
+    text++;
+  for (uint8_t i = 0; i < scale; i++)
+  {
+    v = v * 10;
+    if (*text >= '0' && *text <= '9')
+      v += *text++ - '0';
+  }
+  return neg ? -v : v;
+} //static int64_t parse_scaled()
+
+// One cell into its field (the inverse of Row_Text's formatting)
+static void parse_cell(const column_t &col, const std::string &cell, xpod_record_t *rec)
+{
+  uint8_t *at = rec->raw + col.offset;
+  switch (col.type)
+  {
+    case XPOD_BIN_TIME:  {
+      struct tm tm = {};
+      sscanf(cell.c_str(), "%d-%d-%dT%d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+             &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+      tm.tm_year -= 1900;
+      tm.tm_mon -= 1;
+      uint32_t t = (uint32_t)timegm(&tm);
+      memcpy(at, &t, 4);
+      break;
+    }
+    case XPOD_BIN_F32:  {
+      float f = strtof(cell.c_str(), NULL);
+      for (uint8_t i = 0; i < col.scale; i++)
+        f *= 10.0f;
+      memcpy(at, &f, 4);
+      break;
+    }
+    case XPOD_BIN_U8:   *at = (uint8_t)parse_scaled(cell.c_str(), col.scale); break;
+    case XPOD_BIN_U16:
+    case XPOD_BIN_I16:  {
+      uint16_t v = (uint16_t)parse_scaled(cell.c_str(), col.scale);
+      memcpy(at, &v, 2);
+      break;
+    }
+    case XPOD_BIN_U32:  {
+      uint32_t v = (uint32_t)parse_scaled(cell.c_str(), col.scale);
+      memcpy(at, &v, 4);
+      break;
+    }
+  } //switch (col.type)
+} //static void parse_cell()
+
+/****************** UNPACK ********************/
+static uint8_t width_of(uint8_t type)
+{
+  return (type == XPOD_BIN_U8) ? 1 : (type == XPOD_BIN_U16 || type == XPOD_BIN_I16) ? 2 : 4;
+} //static uint8_t width_of()
+
+// A field's bits as Row_Pack codes them (I16 sign extended)
+static uint32_t get_bits(uint8_t type, const uint8_t *at)
+{
+  if (type == XPOD_BIN_U8)
+    return *at;
+  if (type == XPOD_BIN_U16 || type == XPOD_BIN_I16)  {
+    uint16_t v;
+    memcpy(&v, at, 2);
+    return (type == XPOD_BIN_I16) ? (uint32_t)(int32_t)(int16_t)v : v;
+  } //if (16 bit)
+  uint32_t v;
+  memcpy(&v, at, 4);
+  return v;
+} //static uint32_t get_bits()
+
+static bool get_varint(const uint8_t *block, uint16_t &at, uint32_t &z)
+{
+  z = 0;
+  for (uint8_t shift = 0; at < XPOD_BIN_BLOCK_BYTES && shift < 35; shift += 7)
+  {
+    uint8_t b = block[at++];
+    z |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80))
+      return true;
+  }
+  return false;
+} //static bool get_varint()
+
+// Every row of a block, each coded against the one before (zeros before the first)
+static bool unpack_block(const uint8_t *block, std::vector<xpod_record_t> &out)
+{
+  if (block[0] != XPOD_BIN_BLOCK_SYNC)
+    return false;
+  xpod_record_t prev, rec;
+  memset(&prev, 0, sizeof(prev));
+  uint16_t at = XPOD_BIN_BLOCK_HEAD;
+  for (uint8_t r = 0; r < block[1]; r++)
+  {
+    rec = prev;
+    rec.f.sync = XPOD_BIN_SYNC;       //not coded: every record has it
+    uint32_t z;
+    if (!get_varint(block, at, z))
+      return false;
+    rec.f.status = (uint8_t)(prev.f.status + xpod_unzigzag(z));
+    for (size_t c = 0; c < COLUMNS; c++)
+    {
+      if (!get_varint(block, at, z))
+        return false;
+      uint32_t v = get_bits(columns[c].type, prev.raw + columns[c].offset) + xpod_unzigzag(z);
+      memcpy(rec.raw + columns[c].offset, &v, width_of(columns[c].type));
+    }
+    out.push_back(rec);
+    prev = rec;
+  }
+  return true;
+} //static bool unpack_block()
+
+// Bytes of one field's varint
+static uint8_t varint_bytes(uint32_t z)
+{
+  uint8_t n = 1;
+  while (z >>= 7)
+    n++;
+  return n;
+} //static uint8_t varint_bytes()
+
+/***************************************************************************************/
+int main(int argc, char **argv)
+{
+  if (argc < 2)  {
+    fprintf(stderr, "usage: %s LOG.CSV\n", argv[0]);
+    return 2;
+  } //if (argc < 2)
+  FILE *in = fopen(argv[1], "rb");
+  if (in == NULL)  {
+    perror(argv[1]);
+    return 1;
+  } //if (in == NULL)
+
+  // Header: which log column each stored field is
+  uint64_t csv_bytes = 0;
+  std::string line;
+  std::vector<std::string> cells, last;
+  if (!read_line(in, line, csv_bytes))  {
+    fprintf(stderr, "%s: empty\n", argv[1]);
+    return 1;
+  } //if (!read_line())
+  uint64_t label_bytes = csv_bytes;
+  split(line, cells);
+  for (size_t c = 0; c < COLUMNS; c++)
+  {
+    for (size_t i = 0; i < cells.size(); i++)
+      if (cells[i] == columns[c].label)
+        columns[c].csv = (int)i;
+    if (columns[c].csv < 0)  {
+      fprintf(stderr, "%s: no %s column (built for another xpod_node.h?)\n", argv[1], columns[c].label);
+      return 1;
+    } //if (columns[c].csv < 0)
+  }
+  last.assign(cells.size(), "");
+
+  // Rows -> records: "=" & missing trailing cells carry on, an empty cell clears its valid bits
+  std::vector<xpod_record_t> records;
+  std::vector<std::string> text;
+  uint64_t kept = csv_bytes;
+  while (read_line(in, line, csv_bytes))
+  {
+    if (line.empty() || line[line.size() - 1] != ',')  {
+      csv_bytes = kept;               //torn last row: not counted either
+      continue;
+    } //if (no trailing ',')
+    kept = csv_bytes;
+    split(line, cells);
+    for (size_t i = 0; i < last.size(); i++)
+      if (i < cells.size() && cells[i] != "=")
+        last[i] = cells[i];
+
+    xpod_record_t rec;
+    record_clear(&rec);
+    uint8_t valid = 0xFF, seen = 0;
+    for (size_t c = 0; c < COLUMNS; c++)
+    {
+      const std::string &cell = last[columns[c].csv];
+      if (cell.empty())
+        valid &= ~columns[c].valid;
+      else  {
+        seen |= columns[c].valid;
+        parse_cell(columns[c], cell, &rec);
+      } //if (cell.empty())
+    }
+    rec.f.status = valid & seen;
+    records.push_back(rec);
+  }
+  fclose(in);
+  if (records.empty())  {
+    fprintf(stderr, "%s: no rows\n", argv[1]);
+    return 1;
+  } //if (records.empty())
+
+  // Pack, counting each column's bytes (deltas within the block, as Row_Pack codes them)
+  static Row_Pack pack;
+  std::vector<std::vector<uint8_t> > blocks;
+  uint32_t status_bytes = 0;
+  const xpod_record_t *prev = NULL;
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < records.size(); r++)
+  {
+    if (!pack.add(&records[r]))  {
+      blocks.push_back(std::vector<uint8_t>(pack.block(), pack.block() + XPOD_BIN_BLOCK_BYTES));
+      pack.clear();
+      prev = NULL;
+      if (!pack.add(&records[r]))  {
+        fprintf(stderr, "row %zu doesn't fit an empty block\n", r + 1);
+        return 1;
+      } //if (!pack.add())
+    } //if (!pack.add())
+    xpod_record_t zero;
+    memset(&zero, 0, sizeof(zero));
+    const xpod_record_t *p = prev ? prev : &zero;
+    status_bytes += varint_bytes(xpod_zigzag(records[r].f.status - p->f.status));
+    for (size_t c = 0; c < COLUMNS; c++)
+      columns[c].bytes += varint_bytes(xpod_zigzag(get_bits(columns[c].type, records[r].raw + columns[c].offset) -
+                                                   get_bits(columns[c].type, p->raw + columns[c].offset)));
+    prev = &records[r];
+  }
+  if (pack.rows() > 0)
+    blocks.push_back(std::vector<uint8_t>(pack.block(), pack.block() + XPOD_BIN_BLOCK_BYTES));
+  double pack_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() /
+                   records.size();
+
+  // Unpack & compare
+  std::vector<xpod_record_t> back;
+  for (size_t b = 0; b < blocks.size(); b++)
+    if (!unpack_block(blocks[b].data(), back))  {
+      fprintf(stderr, "block %zu doesn't decode\n", b);
+      return 1;
+    } //if (!unpack_block())
+  size_t differ = 0;
+  for (size_t r = 0; r < records.size(); r++)
+    if (r >= back.size() || memcmp(&records[r].f, &back[r].f, sizeof(xpod_fields_t)) != 0)
+      differ++;
+  if (back.size() != records.size() || differ > 0)  {
+    fprintf(stderr, "round trip FAILED: %zu rows in, %zu out, %zu differ\n", records.size(), back.size(), differ);
+    return 1;
+  } //if (round trip failed)
+
+  // Dense CSV of the same records, as the pod writes it
+  static Row_Text row;
+  uint64_t dense_bytes = label_bytes - 2;       //its "\r\n" starts the first row
+  for (size_t r = 0; r < records.size(); r++)
+  {
+    record_format_csv(&records[r], row);
+    dense_bytes += row.length();
+  }
+
+  size_t n = records.size();
+  uint64_t fixed_bytes = (uint64_t)XPOD_HEADER_BYTES + (uint64_t)n * XPOD_RECORD_BYTES;
+  uint64_t packed_bytes = (uint64_t)XPOD_HEADER_BYTES + (uint64_t)blocks.size() * XPOD_BIN_BLOCK_BYTES;
+  printf("%zu rows round trip through %zu blocks (%.1f rows/block), %.0f ns/row to pack\n",
+         n, blocks.size(), (double)n / blocks.size(), pack_ns);
+  printf("%-13s %10s %8s %8s\n", "", "bytes", "B/row", "vs CSV");
+  printf("%-13s %10llu %8.1f %7.2fx\n", "CSV (file)", (unsigned long long)csv_bytes, (double)csv_bytes / n, 1.0);
+  printf("%-13s %10llu %8.1f %7.2fx\n", "CSV (dense)", (unsigned long long)dense_bytes, (double)dense_bytes / n,
+         (double)csv_bytes / dense_bytes);
+  printf("%-13s %10llu %8.1f %7.2fx\n", "binary", (unsigned long long)fixed_bytes, (double)fixed_bytes / n,
+         (double)csv_bytes / fixed_bytes);
+  printf("%-13s %10llu %8.1f %7.2fx\n", "packed", (unsigned long long)packed_bytes, (double)packed_bytes / n,
+         (double)csv_bytes / packed_bytes);
+
+  // Where the packed bytes go (raw = the field's size in a fixed record)
+  printf("\n%-13s %8s %8s\n", "column", "B/row", "raw");
+  printf("%-13s %8.2f %8d\n", "(status)", (double)status_bytes / n, 1);
+  for (size_t c = 0; c < COLUMNS; c++)
+    printf("%-13s %8.2f %8d\n", columns[c].label, (double)columns[c].bytes / n, width_of(columns[c].type));
+  return 0;
+} //int main()
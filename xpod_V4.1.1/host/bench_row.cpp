@@ -0,0 +1,236 @@
+/*******************************************************************************
+ * @file    bench_row.cpp
+ * @brief   Linux benchmark: CSV row via the old per-field Print::print() sequence
+ *          (once per sink, float division & printFloat) vs record_format_csv()
+ *          (integer formatting into one buffer, copied to each sink)
+ *
+ *          usage: bench_row [rows]     (default 200000)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "../record_module.h"
+
+#define SAMPLE_RECORDS        1024
+
+/*! Stand-in for the SD RingBuf / Serial: keeps the last row */
+class Sink : public Print {
+  public:
+    size_t write(uint8_t c)                       { text += (char)c; return 1; }
+    size_t write(const uint8_t *buf, size_t size) { text.append((const char *)buf, size); return size; }
+    using Print::write;
+    std::string text;
+};
+
+static xpod_record_t sample[SAMPLE_RECORDS];
+
+// Plausible values - the digit counts are what cost time
+static void fill_samples()
+{
+  uint32_t x = 12345;
+  for (int i = 0; i < SAMPLE_RECORDS; i++)
+  {
+    xpod_record_t *rec = &sample[i];
+    record_clear(rec);
+    rec->f.status = ROW_OK_LATEST;      //every module but the PMS (off in the default config) has data
+    #define NEXT(mod) ((x = x * 1103515245u + 12345u) >> 8) % (mod)
+    #if ROW_EN_RTC
+      rec->f.time = 1792238400u + i;    //2026-10-17T12:00:00 + i s
+    #endif
+    #if ROW_EN_VOLT
+      rec->f.in_volt = 11.5f + NEXT(200) / 100.0f;
+    #endif
+    #if ROW_EN_ADS
+      rec->f.Fig1 = NEXT(65536);
+      rec->f.Fig2 = NEXT(65536);
+      rec->f.Fig3 = NEXT(65536);
+      rec->f.Fig3_heater = NEXT(65536);
+      rec->f.Fig4 = NEXT(65536);
+      rec->f.Fig4_heater = NEXT(65536);
+      #if ROW_EN_MQ
+        rec->f.Mq = NEXT(65536);
+      #endif
+      #if ROW_EN_PID
+        rec->f.Pid = NEXT(65536);
+      #endif
+      rec->f.Misc2611 = NEXT(65536);
+      rec->f.Auxiliary = NEXT(65536) - 32768;
+      rec->f.Worker = NEXT(65536) - 32768;
+    #endif
+    #if ROW_EN_CO2
+      rec->f.CO2 = 400 + NEXT(600);
+    #endif
+    #if ROW_EN_BME
+      rec->f.T = -10.0f + NEXT(5000) / 100.0f;
+      rec->f.P = 80000 + NEXT(5000);
+      rec->f.RH = NEXT(10000) / 100.0f;
+      rec->f.GR = 5000 + NEXT(200000);
+    #endif
+    #if ROW_EN_QUAD
+      rec->f.QS1_C1 = NEXT(65536) - 32768;
+      rec->f.QS1_C2 = NEXT(65536) - 32768;
+      rec->f.QS2_C1 = NEXT(65536) - 32768;
+      rec->f.QS2_C2 = NEXT(65536) - 32768;
+      rec->f.QS3_C1 = NEXT(65536) - 32768;
+      rec->f.QS3_C2 = NEXT(65536) - 32768;
+      rec->f.QS4_C1 = NEXT(65536) - 32768;
+      rec->f.QS4_C2 = NEXT(65536) - 32768;
+    #endif
+    #undef NEXT
+  }
+} //static void fill_samples()
+
+// The V4.1.1 print_row_sd() sequence (default config), reading the same values
+static void legacy_print_row(Print &out, const xpod_record_t *rec)
+{
+  out.println();
+  #if ROW_EN_RTC
+    time_t t = rec->f.time;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    char bufftime[] = "YYYY-MM-DDThh:mm:ss";
+    sprintf(bufftime, "%04u-%02u-%02uT%02u:%02u:%02u", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+            tm.tm_hour, tm.tm_min, tm.tm_sec);
+    out.print(bufftime);
+  #endif
+  out.print(F(","));
+  #if ROW_EN_VOLT
+    out.print(rec->f.in_volt);
+  #endif
+  out.print(F(","));
+  #if ROW_EN_ADS
+    out.print(rec->f.Fig1);          out.print(F(","));
+    out.print(rec->f.Fig2);          out.print(F(","));
+    out.print(rec->f.Fig3);          out.print(F(","));
+    out.print(rec->f.Fig3_heater);   out.print(F(","));
+    out.print(rec->f.Fig4);          out.print(F(","));
+    out.print(rec->f.Fig4_heater);   out.print(F(","));
+    #if ROW_EN_MQ
+      out.print(rec->f.Mq);          out.print(F(","));
+    #endif
+    #if ROW_EN_PID
+      out.print(rec->f.Pid);
+    #endif
+    out.print(F(","));
+    out.print(rec->f.Misc2611);      out.print(F(","));
+    out.print(rec->f.Auxiliary);     out.print(F(","));
+    out.print(rec->f.Worker);        out.print(F(","));
+  #endif
+  #if ROW_EN_CO2
+    out.print(rec->f.CO2);           out.print(F(","));
+  #endif
+  #if ROW_EN_BME
+    out.print(rec->f.T);             out.print(F(","));
+    out.print(rec->f.P / 100.0);     out.print(F(","));
+    out.print(rec->f.RH);            out.print(F(","));
+    out.print(rec->f.GR / 1000.0);   out.print(F(","));
+  #endif
+  #if ROW_EN_QUAD
+    out.print(rec->f.QS1_C1);        out.print(F(","));
+    out.print(rec->f.QS1_C2);        out.print(F(","));
+    out.print(rec->f.QS2_C1);        out.print(F(","));
+    out.print(rec->f.QS2_C2);        out.print(F(","));
+    out.print(rec->f.QS3_C1);        out.print(F(","));
+    out.print(rec->f.QS3_C2);        out.print(F(","));
+    out.print(rec->f.QS4_C1);        out.print(F(","));
+    out.print(rec->f.QS4_C2);        out.print(F(","));
+  #endif
+  out.print(F(",,,,,,,,,,,,"));      //PMS off in the default config
+} //static void legacy_print_row()
+
+// Cells of a row: the text between ','s
+static std::vector<std::string> cells_of(const std::string &row)
+{
+  std::vector<std::string> cells;
+  size_t from = 0;
+  for (size_t at; (at = row.find(',', from)) != std::string::npos; from = at + 1)
+    cells.push_back(row.substr(from, at - from));
+  cells.push_back(row.substr(from));
+  return cells;
+} //static std::vector<std::string> cells_of()
+
+// Same cells? One may only be the old float path's 0.01 off (.xx5 rounding)
+static bool same_row(const std::string &old_row, const std::string &new_row, int &rounding)
+{
+  std::vector<std::string> a = cells_of(old_row), b = cells_of(new_row);
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); i++)
+  {
+    if (a[i] == b[i])
+      continue;
+    if (a[i].find('.') == std::string::npos || b[i].find('.') == std::string::npos ||
+        fabs(atof(a[i].c_str()) - atof(b[i].c_str())) > 0.0101)
+      return false;
+    rounding++;
+  }
+  return true;
+} //static bool same_row()
+
+static double ns_per_row(std::chrono::steady_clock::time_point t0, long rows)
+{
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / rows;
+} //static double ns_per_row()
+
+/***************************************************************************************/
+int main(int argc, char **argv)
+{
+  long rows = (argc > 1) ? atol(argv[1]) : 200000;
+  fill_samples();
+
+  Sink sd, serial;
+  static Row_Text row;
+
+  // Same text? (the old float path can be 0.01 off on exact .xx5 values)
+  int differ = 0, rounding = 0, wrong = 0;
+  for (int i = 0; i < SAMPLE_RECORDS; i++)
+  {
+    sd.text.clear();
+    legacy_print_row(sd, &sample[i]);
+    record_format_csv(&sample[i], row);
+    if (sd.text == row.c_str())
+      continue;
+    differ++;
+    if (!same_row(sd.text, row.c_str(), rounding) && wrong++ < 3)
+      printf("differs:\n  old %s\n  new %s\n", sd.text.c_str() + 2, row.c_str() + 2);
+  }
+  if (wrong > 0)  {
+    printf("%d/%d sample rows differ by more than .xx5 rounding\n", wrong, SAMPLE_RECORDS);
+    return 1;
+  } //if (wrong > 0)
+
+  // Old: whole print sequence once for SD, once for Serial
+  auto t0 = std::chrono::steady_clock::now();
+  for (long i = 0; i < rows; i++)
+  {
+    sd.text.clear();
+    serial.text.clear();
+    legacy_print_row(sd, &sample[i % SAMPLE_RECORDS]);
+    legacy_print_row(serial, &sample[i % SAMPLE_RECORDS]);
+  }
+  double old_ns = ns_per_row(t0, rows);
+
+  // New: format once, one write per sink
+  t0 = std::chrono::steady_clock::now();
+  for (long i = 0; i < rows; i++)
+  {
+    sd.text.clear();
+    serial.text.clear();
+    record_format_csv(&sample[i % SAMPLE_RECORDS], row);
+    sd.write(row.c_str(), row.length());
+    serial.write(row.c_str(), row.length());
+  }
+  double new_ns = ns_per_row(t0, rows);
+
+  printf("row: %u bytes, %d/%d sample rows differ in text (%d cells 0.01 off: .xx5 rounding)\n",
+         (unsigned)row.length(), differ, SAMPLE_RECORDS, rounding);
+  printf("print() x2 sinks : %8.0f ns/row\n", old_ns);
+  printf("format once      : %8.0f ns/row  (%.1fx)\n", new_ns, old_ns / new_ns);
+  return 0;
+} //int main()
@@ -0,0 +1,311 @@
+/*******************************************************************************
+ * @file    fuzz_pms.cpp
+ * @brief   Linux fuzz & benchmark of the PMS frame parser (../PMS.cpp): random
+ *          PMS5003/x003 frames, some corrupted, truncated or between noise, fed
+ *          through a fake UART in random chunks. After every poll() the parser
+ *          must have decoded what a whole-buffer reference scan finds in the bytes
+ *          received so far, newest in latest(). The reference is also checked
+ *          against the frames that went in: the 16 bit additive checksum lets about
+ *          1 in 65536 damaged frames through (counted, not a failure). At the end
+ *          of a round takeMean() must give the rounded mean of the round's frames
+ *
+ *          usage: fuzz_pms [rounds] [seed]     (default 2000 rounds of 200 frames)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "../PMS.h"
+
+#define FRAMES_PER_ROUND      200
+#define BENCH_FRAMES          200000
+#define UART_RX_BYTES         64      //AVR core's RX buffer: most a poll() can find
+
+unsigned long millis()                { return 0; }
+unsigned long micros()                { return 0; }
+
+static uint32_t rng = 1;
+static uint32_t next(uint32_t mod)
+{
+  rng = rng * 1103515245u + 12345u;
+  return (rng >> 8) % mod;
+}
+
+/*! The UART: the bytes of a round, made available "chunk" at a time */
+class Feed : public Stream {
+  public:
+    size_t write(uint8_t c)                       { (void)c; return 1; }
+    using Print::write;
+    int available()                               { return (int)(limit - pos); }
+    int read()                                    { return (pos < limit) ? bytes[pos++] : -1; }
+    int peek()                                    { return (pos < limit) ? bytes[pos] : -1; }
+
+    void arrive(size_t n)                         { limit = std::min(limit + n, bytes.size()); }
+    bool done()                                   { return pos == bytes.size(); }
+
+    std::vector<uint8_t> bytes;
+    size_t pos = 0;
+    size_t limit = 0;
+};
+
+/*! One frame that should come out of the parser, and where it ends in the feed */
+struct Expect
+{
+  size_t end;
+  PMS::DATA data;
+};
+
+// 0x42 0x4D, length, payload words, checksum; data gets what the parser should decode
+static void make_frame(std::vector<uint8_t> &out, PMS::DATA &data)
+{
+  bool particles = next(4) != 0;              //mostly PMS5003 (13 words), some x003 (9)
+  uint16_t words = particles ? 13 : 9;
+  uint16_t frame_len = 2 * words + 2;
+  uint16_t value[13];
+  for (int i = 0; i < words; i++)
+    value[i] = (next(8) == 0) ? (0x4200 | next(256)) : next(1000);  //0x42 inside now & then
+
+  std::vector<uint8_t> frame = {0x42, 0x4D, (uint8_t)(frame_len >> 8), (uint8_t)frame_len};
+  for (int i = 0; i < words; i++)
+  {
+    frame.push_back(value[i] >> 8);
+    frame.push_back(value[i] & 0xFF);
+  }
+  uint16_t sum = 0;
+  for (uint8_t b : frame)
+    sum += b;
+  frame.push_back(sum >> 8);
+  frame.push_back(sum & 0xFF);
+  out.insert(out.end(), frame.begin(), frame.end());
+
+  memset(&data, 0, sizeof(data));
+  data.pm10_standard = value[0];  data.pm25_standard = value[1];  data.pm100_standard = value[2];
+  data.pm10_env = value[3];       data.pm25_env = value[4];       data.pm100_env = value[5];
+  data.hasParticles = particles;
+  if (particles)  {
+    data.particles_03um = value[6];  data.particles_05um = value[7];  data.particles_10um = value[8];
+    data.particles_25um = value[9];  data.particles_50um = value[10]; data.particles_100um = value[11];
+  } //if (particles)
+}
+
+// The spec: at each byte, a whole frame with a good checksum is taken and skipped,
+// anything else moves on one byte
+static std::vector<Expect> reference(const std::vector<uint8_t> &b)
+{
+  std::vector<Expect> out;
+  size_t p = 0;
+  while (p + 4 <= b.size())
+  {
+    uint16_t frame_len = (b[p + 2] << 8) | b[p + 3];
+    if (b[p] == 0x42 && b[p + 1] == 0x4D && (frame_len == 20 || frame_len == 28) &&
+        p + 4 + frame_len <= b.size())  {
+      uint16_t sum = 0;
+      for (size_t i = p; i < p + 2 + frame_len; i++)
+        sum += b[i];
+      if (sum == ((b[p + 2 + frame_len] << 8) | b[p + 3 + frame_len]))  {
+        uint16_t value[13] = {};
+        for (int w = 0; w < frame_len / 2 - 1; w++)
+          value[w] = (b[p + 4 + 2 * w] << 8) | b[p + 5 + 2 * w];
+        Expect e = {p + 4 + frame_len, {}};
+        e.data.pm10_standard = value[0];  e.data.pm25_standard = value[1];  e.data.pm100_standard = value[2];
+        e.data.pm10_env = value[3];       e.data.pm25_env = value[4];       e.data.pm100_env = value[5];
+        e.data.hasParticles = (frame_len == 28);
+        e.data.particles_03um = value[6];  e.data.particles_05um = value[7];  e.data.particles_10um = value[8];
+        e.data.particles_25um = value[9];  e.data.particles_50um = value[10]; e.data.particles_100um = value[11];
+        out.push_back(e);
+        p = e.end;
+        continue;
+      } //if (checksum)
+    } //if (header)
+    p++;
+  }
+  return out;
+}
+
+static bool same(const PMS::DATA &a, const PMS::DATA &b)
+{
+  bool base = a.pm10_standard == b.pm10_standard && a.pm25_standard == b.pm25_standard &&
+              a.pm100_standard == b.pm100_standard && a.pm10_env == b.pm10_env &&
+              a.pm25_env == b.pm25_env && a.pm100_env == b.pm100_env && a.hasParticles == b.hasParticles;
+  if (!base || !a.hasParticles)
+    return base;
+  return a.particles_03um == b.particles_03um && a.particles_05um == b.particles_05um &&
+         a.particles_10um == b.particles_10um && a.particles_25um == b.particles_25um &&
+         a.particles_50um == b.particles_50um && a.particles_100um == b.particles_100um;
+}
+
+// Rounded mean of every frame (particle counts: of the PMS5003 frames)
+static PMS::DATA mean_of(const std::vector<Expect> &frames)
+{
+  uint64_t sum[12] = {};
+  uint32_t particle_frames = 0;
+  for (const Expect &e : frames)
+  {
+    const PMS::DATA &d = e.data;
+    uint16_t v[12] = {d.pm10_standard, d.pm25_standard, d.pm100_standard, d.pm10_env, d.pm25_env, d.pm100_env,
+                      d.particles_03um, d.particles_05um, d.particles_10um, d.particles_25um, d.particles_50um,
+                      d.particles_100um};
+    for (int i = 0; i < (d.hasParticles ? 12 : 6); i++)
+      sum[i] += v[i];
+    particle_frames += d.hasParticles;
+  }
+  uint16_t m[12];
+  for (int i = 0; i < 12; i++)
+  {
+    uint32_t n = (i < 6) ? frames.size() : particle_frames;
+    m[i] = n ? (sum[i] + n / 2) / n : 0;
+  }
+  PMS::DATA data = {m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11], particle_frames > 0};
+  return data;
+}
+
+/*! Counts of what went into the feeds */
+struct Mix
+{
+  uint32_t intact, corrupted, truncated, noise;
+  uint32_t collisions;                        //damaged frames the checksum let through
+};
+
+// One round: build the feed, push it through in random chunks, check after every poll()
+static bool round_ok(Mix &mix, uint32_t &checksum_errors)
+{
+  Feed feed;
+  std::vector<Expect> intact;
+  for (int f = 0; f < FRAMES_PER_ROUND; f++)
+  {
+    uint32_t kind = next(10);
+    if (kind == 0)  {                          //noise before the frame
+      for (uint32_t n = 1 + next(40); n; n--)
+        feed.bytes.push_back((next(4) == 0) ? 0x42 : next(256));
+      mix.noise++;
+    } //if (kind == 0)
+
+    PMS::DATA data;
+    size_t begin = feed.bytes.size();
+    make_frame(feed.bytes, data);
+    if (kind == 1)  {                          //one byte flipped (header, length, payload or checksum)
+      size_t at = begin + next(feed.bytes.size() - begin);
+      feed.bytes[at] ^= 1 << next(8);
+      mix.corrupted++;
+    } else if (kind == 2)  {                   //cut short - the next frame follows right away
+      feed.bytes.resize(begin + 1 + next(feed.bytes.size() - begin - 1));
+      mix.truncated++;
+    } else {
+      intact.push_back({feed.bytes.size(), data});
+      mix.intact++;
+    } //if (kind)
+  }
+  // Ends on a good PMS5003 frame: whatever the parser still holds back gets settled
+  PMS::DATA data;
+  do {
+    size_t begin = feed.bytes.size();
+    make_frame(feed.bytes, data);
+    if (data.hasParticles)
+      break;
+    feed.bytes.resize(begin);
+  } while (true);
+  intact.push_back({feed.bytes.size(), data});
+  mix.intact++;
+
+  std::vector<Expect> expect = reference(feed.bytes);
+  size_t matched = 0;
+  for (size_t i = 0, j = 0; i < expect.size(); i++)
+  {
+    while (j < intact.size() && intact[j].end < expect[i].end)
+      j++;
+    if (j < intact.size() && intact[j].end == expect[i].end && same(intact[j].data, expect[i].data))
+      matched++;
+  }
+  mix.collisions += expect.size() - matched;
+
+  PMS pms(feed);
+  while (!feed.done())
+  {
+    feed.arrive(1 + next(UART_RX_BYTES));
+    pms.poll();
+    if (feed.available())  {
+      fprintf(stderr, "poll() left %d bytes in the UART\n", feed.available());
+      return false;
+    } //if (feed.available())
+
+    // A bad frame's "header" can hold a good one back until its claimed length is in
+    // (< one frame later), so: every frame that ended a frame ago, none still to come
+    size_t settled = 0, got = 0;
+    while (got < expect.size() && expect[got].end <= feed.pos)
+    {
+      if (expect[got].end + 4 + 2 * 13 + 2 <= feed.pos)
+        settled++;
+      got++;
+    }
+    uint16_t n = pms.frames();
+    if (n < settled || n > got || (n && !same(pms.latest(), expect[n - 1].data)))  {
+      fprintf(stderr, "at byte %zu: %u frames decoded, %zu-%zu expected%s\n", feed.pos, n, settled, got,
+              (n >= settled && n <= got) ? " (latest differs)" : "");
+      return false;
+    } //if (mismatch)
+  }
+  if (pms.frames() != expect.size())  {
+    fprintf(stderr, "end of round: %u frames decoded, %zu expected\n", pms.frames(), expect.size());
+    return false;
+  } //if (pms.frames() != expect.size())
+  PMS::DATA mean = {};
+  if (pms.takeMean(mean) != expect.size() || !same(mean, mean_of(expect)))  {
+    fprintf(stderr, "end of round: takeMean() differs from the mean of %zu frames\n", expect.size());
+    return false;
+  } //if (mean differs)
+  checksum_errors += pms.checksumErrors();
+  return true;
+}
+
+// Clean frames in whole-UART-buffer chunks (active mode with the buffer full) and byte by byte
+static void bench(size_t chunk)
+{
+  Feed feed;
+  PMS::DATA data;
+  for (int f = 0; f < 1000; f++)
+    make_frame(feed.bytes, data);
+
+  size_t frames = 0, bytes = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  while (frames < BENCH_FRAMES)
+  {
+    PMS pms(feed);
+    feed.pos = feed.limit = 0;
+    while (!feed.done())
+    {
+      feed.arrive(chunk);
+      pms.poll();
+    }
+    frames += pms.frames();
+    bytes += feed.bytes.size();
+  }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  printf("bench: %2zu byte chunks: %.1f ns/byte, %.0f ns/frame\n", chunk, s * 1e9 / bytes, s * 1e9 / frames);
+}
+
+/***************************************************************************************/
+int main(int argc, char **argv)
+{
+  int rounds = (argc > 1) ? atoi(argv[1]) : 2000;
+  rng = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+
+  Mix mix = {};
+  uint32_t checksum_errors = 0;
+  for (int r = 0; r < rounds; r++)
+  {
+    if (!round_ok(mix, checksum_errors))  {
+      fprintf(stderr, "fuzz: FAILED in round %d\n", r);
+      return 1;
+    } //if (!round_ok(...))
+  }
+  printf("fuzz: %d rounds OK - %u intact, %u corrupted, %u truncated frames, %u noise bursts; "
+         "%u checksum drops, %u checksum collisions\n", rounds, mix.intact, mix.corrupted, mix.truncated,
+         mix.noise, checksum_errors, mix.collisions);
+
+  bench(UART_RX_BYTES);
+  bench(1);
+  return 0;
+}
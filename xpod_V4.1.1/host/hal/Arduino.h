@@ -0,0 +1,221 @@
+/*******************************************************************************
+ * @file    Arduino.h
+ * @brief   Just enough of the Arduino (AVR) core to build the whole sketch on
+ *          Linux (host tools, benchmarks & xpod_sim). Print follows the AVR core's
+ *          Print.cpp so text comes out byte for byte the same; time, pins & the
+ *          UARTs are simulated in hal.cpp against a virtual clock
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "avr/io.h"
+
+/****************** CORE TYPES & CONST ********************/
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH                  1
+#define LOW                   0
+#define INPUT                 0
+#define OUTPUT                1
+#define INPUT_PULLUP          2
+#define CHANGE                1
+#define FALLING               2
+#define RISING                3
+#define A0                    54
+#define LSBFIRST              0
+#define MSBFIRST              1
+#define NOT_AN_INTERRUPT      -1
+
+// Mega 2560 external interrupt pins
+#define digitalPinToInterrupt(p) \
+  ((p) == 2 ? 0 : (p) == 3 ? 1 : (p) == 21 ? 2 : (p) == 20 ? 3 : (p) == 19 ? 4 : (p) == 18 ? 5 : NOT_AN_INTERRUPT)
+
+#define makeWord(h, l)        ((uint16_t)(((h) << 8) | (l)))
+#define highByte(w)           ((uint8_t)((w) >> 8))
+#define lowByte(w)            ((uint8_t)((w) & 0xFF))
+#define bitRead(v, b)         (((v) >> (b)) & 1)
+#define constrain(a, l, h)    ((a) < (l) ? (l) : ((a) > (h) ? (h) : (a)))
+using std::min;
+using std::max;
+
+/****************** FLASH (no PROGMEM on Linux) ********************/
+class __FlashStringHelper;
+#define F(s)                  (reinterpret_cast<const __FlashStringHelper *>(s))
+#define PSTR(s)               (s)
+#define PROGMEM
+#define strlen_P              strlen
+#define memcpy_P              memcpy
+#define pgm_read_byte(p)      (*(const uint8_t *)(p))
+#define pgm_read_word(p)      (*(const uint16_t *)(p))
+
+#define DEC                   10
+#define HEX                   16
+
+/****************** TIME, PINS (hal.cpp) ********************/
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void attachInterrupt(uint8_t irq, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t irq);
+void noInterrupts();
+void interrupts();
+
+/****************** CLASSES ********************/
+/*! Arduino Print (AVR core): number & float formatting done the same way */
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size)
+    {
+      size_t n = 0;
+      while (size--)
+        n += write(*buf++);
+      return n;
+    }
+    size_t write(const char *str)                 { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+    size_t write(const char *buf, size_t size)    { return write((const uint8_t *)buf, size); }
+    virtual int availableForWrite()               { return 0; }
+    virtual void flush()                          {}
+    int getWriteError()                           { return write_error; }
+    void clearWriteError()                        { write_error = 0; }
+
+    size_t print(const __FlashStringHelper *s)    { return write((const char *)s); }
+    size_t print(const char *s)                   { return write(s); }
+    size_t print(char c)                          { return write((uint8_t)c); }
+    size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(int n, int base = DEC)           { return print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC)  { return print((unsigned long)n, base); }
+    size_t print(long n, int base = DEC)
+    {
+      if (base == DEC && n < 0)
+        return print('-') + printNumber(-(unsigned long)n, base);
+      return printNumber(n, base);
+    }
+    size_t print(unsigned long n, int base = DEC) { return printNumber(n, base); }
+    size_t print(double n, int digits = 2)        { return printFloat(n, digits); }
+
+    size_t println()                              { return write("\r\n"); }
+    template <typename T> size_t println(T v)     { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(T v, int b)  { size_t n = print(v, b); return n + println(); }
+
+  protected:
+    void setWriteError(int err = 1)               { write_error = err; }
+
+  private:
+    size_t printNumber(unsigned long n, uint8_t base)
+    {
+      char buf[8 * sizeof(long) + 1];
+      char *str = &buf[sizeof(buf) - 1];
+      *str = '\0';
+      if (base < 2)
+        base = 10;
+      do {
+        unsigned long m = n;
+        n /= base;
+        char c = m - base * n;
+        *--str = c < 10 ? c + '0' : c + 'A' - 10;
+      } while (n);
+      return write(str);
+    }
+
+    size_t printFloat(double number, uint8_t digits)
+    {
+      size_t n = 0;
+      if (isnan(number)) return print("nan");
+      if (isinf(number)) return print("inf");
+      if (number > 4294967040.0) return print("ovf");
+      if (number < -4294967040.0) return print("ovf");
+      if (number < 0.0)  {
+        n += print('-');
+        number = -number;
+      }
+      double rounding = 0.5;
+      for (uint8_t i = 0; i < digits; ++i)
+        rounding /= 10.0;
+      number += rounding;
+
+      unsigned long int_part = (unsigned long)number;
+      double remainder = number - (double)int_part;
+      n += print(int_part);
+      if (digits > 0)
+        n += print('.');
+      while (digits-- > 0)
+      {
+        remainder *= 10.0;
+        unsigned int to_print = (unsigned int)remainder;
+        n += print(to_print);
+        remainder -= to_print;
+      }
+      return n;
+    }
+
+    int write_error = 0;
+};
+
+/*! Arduino Stream: only what the libraries use */
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    size_t readBytes(uint8_t *buf, size_t size)
+    {
+      size_t n = 0;
+      while (n < size && available())
+        buf[n++] = read();
+      return n;
+    }
+};
+
+/*! Placeholder - the sketch never builds Strings, some library headers name it */
+class String {
+  public:
+    String(const char *s = "")                    { (void)s; }
+};
+
+#define SERIAL_TX_BUFFER_SIZE 64    //HardwareSerial.h (Mega)
+
+/*! UART at its baud rate on the virtual clock (hal.cpp): 64 byte TX buffer, write()
+ *  blocks while it is full like the AVR core. Serial output goes to stdout */
+class HardwareSerial : public Stream {
+  public:
+    HardwareSerial(uint8_t port) : port(port) {}
+    void begin(unsigned long baud);
+    void end()                                    {}
+    operator bool()                               { return true; }
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    using Print::write;
+    int availableForWrite() override;
+    void flush() override;
+
+    const uint8_t port;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+#endif //_HOST_ARDUINO_H
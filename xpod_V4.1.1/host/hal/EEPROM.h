@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * @file    EEPROM.h
+ * @brief   Arduino EEPROM library for xpod_sim: the Mega's 4 KB, erased (0xFF) at
+ *          start or loaded from / saved to a file (xpod_sim -e), so counters
+ *          survive a "reboot". A byte write takes HOST_EEPROM_WRITE_US and the
+ *          next access waits for it, like eeprom_write_byte() polling EEPE
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _HOST_EEPROM_H
+#define _HOST_EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define HOST_EEPROM_BYTES     4096    //ATmega2560
+
+class EEPROMClass {
+  public:
+    uint8_t read(int idx);
+    void write(int idx, uint8_t val);
+    void update(int idx, uint8_t val)             { if (read(idx) != val) write(idx, val); }
+    uint16_t length()                             { return HOST_EEPROM_BYTES; }
+
+    template <typename T> T &get(int idx, T &t)
+    {
+      uint8_t *p = (uint8_t *)&t;
+      for (size_t i = 0; i < sizeof(T); i++)
+        p[i] = read(idx + i);
+      return t;
+    }
+    template <typename T> const T &put(int idx, const T &t)
+    {
+      const uint8_t *p = (const uint8_t *)&t;
+      for (size_t i = 0; i < sizeof(T); i++)
+        update(idx + i, p[i]);
+      return t;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif //_HOST_EEPROM_H
@@ -0,0 +1,13 @@
+// SdFat's FreeStack() for xpod_sim: no stack painting (HAS_UNUSED_STACK 0). FreeStack() is
+// HOST_STACK_BYTES less how far the host stack has grown since main() - a depth trend only,
+// x86-64 frames are several times the size of the Mega's
+#ifndef _HOST_FREESTACK_H
+#define _HOST_FREESTACK_H
+
+#define HAS_UNUSED_STACK      0
+
+int FreeStack();
+inline void FillStack()                           {}
+inline int UnusedStack()                          { return 0; }
+
+#endif //_HOST_FREESTACK_H
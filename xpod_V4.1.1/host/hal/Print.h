@@ -0,0 +1,2 @@
+// Arduino core layout: Print lives in Arduino.h here
+#include "Arduino.h"
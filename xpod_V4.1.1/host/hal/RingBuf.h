@@ -0,0 +1,2 @@
+// The real SdFat RingBuf, writing into the simulated File (SdFat.h here)
+#include "../../../libraries/SdFat/src/RingBuf.h"
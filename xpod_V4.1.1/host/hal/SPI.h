@@ -0,0 +1,39 @@
+/*******************************************************************************
+ * @file    SPI.h
+ * @brief   SPI for xpod_sim: transfers go to the Host_SPI_Device whose chip
+ *          select pin is LOW (host_spi_attach()); the SD card is simulated at
+ *          the SdFat level instead
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _HOST_SPI_H
+#define _HOST_SPI_H
+
+#include "Arduino.h"
+
+#define SPI_MODE0             0
+#define SPI_MODE1             1
+#define SPI_MODE2             2
+#define SPI_MODE3             3
+
+typedef uint8_t BitOrder;
+
+class SPISettings {
+  public:
+    SPISettings(uint32_t clock = 0, uint8_t order = 0, uint8_t mode = 0) { (void)clock; (void)order; (void)mode; }
+};
+
+class SPIClass {
+  public:
+    void begin()                                  {}
+    void end()                                    {}
+    void beginTransaction(SPISettings settings)   { (void)settings; }
+    void endTransaction()                         {}
+    uint8_t transfer(uint8_t data);
+    void transfer(void *buf, size_t count);
+};
+
+extern SPIClass SPI;
+
+#endif //_HOST_SPI_H
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * @file    SdFat.h
+ * @brief   SdFat for xpod_sim: the card's files are held in RAM (every File of
+ *          a name shares them) and saved to host_sd_dir()/<name> on sync()/close(),
+ *          so logs can be checked after a run. Only the calls the sketch uses;
+ *          card time per host_hal.h (creating a file, preallocating/freeing
+ *          clusters & erase included). While the card is out (xpod_sim -c) every
+ *          call fails, and a File opened before it went stays failed
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _HOST_SDFAT_H
+#define _HOST_SDFAT_H
+
+#include <fcntl.h>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+
+#ifndef O_WRITE
+  #define O_WRITE             O_WRONLY
+#endif //O_WRITE
+
+/*! The card: erase() of a preallocated extent always works (HOST_SD_ERASE_US) */
+class SdCard {
+  public:
+    bool erase(uint32_t first_sector, uint32_t last_sector);
+};
+
+class File : public Stream {
+  public:
+    File() : open_flag(false), pos(0), card(0), data(NULL) {}
+    bool open(const char *name, int flags);
+    bool close();
+    bool remove();
+    bool isOpen()                                 { return open_flag; }
+    bool sync();
+    bool isBusy()                                 { return false; }
+
+    bool preAllocate(uint32_t length);
+    bool contiguousRange(uint32_t *first_sector, uint32_t *last_sector);
+    bool seekSet(uint32_t position);
+    uint32_t curPosition()                        { return pos; }
+    uint32_t fileSize()                           { return data->size(); }
+    bool truncate(uint32_t length);
+    bool truncate()                               { return truncate(pos); }
+
+    size_t write(uint8_t c) override              { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override;
+    size_t write(const void *buf, size_t size)    { return write((const uint8_t *)buf, size); }
+    using Print::write;
+    int available() override                      { return data->size() - pos; }
+    int read() override                           { return (pos < data->size()) ? (*data)[pos++] : -1; }
+    int read(void *buf, size_t count);
+    int peek() override                           { return (pos < data->size()) ? (*data)[pos] : -1; }
+
+  private:
+    bool usable();
+
+    bool open_flag;
+    uint32_t pos;
+    uint32_t card;                //insertion it was opened on (a removal breaks it)
+    std::string path;
+    std::vector<uint8_t> *data;   //the file on the card
+};
+
+class SdFat {
+  public:
+    bool begin(uint8_t cs_pin);
+    SdCard *card()                                { return &sd_card; }
+
+  private:
+    SdCard sd_card;
+};
+
+#endif //_HOST_SDFAT_H
@@ -0,0 +1,2 @@
+// Arduino core layout: Stream lives in Arduino.h here
+#include "Arduino.h"
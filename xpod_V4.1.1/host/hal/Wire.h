@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * @file    Wire.h
+ * @brief   TwoWire for xpod_sim: transactions go to the Host_I2C_Device attached
+ *          at the address (absent = NACK) and take their bus time at setClock().
+ *          A stuck bus hangs like the AVR twi driver, unless setWireTimeout()
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _HOST_WIRE_H
+#define _HOST_WIRE_H
+
+#include "Arduino.h"
+
+#define WIRE_BUFFER_LENGTH    32    //AVR Wire's buffer
+
+class TwoWire : public Stream {
+  public:
+    TwoWire();
+    void begin()                                  {}
+    void end()                                    {}
+    void setClock(uint32_t hz)                    { clock_hz = hz; }
+    void setWireTimeout(uint32_t timeout = 25000, bool reset_with_timeout = false);
+    bool getWireTimeoutFlag()                     { return timeout_flag; }
+    void clearWireTimeoutFlag()                   { timeout_flag = false; }
+
+    void beginTransmission(uint8_t addr);
+    void beginTransmission(int addr)              { beginTransmission((uint8_t)addr); }
+    uint8_t endTransmission(bool stop = true);
+    uint8_t requestFrom(uint8_t addr, uint8_t count, uint8_t stop = 1);
+    uint8_t requestFrom(int addr, int count)      { return requestFrom((uint8_t)addr, (uint8_t)count); }
+    uint8_t requestFrom(int addr, int count, int stop)  { return requestFrom((uint8_t)addr, (uint8_t)count, (uint8_t)stop); }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    using Print::write;
+    int available() override                      { return rx_len - rx_pos; }
+    int read() override                           { return (rx_pos < rx_len) ? rx[rx_pos++] : -1; }
+    int peek() override                           { return (rx_pos < rx_len) ? rx[rx_pos] : -1; }
+
+  private:
+    void bus_time(uint16_t bytes);
+    bool bus_free();
+    bool deliver(uint8_t addr, const uint8_t *buf, uint8_t count);
+
+    uint32_t clock_hz;
+    uint32_t timeout_us;          //0 = wait forever (AVR default)
+    bool timeout_flag;
+    uint8_t tx_addr;
+    uint8_t tx[WIRE_BUFFER_LENGTH];
+    uint8_t tx_len;
+    uint8_t rx[WIRE_BUFFER_LENGTH];
+    uint8_t rx_len;
+    uint8_t rx_pos;
+};
+
+extern TwoWire Wire;
+
+#endif //_HOST_WIRE_H
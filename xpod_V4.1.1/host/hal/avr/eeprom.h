@@ -0,0 +1,9 @@
+// eeprom_is_ready() from avr-libc: false while an EEPROM byte write is in progress
+#ifndef _HOST_AVR_EEPROM_H
+#define _HOST_AVR_EEPROM_H
+
+bool host_eeprom_ready();
+
+inline bool eeprom_is_ready()           { return host_eeprom_ready(); }
+
+#endif //_HOST_AVR_EEPROM_H
@@ -0,0 +1,16 @@
+// MCU status register for xpod_sim: the reset cause the firmware sees at boot
+// (power-on unless xpod_sim -r says otherwise); the rest of the AVR I/O space isn't modelled
+#ifndef _HOST_AVR_IO_H
+#define _HOST_AVR_IO_H
+
+#include <stdint.h>
+
+#define PORF                  0
+#define EXTRF                 1
+#define BORF                  2
+#define WDRF                  3
+#define JTRF                  4
+
+extern uint8_t MCUSR;
+
+#endif //_HOST_AVR_IO_H
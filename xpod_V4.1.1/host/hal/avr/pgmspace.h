@@ -0,0 +1,2 @@
+// No separate flash on Linux: PROGMEM helpers are in Arduino.h
+#include "../Arduino.h"
@@ -0,0 +1,23 @@
+// avr/sleep.h from avr-libc: sleep_cpu() moves the virtual clock on to the wake-up (hal.cpp)
+#ifndef _HOST_AVR_SLEEP_H
+#define _HOST_AVR_SLEEP_H
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE       0
+#define SLEEP_MODE_ADC        1
+#define SLEEP_MODE_PWR_DOWN   2
+#define SLEEP_MODE_PWR_SAVE   3
+#define SLEEP_MODE_STANDBY    6
+
+void host_set_sleep_mode(uint8_t mode);
+void host_sleep_enable(bool on);
+void host_sleep_cpu();
+
+inline void set_sleep_mode(uint8_t mode) { host_set_sleep_mode(mode); }
+inline void sleep_enable()               { host_sleep_enable(true); }
+inline void sleep_disable()              { host_sleep_enable(false); }
+inline void sleep_cpu()                  { host_sleep_cpu(); }
+inline void sleep_mode()                 { sleep_enable(); sleep_cpu(); sleep_disable(); }
+
+#endif //_HOST_AVR_SLEEP_H
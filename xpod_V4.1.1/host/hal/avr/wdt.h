@@ -0,0 +1,21 @@
+// Watchdog: the simulation stops when loop() goes longer than the timeout without wdt_reset()
+#ifndef _HOST_AVR_WDT_H
+#define _HOST_AVR_WDT_H
+
+#include <stdint.h>
+
+#define WDTO_15MS             0
+#define WDTO_1S               6
+#define WDTO_2S               7
+#define WDTO_4S               8
+#define WDTO_8S               9
+
+void host_wdt_enable(uint8_t timeout);
+void host_wdt_reset();
+void host_wdt_disable();
+
+inline void wdt_enable(uint8_t timeout) { host_wdt_enable(timeout); }
+inline void wdt_reset()                 { host_wdt_reset(); }
+inline void wdt_disable()               { host_wdt_disable(); }
+
+#endif //_HOST_AVR_WDT_H
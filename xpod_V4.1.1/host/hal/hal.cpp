@@ -0,0 +1,908 @@
+/*******************************************************************************
+ * @file    hal.cpp
+ * @brief   Host HAL for xpod_sim: virtual clock, pins, interrupts, sleep, UARTs, watchdog, MCUSR,
+ *          stack, EEPROM, I2C bus & the in-RAM SD card (see host_hal.h for the costs charged to the clock;
+ *          the devices on the bus are in host_devices.cpp)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "SPI.h"
+#include "SdFat.h"
+#include "avr/wdt.h"
+#include "avr/sleep.h"
+#include "EEPROM.h"
+#include "FreeStack.h"
+#include "host_hal.h"
+
+/****************** CLOCK ********************/
+static uint64_t now_us;
+static int32_t clock_ppm;         //the MCU's crystal vs true (RTC) time
+static uint64_t stopped_us;       //powered down: timer0 stood still
+static host_stats_t stats;
+static void irq_update();
+
+volatile unsigned long timer0_millis;   //wiring.c's: millis() counts here, a sketch may move it
+static uint64_t timer0_us;              //MCU time counted into it so far
+
+uint64_t host_now_us()                { return now_us; }
+void host_advance_us(uint64_t us)     { now_us += us; }
+host_stats_t &host_stats()            { return stats; }
+void host_clock_ppm(int32_t ppm)      { clock_ppm = ppm; }
+
+// What timer0 has counted: true time it ran, off by clock_ppm
+static uint64_t mcu_us()
+{
+  uint64_t run_us = now_us - stopped_us;
+  return run_us + (int64_t)run_us * clock_ppm / 1000000;
+}
+
+unsigned long millis()
+{
+  now_us += HOST_CLOCK_READ_US;
+  irq_update();
+  uint64_t t = mcu_us();
+  timer0_millis += (unsigned long)(t / 1000 - timer0_us / 1000);
+  timer0_us = t;
+  return (uint32_t)timer0_millis;
+}
+
+unsigned long micros()
+{
+  now_us += HOST_CLOCK_READ_US;
+  irq_update();
+  return mcu_us();
+}
+
+void delay(unsigned long ms)
+{
+  now_us += (uint64_t)ms * 1000 - (int64_t)ms * clock_ppm / 1000;
+  irq_update();
+}
+void delayMicroseconds(unsigned int us) { now_us += us; }
+void yield()                            {}
+
+/****************** PINS ********************/
+#define HOST_PINS             70
+
+static uint8_t pin_level[HOST_PINS];
+static Host_SPI_Device *spi_device[HOST_PINS];   //by chip select pin
+
+void pinMode(uint8_t pin, uint8_t mode)     { (void)pin; (void)mode; }
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  if (pin >= sizeof(pin_level))
+    return;
+  pin_level[pin] = val;
+  if (spi_device[pin])
+    spi_device[pin]->select(val == LOW);
+}
+
+/****************** INTERRUPTS ********************/
+#define HOST_IRQS             6     //digitalPinToInterrupt(): 0/1 = INT4/5 (pins 2, 3), 2-5 = INT0-3
+#define HOST_WAVES            6     //DS3231 SQW + the ADS1115s' ALERT/RDY
+
+static void (*irq_isr[HOST_IRQS])(void);
+static int irq_mode[HOST_IRQS];
+static uint8_t irq_pending;       //LOW attached while the line was low
+static bool irq_enabled = true;
+static bool in_isr;
+
+/*! A pin driven low for low_us once every period, falling in step with
+ *  first_fall_us: the DS3231's SQW (half the period, on whole periods of the
+ *  virtual clock) or an ADS1115's ALERT/RDY (a short pulse as each conversion ends) */
+struct host_wave_t
+{
+  uint8_t pin;
+  uint32_t period_us;       //0 = not driven
+  uint32_t low_us;
+  uint64_t first_fall_us;
+  uint64_t next_fall_us;
+};
+static host_wave_t wave[HOST_WAVES];
+
+void host_pin_wave(uint8_t pin, uint32_t period_us)
+{
+  uint64_t first_us = (period_us != 0) ? (now_us / period_us + 1) * period_us : 0;
+  host_pin_pulse(pin, period_us, period_us / 2, first_us);
+}
+
+void host_pin_pulse(uint8_t pin, uint32_t period_us, uint32_t low_us, uint64_t first_fall_us)
+{
+  host_wave_t *w = NULL;
+  for (uint8_t i = 0; i < HOST_WAVES && w == NULL; i++)
+  {
+    if (wave[i].period_us != 0 && wave[i].pin == pin)
+      w = &wave[i];
+  }
+  for (uint8_t i = 0; i < HOST_WAVES && w == NULL; i++)
+  {
+    if (wave[i].period_us == 0)
+      w = &wave[i];
+  }
+  if (w == NULL)
+    return;
+  w->pin = pin;
+  w->period_us = period_us;
+  w->low_us = low_us;
+  w->first_fall_us = first_fall_us;
+  w->next_fall_us = first_fall_us;
+}
+
+static void run_isr(int8_t irq, uint64_t at_us)
+{
+  if (irq < 0 || irq_isr[irq] == NULL)
+    return;
+  uint64_t was_us = now_us;
+  now_us = at_us;
+  in_isr = true;
+  irq_isr[irq]();
+  in_isr = false;
+  now_us = was_us + (now_us - at_us);
+}
+
+// Falling edges passed since the last clock read: each ISR runs as of its edge
+// (AVR latency is a few us), then the clock goes on from where it was
+static void irq_update()
+{
+  if (in_isr || !irq_enabled)
+    return;
+  for (int8_t irq = 0; irq_pending != 0 && irq < HOST_IRQS; irq++)
+  {
+    if (irq_pending & (1 << irq))  {
+      irq_pending &= ~(1 << irq);
+      run_isr(irq, now_us);
+    } //if (pending)
+  }
+  for (uint8_t i = 0; i < HOST_WAVES; i++)
+  {
+    host_wave_t *w = &wave[i];
+    while (w->period_us != 0 && w->next_fall_us <= now_us)
+    {
+      uint64_t fall_us = w->next_fall_us;
+      w->next_fall_us += w->period_us;
+      run_isr(digitalPinToInterrupt(w->pin), fall_us);
+    }
+  }
+}
+
+// Next falling edge that will run an ISR (and can wake a powered-down MCU: a LOW
+// level, or an edge on the asynchronous INT0-3), UINT64_MAX if none
+static uint64_t irq_next_us(bool powered_down)
+{
+  uint64_t next = UINT64_MAX;
+  for (uint8_t i = 0; i < HOST_WAVES; i++)
+  {
+    int8_t irq = digitalPinToInterrupt(wave[i].pin);
+    if (wave[i].period_us == 0 || irq < 0 || irq_isr[irq] == NULL)
+      continue;
+    if (powered_down && irq_mode[irq] != LOW && irq < 2)
+      continue;
+    if (wave[i].next_fall_us < next)
+      next = wave[i].next_fall_us;
+  }
+  return next;
+}
+
+int digitalRead(uint8_t pin)
+{
+  for (uint8_t i = 0; i < HOST_WAVES; i++)
+  {
+    host_wave_t *w = &wave[i];
+    if (w->period_us != 0 && w->pin == pin)
+      return ((now_us + w->period_us - w->first_fall_us % w->period_us) % w->period_us < w->low_us) ? LOW : HIGH;
+  }
+  return (pin < sizeof(pin_level)) ? pin_level[pin] : LOW;
+}
+
+// Input divider on a 12.5 V supply (sketch: counts * 5.02 * 5 / 1023)
+int analogRead(uint8_t pin)
+{
+  (void)pin;
+  now_us += HOST_ANALOG_READ_US;
+  return 510;
+}
+
+// Only falling edges are driven: FALLING, CHANGE & LOW ISRs run on them (LOW also
+// right away if the line is low already - the ISR has to detach itself)
+void attachInterrupt(uint8_t irq, void (*isr)(void), int mode)
+{
+  if (irq >= HOST_IRQS)
+    return;
+  irq_isr[irq] = (mode == RISING) ? NULL : isr;
+  irq_mode[irq] = mode;
+  for (uint8_t i = 0; i < HOST_WAVES && mode == LOW; i++)
+  {
+    if (wave[i].period_us != 0 && digitalPinToInterrupt(wave[i].pin) == irq && digitalRead(wave[i].pin) == LOW)
+      irq_pending |= 1 << irq;
+  }
+}
+void detachInterrupt(uint8_t irq)
+{
+  if (irq < HOST_IRQS)  {
+    irq_isr[irq] = NULL;
+    irq_pending &= ~(1 << irq);
+  } //if (irq < HOST_IRQS)
+}
+void noInterrupts()                       { irq_enabled = false; }
+void interrupts()                         { irq_enabled = true;  irq_update(); }
+
+/****************** UARTS ********************/
+#define HOST_SERIAL_TX_BYTES  SERIAL_TX_BUFFER_SIZE
+#define HOST_SERIAL_RX_BYTES  64    //AVR SERIAL_RX_BUFFER_SIZE (holds one less)
+
+static uint32_t byte_us[2] = {1042, 1042};    //10 bits at 9600 baud
+static uint64_t tx_done_us[2];                //when the last queued byte has left
+static bool serial_echo = true;
+
+void host_serial_echo(bool on)  { serial_echo = on; }
+
+void HardwareSerial::begin(unsigned long baud)
+{
+  byte_us[port] = 10000000UL / baud;
+}
+
+static Host_UART_Device *uart_device[2];
+static uint8_t rx_buf[2][HOST_SERIAL_RX_BYTES];
+static uint8_t rx_head[2];
+static uint8_t rx_count[2];
+static uint32_t rx_noise_ppm;     //flipped bits per million bytes received
+static uint32_t rx_rng = 54321;
+
+void host_uart_attach(uint8_t port, Host_UART_Device *device)   { uart_device[port & 1] = device; }
+Host_UART_Device *host_uart_device(uint8_t port)                { return uart_device[port & 1]; }
+void host_uart_noise(uint32_t bit_errors_ppm)                   { rx_noise_ppm = bit_errors_ppm; }
+
+// What the device has sent by now lands in the RX buffer - or is lost once it holds
+// HOST_SERIAL_RX_BYTES - 1, like the AVR core's RX interrupt
+static void rx_update(uint8_t port)
+{
+  uint8_t c;
+  while (uart_device[port] != NULL && uart_device[port]->send(c))
+  {
+    stats.serial_rx_bytes[port]++;
+    if (rx_noise_ppm)  {
+      rx_rng = rx_rng * 1103515245u + 12345u;
+      if ((rx_rng >> 8) % 1000000 < rx_noise_ppm)
+        c ^= 1 << ((rx_rng >> 4) & 0x07);
+    } //if (rx_noise_ppm)
+    if (rx_count[port] >= HOST_SERIAL_RX_BYTES - 1)  {
+      stats.serial_rx_lost[port]++;
+      continue;
+    } //if (RX buffer full)
+    rx_buf[port][(rx_head[port] + rx_count[port]) % HOST_SERIAL_RX_BYTES] = c;
+    rx_count[port]++;
+  }
+}
+
+int HardwareSerial::available()
+{
+  rx_update(port);
+  return rx_count[port];
+}
+
+int HardwareSerial::read()
+{
+  int c = peek();
+  if (c >= 0)  {
+    rx_head[port] = (rx_head[port] + 1) % HOST_SERIAL_RX_BYTES;
+    rx_count[port]--;
+  } //if (c >= 0)
+  return c;
+}
+
+int HardwareSerial::peek()
+{
+  rx_update(port);
+  return rx_count[port] ? rx_buf[port][rx_head[port]] : -1;
+}
+
+int HardwareSerial::availableForWrite()
+{
+  if (tx_done_us[port] <= now_us)
+    return HOST_SERIAL_TX_BYTES - 1;
+  uint32_t queued = (tx_done_us[port] - now_us + byte_us[port] - 1) / byte_us[port];
+  return (queued >= HOST_SERIAL_TX_BYTES) ? 0 : HOST_SERIAL_TX_BYTES - 1 - queued;
+}
+
+// Queues one byte; like the AVR core, waits while the TX buffer is full
+size_t HardwareSerial::write(uint8_t c)
+{
+  if (availableForWrite() == 0)
+    now_us = tx_done_us[port] - (uint64_t)(HOST_SERIAL_TX_BYTES - 2) * byte_us[port];
+  tx_done_us[port] = ((tx_done_us[port] > now_us) ? tx_done_us[port] : now_us) + byte_us[port];
+  stats.serial_bytes[port]++;
+  if (port == 0 && serial_echo)
+    fputc(c, stdout);
+  if (uart_device[port] != NULL)
+    uart_device[port]->receive(c);
+  return 1;
+}
+
+void HardwareSerial::flush()
+{
+  if (tx_done_us[port] > now_us)
+    now_us = tx_done_us[port];
+}
+
+/****************** WATCHDOG ********************/
+static const uint16_t wdt_ms[] = {15, 30, 60, 120, 250, 500, 1000, 2000, 4000, 8000};
+static uint32_t wdt_timeout_us;   //0 = off
+static uint64_t wdt_kick_us;
+
+void host_wdt_enable(uint8_t timeout)
+{
+  wdt_timeout_us = (uint32_t)wdt_ms[(timeout < 10) ? timeout : 9] * 1000;
+  wdt_kick_us = now_us;
+}
+
+void host_wdt_reset()     { wdt_kick_us = now_us; }
+void host_wdt_disable()   { wdt_timeout_us = 0; }
+
+// Checked after every loop(): the Mega would have reset somewhere inside it
+bool host_wdt_expired()
+{
+  return wdt_timeout_us && now_us - wdt_kick_us > wdt_timeout_us;
+}
+
+// When it bites (UINT64_MAX: off)
+static uint64_t wdt_expiry_us()
+{
+  return wdt_timeout_us ? wdt_kick_us + wdt_timeout_us + 1 : UINT64_MAX;
+}
+
+/****************** SLEEP ********************/
+static uint8_t sleep_mode_bits;
+static bool sleep_enabled;
+
+void host_set_sleep_mode(uint8_t mode)  { sleep_mode_bits = mode; }
+void host_sleep_enable(bool on)         { sleep_enabled = on; }
+
+// The clock jumps to the wake-up: idle - timer0's next overflow (every 1.024 ms)
+// or an edge; power-down - an edge that can wake it, or the watchdog. Timer0
+// doesn't count while powered down
+void host_sleep_cpu()
+{
+  if (!sleep_enabled)
+    return;
+  irq_update();
+  bool powered_down = sleep_mode_bits != SLEEP_MODE_IDLE;
+  uint64_t wake_us = irq_next_us(powered_down);
+  if (!powered_down)  {
+    uint64_t ovf_us = now_us + HOST_TIMER0_OVF_US - mcu_us() % HOST_TIMER0_OVF_US;
+    if (ovf_us < wake_us)
+      wake_us = ovf_us;
+  } else if (wake_us == UINT64_MAX)  {
+    wake_us = wdt_expiry_us();
+  } //if (!powered_down)
+  if (wake_us <= now_us || wake_us == UINT64_MAX)
+    return;
+
+  uint64_t slept_us = wake_us - now_us;
+  if (powered_down)  {
+    stats.power_down_us += slept_us;
+    stopped_us += slept_us;
+  } else {
+    stats.idle_us += slept_us;
+  } //if (powered_down)
+  now_us = wake_us;
+  irq_update();
+}
+
+/****************** MCU STATUS & STACK ********************/
+uint8_t MCUSR = 1 << PORF;
+static const char *stack_base;
+
+// main() marks where the sketch's stack starts
+void host_stack_base(const void *base)  { stack_base = (const char *)base; }
+
+int FreeStack()
+{
+  const char *sp = (const char *)__builtin_frame_address(0);
+  return stack_base ? HOST_STACK_BYTES - (int)(stack_base - sp) : HOST_STACK_BYTES;
+}
+
+/****************** EEPROM ********************/
+static uint8_t eeprom[HOST_EEPROM_BYTES];
+static bool eeprom_erased;
+static uint64_t eeprom_ready_us;  //end of the byte write in progress
+
+// Erased until something is written or loaded
+static void eeprom_wait()
+{
+  if (!eeprom_erased)  {
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    eeprom_erased = true;
+  } //if (!eeprom_erased)
+  if (eeprom_ready_us > now_us)
+    now_us = eeprom_ready_us;
+}
+
+uint8_t EEPROMClass::read(int idx)
+{
+  eeprom_wait();
+  return eeprom[idx % HOST_EEPROM_BYTES];
+}
+
+void EEPROMClass::write(int idx, uint8_t val)
+{
+  eeprom_wait();
+  eeprom[idx % HOST_EEPROM_BYTES] = val;
+  eeprom_ready_us = now_us + HOST_EEPROM_WRITE_US;
+}
+
+// eeprom_is_ready(): no byte write in progress (EEPE clear)
+bool host_eeprom_ready()
+{
+  return now_us >= eeprom_ready_us;
+}
+
+// A missing file is an erased EEPROM
+bool host_eeprom_load(const char *path)
+{
+  eeprom_wait();
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  size_t n = fread(eeprom, 1, sizeof(eeprom), f);
+  fclose(f);
+  return n == sizeof(eeprom);
+}
+
+bool host_eeprom_save(const char *path)
+{
+  eeprom_wait();
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  size_t n = fwrite(eeprom, 1, sizeof(eeprom), f);
+  fclose(f);
+  return n == sizeof(eeprom);
+}
+
+/****************** I2C ********************/
+static Host_I2C_Device *i2c_device[128];
+
+void host_i2c_attach(uint8_t addr, Host_I2C_Device *device)  { i2c_device[addr & 0x7F] = device; }
+Host_I2C_Device *host_i2c_device(uint8_t addr)                { return i2c_device[addr & 0x7F]; }
+
+bool host_i2c_fault(uint8_t addr, host_fault_e fault, double start_s, double length_s)
+{
+  Host_I2C_Device *dev = host_i2c_device(addr);
+  if (dev == NULL)
+    return false;
+  dev->inject(fault, (uint64_t)(start_s * 1e6), (uint64_t)(length_s * 1e6));
+  return true;
+}
+
+bool host_i2c_profile(uint8_t addr, const host_profile_t &profile)
+{
+  Host_I2C_Device *dev = host_i2c_device(addr);
+  if (dev == NULL)
+    return false;
+  dev->set_profile(profile);
+  return true;
+}
+
+Host_I2C_Device::Host_I2C_Device()
+{
+  profile.latency = 1.0f;
+  profile.noise = 0;
+  profile.nack_ppm = 0;
+  fault_type = HOST_FAULT_NONE;
+  fault_from_us = 0;
+  fault_until_us = 0;
+  rng = 12345;
+}
+
+void Host_I2C_Device::inject(host_fault_e fault, uint64_t start_us, uint64_t length_us)
+{
+  fault_type = fault;
+  fault_from_us = start_us;
+  fault_until_us = start_us + length_us;
+}
+
+// Injected window first, then the random NACK rate
+host_fault_e Host_I2C_Device::fault()
+{
+  if (fault_type != HOST_FAULT_NONE && now_us >= fault_from_us && now_us < fault_until_us)
+    return fault_type;
+  if (profile.nack_ppm)  {
+    rng = rng * 1103515245u + 12345u;
+    if ((rng >> 8) % 1000000 < profile.nack_ppm)
+      return HOST_FAULT_NACK;
+  } //if (profile.nack_ppm)
+  return HOST_FAULT_NONE;
+}
+
+bool Host_I2C_Device::holds_bus()
+{
+  return fault_type == HOST_FAULT_STUCK && now_us >= fault_from_us && now_us < fault_until_us;
+}
+
+uint64_t Host_I2C_Device::scaled_us(uint64_t nominal_us)
+{
+  return (uint64_t)(nominal_us * profile.latency + 0.5f);
+}
+
+// Triangular noise in +/- profile.noise
+int32_t Host_I2C_Device::noise()
+{
+  if (profile.noise == 0)
+    return 0;
+  rng = rng * 1103515245u + 12345u;
+  int32_t a = (rng >> 8) % (profile.noise + 1);
+  rng = rng * 1103515245u + 12345u;
+  int32_t b = (rng >> 8) % (profile.noise + 1);
+  return a - b;
+}
+
+TwoWire::TwoWire()
+{
+  clock_hz = HOST_I2C_HZ;
+  timeout_us = 0;
+  timeout_flag = false;
+  tx_addr = 0;
+  tx_len = 0;
+  rx_len = 0;
+  rx_pos = 0;
+}
+
+void TwoWire::setWireTimeout(uint32_t timeout, bool reset_with_timeout)
+{
+  (void)reset_with_timeout;
+  timeout_us = timeout;
+}
+
+// START + address + bytes, 9 clocks each (8 bits + ACK)
+void TwoWire::bus_time(uint16_t bytes)
+{
+  now_us += (uint64_t)(1 + bytes) * 9 * 1000000UL / clock_hz;
+  stats.i2c_transactions++;
+  stats.i2c_bytes += bytes;
+}
+
+// SDA held low by a device: the twi driver spins until it lets go, or until the
+// wire timeout (if set) gives up. False = timed out
+bool TwoWire::bus_free()
+{
+  uint64_t until_us = 0;
+  for (uint8_t a = 0; a < 128; a++)
+  {
+    if (i2c_device[a] && i2c_device[a]->holds_bus() && i2c_device[a]->fault_end_us() > until_us)
+      until_us = i2c_device[a]->fault_end_us();
+  }
+  if (until_us == 0)
+    return true;
+  if (timeout_us && until_us - now_us > timeout_us)  {
+    now_us += timeout_us;
+    stats.i2c_stuck_us += timeout_us;
+    stats.i2c_timeouts++;
+    timeout_flag = true;
+    return false;
+  } //if (timed out)
+  stats.i2c_stuck_us += until_us - now_us;
+  now_us = until_us;
+  return true;
+}
+
+// Master write; false = NACK. Address 0x00 goes to every device's general_call()
+bool TwoWire::deliver(uint8_t addr, const uint8_t *buf, uint8_t count)
+{
+  if (addr == HOST_I2C_GENERAL_CALL)  {
+    bool ack = false;
+    for (uint8_t a = 1; a < 128; a++)
+    {
+      if (i2c_device[a] && count > 0 && i2c_device[a]->fault() == HOST_FAULT_NONE &&
+          i2c_device[a]->general_call(buf[0]))
+        ack = true;
+    }
+    return ack;
+  } //if (general call)
+  Host_I2C_Device *dev = host_i2c_device(addr);
+  return dev != NULL && dev->fault() == HOST_FAULT_NONE && dev->write(buf, count);
+}
+
+void TwoWire::beginTransmission(uint8_t addr)
+{
+  tx_addr = addr;
+  tx_len = 0;
+}
+
+size_t TwoWire::write(uint8_t c)
+{
+  if (tx_len >= WIRE_BUFFER_LENGTH)
+    return 0;
+  tx[tx_len++] = c;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *buf, size_t size)
+{
+  size_t n = 0;
+  while (n < size && write(buf[n]))
+    n++;
+  return n;
+}
+
+// 0 = ACK, 2 = address NACK, 5 = timeout (as the AVR twi driver reports)
+uint8_t TwoWire::endTransmission(bool stop)
+{
+  (void)stop;
+  if (!bus_free())
+    return 5;
+  if (!deliver(tx_addr, tx, tx_len))  {
+    bus_time(0);
+    stats.i2c_nacks++;
+    return 2;
+  } //if (NACK)
+  bus_time(tx_len);
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t addr, uint8_t count, uint8_t stop)
+{
+  (void)stop;
+  rx_pos = 0;
+  rx_len = 0;
+  if (count > WIRE_BUFFER_LENGTH)
+    count = WIRE_BUFFER_LENGTH;
+  if (!bus_free())
+    return 0;
+  Host_I2C_Device *dev = host_i2c_device(addr);
+  if (dev == NULL || dev->fault() != HOST_FAULT_NONE || !dev->read(rx, count))  {
+    bus_time(0);
+    stats.i2c_nacks++;
+    return 0;
+  } //if (NACK)
+  bus_time(count);
+  rx_len = count;
+  return count;
+}
+
+/****************** SPI ********************/
+void host_spi_attach(uint8_t cs_pin, Host_SPI_Device *device)
+{
+  if (cs_pin < HOST_PINS)
+    spi_device[cs_pin] = device;
+}
+
+// The byte goes to the device whose chip select is LOW (none: the bus floats high)
+uint8_t SPIClass::transfer(uint8_t data)
+{
+  uint8_t in = 0xFF;
+  now_us += HOST_SPI_US_PER_BYTE;
+  for (uint8_t pin = 0; pin < HOST_PINS; pin++)
+  {
+    if (spi_device[pin] && pin_level[pin] == LOW)
+      in = spi_device[pin]->transfer(data);
+  }
+  return in;
+}
+
+void SPIClass::transfer(void *buf, size_t count)
+{
+  uint8_t *p = (uint8_t *)buf;
+  for (size_t i = 0; i < count; i++)
+    p[i] = transfer(p[i]);
+}
+
+/****************** SD CARD ********************/
+static std::string sd_dir = "sd";
+static std::map<std::string, std::vector<uint8_t> > sd_files;     //the card's files, by path
+static std::vector<std::pair<uint64_t, uint64_t> > sd_out;        //(from, until) us: card out
+
+void host_set_sd_dir(const char *dir)  { sd_dir = dir; }
+const char *host_sd_dir()              { return sd_dir.c_str(); }
+
+void host_sd_out(double start_s, double length_s)
+{
+  sd_out.push_back(std::make_pair((uint64_t)(start_s * 1e6), (uint64_t)((start_s + length_s) * 1e6)));
+}
+
+// Card in the slot right now? (a failed call counts in stats.sd_failed)
+static bool sd_present()
+{
+  for (size_t i = 0; i < sd_out.size(); i++)
+  {
+    if (now_us >= sd_out[i].first && now_us < sd_out[i].second)  {
+      stats.sd_failed++;
+      return false;
+    } //if (out)
+  }
+  return true;
+}
+
+// Removals so far: a File opened before the last one has to be opened again
+static uint32_t sd_removals()
+{
+  uint32_t n = 0;
+  for (size_t i = 0; i < sd_out.size(); i++)
+  {
+    if (now_us >= sd_out[i].first)
+      n++;
+  }
+  return n;
+}
+
+// End of the run = power cut: every file as the card has it (sectors written
+// since the last sync included), as the next boot - or the PC - would read it
+void host_sd_save()
+{
+  std::map<std::string, std::vector<uint8_t> >::iterator it;
+  for (it = sd_files.begin(); it != sd_files.end(); ++it)
+  {
+    FILE *f = fopen(it->first.c_str(), "wb");
+    if (f == NULL)
+      continue;
+    if (!it->second.empty())
+      fwrite(it->second.data(), 1, it->second.size(), f);
+    fclose(f);
+  }
+}
+
+bool SdFat::begin(uint8_t cs_pin)
+{
+  (void)cs_pin;
+  return sd_present();
+}
+
+bool File::usable()
+{
+  if (!open_flag)
+    return false;
+  if (card != sd_removals())  {
+    stats.sd_failed++;
+    return false;
+  } //if (card != sd_removals())
+  return sd_present();
+}
+
+// First open of a name since boot reads it from host_sd_dir()
+bool File::open(const char *name, int flags)
+{
+  if (!sd_present())
+    return false;
+  path = sd_dir + "/" + name;
+  if (sd_files.find(path) == sd_files.end())  {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (f == NULL && !(flags & O_CREAT))
+      return false;
+    std::vector<uint8_t> &bytes = sd_files[path];
+    if (f == NULL)  {
+      now_us += HOST_SD_CREATE_US;
+    } else {
+      int c;
+      while ((c = fgetc(f)) != EOF)
+        bytes.push_back(c);
+      fclose(f);
+    } //if (f == NULL)
+  } //if (not on the card yet)
+  data = &sd_files[path];
+  card = sd_removals();
+  open_flag = true;
+  pos = (flags & O_APPEND) ? data->size() : 0;
+  return true;
+}
+
+bool File::close()
+{
+  if (!open_flag)
+    return false;
+  bool ok = sync();
+  open_flag = false;
+  return ok;
+}
+
+bool File::remove()
+{
+  if (!usable())  {
+    open_flag = false;
+    return false;
+  } //if (!usable())
+  now_us += HOST_SD_SYNC_US + (uint64_t)data->size() * HOST_SD_ALLOC_US_PER_MB / (1024 * 1024);
+  open_flag = false;
+  sd_files.erase(path);
+  data = NULL;
+  return ::remove(path.c_str()) == 0;
+}
+
+bool File::sync()
+{
+  if (!usable())
+    return false;
+  now_us += HOST_SD_SYNC_US;
+  stats.sd_syncs++;
+  FILE *f = fopen(path.c_str(), "wb");
+  if (f == NULL)
+    return false;
+  if (!data->empty())
+    fwrite(data->data(), 1, data->size(), f);
+  fclose(f);
+  return true;
+}
+
+// The extent reads back erased (0xFF) until written, like a freshly erased card
+bool File::preAllocate(uint32_t length)
+{
+  if (!usable() || !data->empty())
+    return false;
+  now_us += (uint64_t)length * HOST_SD_ALLOC_US_PER_MB / (1024 * 1024);
+  data->assign(length, 0xFF);
+  return true;
+}
+
+bool File::contiguousRange(uint32_t *first_sector, uint32_t *last_sector)
+{
+  *first_sector = 0;
+  *last_sector = data->size() / 512;
+  return usable();
+}
+
+bool File::seekSet(uint32_t position)
+{
+  if (!usable() || position > data->size())
+    return false;
+  pos = position;
+  return true;
+}
+
+bool File::truncate(uint32_t length)
+{
+  if (!usable())
+    return false;
+  if (length < data->size())
+    now_us += (uint64_t)(data->size() - length) * HOST_SD_ALLOC_US_PER_MB / (1024 * 1024);
+  data->resize(length);
+  if (pos > length)
+    pos = length;
+  return true;
+}
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+  if (!usable())
+    return 0;
+  if (pos + size > data->size())
+    data->resize(pos + size);
+  memcpy(&(*data)[pos], buf, size);
+  pos += size;
+  now_us += (uint64_t)size * HOST_SD_US_PER_BYTE;
+  stats.sd_bytes += size;
+  stats.sd_writes++;
+  return size;
+}
+
+bool SdCard::erase(uint32_t first_sector, uint32_t last_sector)
+{
+  (void)first_sector;
+  (void)last_sector;
+  if (!sd_present())
+    return false;
+  now_us += HOST_SD_ERASE_US;
+  return true;
+}
+
+int File::read(void *buf, size_t count)
+{
+  size_t n = 0;
+  if (!usable())
+    return -1;
+  while (n < count && pos < data->size())
+    ((uint8_t *)buf)[n++] = (*data)[pos++];
+  return n;
+}
+
+/****************** GLOBALS ********************/
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+TwoWire Wire;
+EEPROMClass EEPROM;
+SPIClass SPI;
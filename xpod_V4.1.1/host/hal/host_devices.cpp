@@ -0,0 +1,671 @@
+/*******************************************************************************
+ * @file    host_devices.cpp
+ * @brief   I2C & UART sensor models for xpod_sim (see host_devices.h) & the default
+ *          bus: what a bench pod with every module fitted would answer
+ *
+ * @cite    ADS1115, MCP3424, BME680, DS3231, PMS5003 & MB85RS64V datasheets; bme68x.c register use
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "host_devices.h"
+#include "bme68x_defs.h"
+
+/****************** ADS1115 ********************/
+static const float ADS_FSR[8] = {6.144f, 4.096f, 2.048f, 1.024f, 0.512f, 0.256f, 0.256f, 0.256f};
+static const uint16_t ADS_SPS[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+
+ADS1115_Device::ADS1115_Device(float ain0, float ain1, float ain2, float ain3)
+{
+  ain[0] = ain0;
+  ain[1] = ain1;
+  ain[2] = ain2;
+  ain[3] = ain3;
+  reg[0] = 0x0000;
+  reg[1] = 0x0583;                //power-on config (OS is read back live)
+  reg[2] = 0x8000;
+  reg[3] = 0x7FFF;
+  pointer = 0;
+  converting = false;
+  done_us = 0;
+  alert_pin = 0xFF;
+}
+
+uint64_t ADS1115_Device::conversion_us()
+{
+  return scaled_us(1000000UL / ADS_SPS[(reg[1] >> 5) & 0x07] + HOST_ADS_WAKEUP_US);
+}
+
+// Mux: 0-3 differential (0-1, 0-3, 1-3, 2-3), 4-7 single-ended; clipped to the PGA range
+int16_t ADS1115_Device::sample()
+{
+  static const uint8_t pos[8] = {0, 0, 1, 2, 0, 1, 2, 3};
+  static const int8_t neg[8] = {1, 3, 3, 3, -1, -1, -1, -1};
+  uint8_t mux = (reg[1] >> 12) & 0x07;
+  float volts = ain[pos[mux]] - ((neg[mux] < 0) ? 0.0f : ain[neg[mux]]);
+  int32_t code = (int32_t)(volts / ADS_FSR[(reg[1] >> 9) & 0x07] * 32768.0f) + noise();
+  if (code > 32767)
+    code = 32767;
+  if (code < -32768)
+    code = -32768;
+  return code;
+}
+
+// Conversions that finished since the last transaction
+void ADS1115_Device::update()
+{
+  if (!converting || host_now_us() < done_us)
+    return;
+  reg[0] = sample();
+  if (reg[1] & 0x0100)  {
+    converting = false;           //single-shot: back to power-down
+  } else {
+    uint64_t period = conversion_us();
+    done_us += ((host_now_us() - done_us) / period + 1) * period;
+  } //if (single-shot)
+}
+
+// ALERT/RDY: conversion-ready mode is hi_thresh MSB 1, lo_thresh MSB 0 & the
+// comparator queue on; then every continuous conversion ends in a pulse (the
+// single-shot pulse isn't modelled), else the open-drain line stays high
+void ADS1115_Device::alert()
+{
+  if (alert_pin == 0xFF)
+    return;
+  bool rdy = converting && !(reg[1] & 0x0100) && (reg[1] & 0x0003) != 0x0003 &&
+             (reg[3] & 0x8000) && !(reg[2] & 0x8000);
+  host_pin_pulse(alert_pin, rdy ? conversion_us() : 0, HOST_ADS_RDY_PULSE_US, done_us);
+}
+
+bool ADS1115_Device::write(const uint8_t *buf, uint8_t count)
+{
+  update();
+  if (count == 0)
+    return true;
+  pointer = buf[0] & 0x03;
+  if (count < 3)
+    return true;
+  uint16_t value = (buf[1] << 8) | buf[2];
+  if (pointer == 0)
+    return true;                  //conversion register is read-only
+  reg[pointer] = (pointer == 1) ? (value & 0x7FFF) : value;
+  if (pointer == 1 && (!(value & 0x0100) || (value & 0x8000)))  {
+    converting = true;            //continuous, or a single-shot start (OS = 1)
+    done_us = host_now_us() + conversion_us();
+  } //if (conversion started)
+  alert();
+  return true;
+}
+
+bool ADS1115_Device::read(uint8_t *buf, uint8_t count)
+{
+  update();
+  uint16_t value = reg[pointer];
+  if (pointer == 1 && !converting)
+    value |= 0x8000;              //OS: 1 = not converting
+  for (uint8_t i = 0; i < count; i++)
+    buf[i] = (i & 1) ? (value & 0xFF) : (value >> 8);
+  return true;
+}
+
+/****************** MCP3424 ********************/
+static const uint32_t MCP_CONVERSION_US[4] = {4167, 16667, 66667, 266667};   //240, 60, 15, 3.75 SPS
+
+MCP3424_Device::MCP3424_Device(float ch1, float ch2, float ch3, float ch4)
+{
+  ain[0] = ch1;
+  ain[1] = ch2;
+  ain[2] = ch3;
+  ain[3] = ch4;
+  general_call(0x06);
+}
+
+void MCP3424_Device::start()
+{
+  converting = true;
+  done_us = host_now_us() + scaled_us(MCP_CONVERSION_US[(config >> 2) & 0x03]);
+}
+
+// Code = V x gain / 2.048 V x 2^(bits - 1), clipped
+int32_t MCP3424_Device::sample()
+{
+  int32_t full = 1L << (resolution() - 1);
+  int32_t code = (int32_t)(ain[(config >> 5) & 0x03] * (1 << (config & 0x03)) / 2.048f * full) + noise();
+  if (code > full - 1)
+    code = full - 1;
+  if (code < -full)
+    code = -full;
+  return code;
+}
+
+void MCP3424_Device::update()
+{
+  if (!converting || host_now_us() < done_us)
+    return;
+  result = sample();
+  fresh = true;
+  if (config & 0x10)  {
+    uint64_t period = scaled_us(MCP_CONVERSION_US[(config >> 2) & 0x03]);
+    done_us += ((host_now_us() - done_us) / period + 1) * period;
+  } else {
+    converting = false;
+  } //if (continuous)
+}
+
+bool MCP3424_Device::write(const uint8_t *buf, uint8_t count)
+{
+  update();
+  if (count == 0)
+    return true;
+  config = buf[0] & 0x7F;
+  if ((config & 0x10) || (buf[0] & 0x80))
+    start();
+  return true;
+}
+
+// Data bytes (sign extended to 16 or 24 bits), then the config byte repeated
+bool MCP3424_Device::read(uint8_t *buf, uint8_t count)
+{
+  update();
+  uint8_t data_bytes = (resolution() == 18) ? 3 : 2;
+  uint8_t status = config | (fresh ? 0x00 : 0x80);
+  for (uint8_t i = 0; i < count; i++)
+    buf[i] = (i < data_bytes) ? (uint8_t)(result >> (8 * (data_bytes - 1 - i))) : status;
+  if (count > data_bytes)
+    fresh = false;                //RDY only goes back up once the config byte is read
+  return true;
+}
+
+bool MCP3424_Device::general_call(uint8_t cmd)
+{
+  switch (cmd)
+  {
+    case 0x06:                    //reset: power-on config, continuous 12 bit on channel 1
+      update();
+      config = 0x10;
+      fresh = false;
+      result = 0;
+      start();
+      return true;
+    case 0x04:                    //latch address pins
+      return true;
+    case 0x08:                    //conversion: one-shot with the current config
+      update();
+      start();
+      return true;
+    default:
+      return false;
+  }
+}
+
+/****************** BME680 ********************/
+// Typical calibration (par_t1 26000 ...) & the raw readings that give
+// 22.00 C, 840.0 hPa, 35.0 %RH & 63 kOhm through bme68x.c's float compensation
+#define BME_T_ADC             486972UL
+#define BME_P_ADC             449494UL
+#define BME_H_ADC             18437U
+#define BME_GAS_ADC           512U
+#define BME_GAS_RANGE         7
+#define BME_MEASURING         0x20    //meas_status_0 bits
+#define BME_GAS_MEASURING     0x40
+
+BME680_Device::BME680_Device()
+{
+  memset(regs, 0, sizeof(regs));
+  regs[BME68X_REG_CHIP_ID] = BME68X_CHIP_ID;
+  regs[BME68X_REG_VARIANT_ID] = BME68X_VARIANT_GAS_LOW;
+  calibrate();
+  reset();
+}
+
+// Calibration byte i lives at 0x8A + i, 0xE1 + (i - 23) or 0x00 + (i - 37)
+static uint8_t bme_coeff_reg(uint8_t index)
+{
+  if (index < BME68X_LEN_COEFF1)
+    return BME68X_REG_COEFF1 + index;
+  if (index < BME68X_LEN_COEFF1 + BME68X_LEN_COEFF2)
+    return BME68X_REG_COEFF2 + index - BME68X_LEN_COEFF1;
+  return BME68X_REG_COEFF3 + index - BME68X_LEN_COEFF1 - BME68X_LEN_COEFF2;
+}
+
+void BME680_Device::put16(uint8_t index, int16_t value)
+{
+  regs[bme_coeff_reg(index)] = value & 0xFF;
+  regs[bme_coeff_reg(index + 1)] = (uint16_t)value >> 8;
+}
+
+void BME680_Device::calibrate()
+{
+  put16(BME68X_IDX_T1_LSB, 26000);
+  put16(BME68X_IDX_T2_LSB, 26000);
+  regs[bme_coeff_reg(BME68X_IDX_T3)] = 3;
+  put16(BME68X_IDX_P1_LSB, (int16_t)36000);
+  put16(BME68X_IDX_P2_LSB, -10400);
+  regs[bme_coeff_reg(BME68X_IDX_P3)] = 88;
+  put16(BME68X_IDX_P4_LSB, 7000);
+  put16(BME68X_IDX_P5_LSB, -150);
+  regs[bme_coeff_reg(BME68X_IDX_P6)] = 30;
+  regs[bme_coeff_reg(BME68X_IDX_P7)] = 30;
+  put16(BME68X_IDX_P8_LSB, -3000);
+  put16(BME68X_IDX_P9_LSB, -2000);
+  regs[bme_coeff_reg(BME68X_IDX_P10)] = 30;
+  // par_h1 = 700, par_h2 = 1000: 12 bit values sharing the byte between them
+  regs[bme_coeff_reg(BME68X_IDX_H2_MSB)] = 1000 >> 4;
+  regs[bme_coeff_reg(BME68X_IDX_H2_LSB)] = ((1000 & 0x0F) << 4) | (700 & 0x0F);
+  regs[bme_coeff_reg(BME68X_IDX_H1_MSB)] = 700 >> 4;
+  regs[bme_coeff_reg(BME68X_IDX_H3)] = 0;
+  regs[bme_coeff_reg(BME68X_IDX_H4)] = 45;
+  regs[bme_coeff_reg(BME68X_IDX_H5)] = 20;
+  regs[bme_coeff_reg(BME68X_IDX_H6)] = 120;
+  regs[bme_coeff_reg(BME68X_IDX_H7)] = (uint8_t)-100;
+  put16(BME68X_IDX_GH2_LSB, -6000);
+  regs[bme_coeff_reg(BME68X_IDX_GH1)] = (uint8_t)-30;
+  regs[bme_coeff_reg(BME68X_IDX_GH3)] = 18;
+  regs[bme_coeff_reg(BME68X_IDX_RES_HEAT_VAL)] = 40;
+  regs[bme_coeff_reg(BME68X_IDX_RES_HEAT_RANGE)] = 1 << 4;
+  regs[bme_coeff_reg(BME68X_IDX_RANGE_SW_ERR)] = 0;
+}
+
+// Soft reset: control & heater registers back to 0, sleep mode, no data
+void BME680_Device::reset()
+{
+  memset(&regs[BME68X_REG_FIELD0], 0, BME68X_LEN_FIELD);
+  memset(&regs[BME68X_REG_IDAC_HEAT0], 0, BME68X_REG_CONFIG + 1 - BME68X_REG_IDAC_HEAT0);
+  pointer = 0;
+  measuring = false;
+  done_us = 0;
+}
+
+// TPH oversampling cycles + switching/wake-up, then the heater wait (if run_gas)
+uint64_t BME680_Device::measurement_us()
+{
+  static const uint8_t cycles[8] = {0, 1, 2, 4, 8, 16, 16, 16};
+  uint8_t meas = regs[BME68X_REG_CTRL_MEAS];
+  uint32_t us = (cycles[meas >> 5] + cycles[(meas >> 2) & 0x07] + cycles[regs[BME68X_REG_CTRL_HUM] & 0x07])
+                * HOST_BME_TPH_CYCLE_US + HOST_BME_FIXED_US;
+  if (regs[BME68X_REG_CTRL_GAS_1] & 0x10)  {
+    static const uint8_t factor[4] = {1, 4, 16, 64};
+    uint8_t wait = regs[BME68X_REG_GAS_WAIT0];
+    us += (uint32_t)factor[wait >> 6] * (wait & 0x3F) * 1000;
+  } //if (run_gas)
+  return scaled_us(us);
+}
+
+// Forced measurement done: field registers filled, new_data set, back to sleep
+void BME680_Device::update()
+{
+  if (!measuring || host_now_us() < done_us)
+    return;
+  uint8_t *field = &regs[BME68X_REG_FIELD0];
+  uint32_t p = BME_P_ADC + 16 * noise();
+  uint32_t t = BME_T_ADC + 16 * noise();
+  uint16_t h = BME_H_ADC + noise();
+  field[0] = BME68X_NEW_DATA_MSK;
+  field[1]++;                     //measurement index
+  field[2] = p >> 12;
+  field[3] = p >> 4;
+  field[4] = (p & 0x0F) << 4;
+  field[5] = t >> 12;
+  field[6] = t >> 4;
+  field[7] = (t & 0x0F) << 4;
+  field[8] = h >> 8;
+  field[9] = h & 0xFF;
+  if (regs[BME68X_REG_CTRL_GAS_1] & 0x10)  {
+    uint16_t gas = BME_GAS_ADC + noise();
+    field[13] = gas >> 2;
+    field[14] = ((gas & 0x03) << 6) | BME68X_GASM_VALID_MSK | BME68X_HEAT_STAB_MSK | BME_GAS_RANGE;
+  } else {
+    field[13] = 0;
+    field[14] = 0;
+  } //if (run_gas)
+  regs[BME68X_REG_CTRL_MEAS] &= ~BME68X_MODE_MSK;
+  measuring = false;
+}
+
+// One byte = register pointer; more = (register, value) pairs (bme68x_set_regs())
+bool BME680_Device::write(const uint8_t *buf, uint8_t count)
+{
+  update();
+  if (count == 0)
+    return true;
+  pointer = buf[0];
+  for (uint8_t i = 0; i + 1 < count; i += 2)
+  {
+    uint8_t addr = buf[i];
+    if (addr == BME68X_REG_SOFT_RESET)  {
+      if (buf[i + 1] == BME68X_SOFT_RESET_CMD)
+        reset();
+      continue;
+    } //if (addr == BME68X_REG_SOFT_RESET)
+    if (addr == BME68X_REG_CHIP_ID || addr == BME68X_REG_VARIANT_ID || addr < BME68X_REG_IDAC_HEAT0)
+      continue;                   //read-only
+    regs[addr] = buf[i + 1];
+    if (addr == BME68X_REG_CTRL_MEAS && (buf[i + 1] & BME68X_MODE_MSK) == BME68X_FORCED_MODE)  {
+      measuring = true;
+      done_us = host_now_us() + measurement_us();
+      regs[BME68X_REG_FIELD0] = BME_MEASURING | ((regs[BME68X_REG_CTRL_GAS_1] & 0x10) ? BME_GAS_MEASURING : 0);
+    } //if (forced mode)
+  }
+  return true;
+}
+
+bool BME680_Device::read(uint8_t *buf, uint8_t count)
+{
+  update();
+  for (uint8_t i = 0; i < count; i++)
+    buf[i] = regs[(uint8_t)(pointer + i)];
+  pointer += count;
+  return true;
+}
+
+/****************** DS3231 ********************/
+static uint32_t rtc_start_unix = HOST_START_UNIX;
+
+// RTC time at boot (before the first DS3231_Device read)
+void host_rtc_start(uint32_t unix_s)
+{
+  rtc_start_unix = unix_s;
+}
+
+DS3231_Device::DS3231_Device()
+{
+  memset(regs, 0, sizeof(regs));
+  regs[0x0E] = 0x1C;              //control: INTCN, 8 kHz rate bits (power-on)
+  regs[0x0F] = 0x00;              //status: OSF clear - kept time on the coin cell
+  regs[0x11] = 25;                //temperature 25.00 C
+  pointer = 0;
+  offset_s = 0;
+}
+
+bool DS3231_Device::write(const uint8_t *buf, uint8_t count)
+{
+  if (count == 0)
+    return true;
+  pointer = buf[0] % sizeof(regs);
+  if (count >= 8 && pointer == 0)  {
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_sec = bcd2bin(buf[1] & 0x7F);
+    tm.tm_min = bcd2bin(buf[2]);
+    tm.tm_hour = bcd2bin(buf[3] & 0x3F);
+    tm.tm_mday = bcd2bin(buf[5]);
+    tm.tm_mon = bcd2bin(buf[6] & 0x7F) - 1;
+    tm.tm_year = bcd2bin(buf[7]) + 100;
+    offset_s = (int64_t)timegm(&tm) - (int64_t)(rtc_start_unix + host_now_us() / 1000000);
+  } else {
+    for (uint8_t i = 1; i < count; i++)
+      regs[(pointer + i - 1) % sizeof(regs)] = buf[i];
+    if (pointer <= 0x0E && pointer + count - 1 > 0x0E)
+      control();
+  } //if (time registers)
+  return true;
+}
+
+// SQW: on at 1 Hz only (the kHz rates would need an interrupt every few hundred us)
+void DS3231_Device::control()
+{
+  bool sqw_1hz = (regs[0x0E] & 0x1C) == 0x00;
+  host_pin_wave(HOST_SQW_PIN, sqw_1hz ? 1000000 : 0);
+}
+
+bool DS3231_Device::read(uint8_t *buf, uint8_t count)
+{
+  time_t t = rtc_start_unix + host_now_us() / 1000000 + offset_s;
+  struct tm tm;
+  gmtime_r(&t, &tm);
+  regs[0] = bin2bcd(tm.tm_sec);
+  regs[1] = bin2bcd(tm.tm_min);
+  regs[2] = bin2bcd(tm.tm_hour);
+  regs[3] = tm.tm_wday + 1;
+  regs[4] = bin2bcd(tm.tm_mday);
+  regs[5] = bin2bcd(tm.tm_mon + 1);
+  regs[6] = bin2bcd(tm.tm_year - 100);
+  for (uint8_t i = 0; i < count; i++)
+    buf[i] = regs[(pointer + i) % sizeof(regs)];
+  pointer = (pointer + count) % sizeof(regs);
+  return true;
+}
+
+/****************** ELT S300 ********************/
+S300_Device::S300_Device(uint16_t ppm) : ppm(ppm)
+{
+  reading = ppm;
+  next_update_us = 0;
+  ready_us = 0;
+}
+
+bool S300_Device::write(const uint8_t *buf, uint8_t count)
+{
+  if (count > 0 && buf[0] == 0x52)
+    ready_us = host_now_us() + scaled_us(HOST_S300_PREP_US);
+  return true;
+}
+
+bool S300_Device::read(uint8_t *buf, uint8_t count)
+{
+  if (host_now_us() < ready_us)
+    host_advance_us(ready_us - host_now_us());    //holds SCL until the frame is ready
+  if (host_now_us() >= next_update_us)  {
+    reading = ppm + noise();
+    next_update_us = host_now_us() + scaled_us(HOST_S300_UPDATE_US);
+  } //if (new reading due)
+  uint8_t frame[7] = {0x08, (uint8_t)(reading >> 8), (uint8_t)reading, 0, 0, 0, 0};
+  for (uint8_t i = 0; i < count; i++)
+    buf[i] = (i < sizeof(frame)) ? frame[i] : 0xFF;
+  return true;
+}
+
+/****************** PMS5003 ********************/
+PMS5003_Device::PMS5003_Device(uint16_t pm25, uint16_t noise) : pm25(pm25), noise_ug(noise)
+{
+  active = true;                  //power-up defaults
+  awake = true;
+  woke_us = 0;
+  awake_us = 0;
+  next_frame_us = HOST_PMS_FRAME_US;
+  line_free_us = 0;
+  cmd_len = 0;
+  rng = 24680;
+}
+
+// Triangular noise in +/- noise_ug
+int32_t PMS5003_Device::noise()
+{
+  if (noise_ug == 0)
+    return 0;
+  rng = rng * 1103515245u + 12345u;
+  int32_t a = (rng >> 8) % (noise_ug + 1);
+  rng = rng * 1103515245u + 12345u;
+  int32_t b = (rng >> 8) % (noise_ug + 1);
+  return a - b;
+}
+
+// Bytes go out back to back from start_us (or once the line is free)
+void PMS5003_Device::queue(const uint8_t *bytes, uint8_t count, uint64_t start_us)
+{
+  uint64_t t = (start_us > line_free_us) ? start_us : line_free_us;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    t += HOST_UART_BYTE_US;
+    out.push_back(std::make_pair(t, bytes[i]));
+  }
+  line_free_us = t;
+}
+
+// Urban-background size distribution scaled to pm25; CF=1 equals atmospheric below ~30 ug/m3
+void PMS5003_Device::frame(uint64_t start_us)
+{
+  uint64_t up_us = start_us - woke_us;
+  float spin = (up_us >= HOST_PMS_STEADY_US) ? 1.0f : 0.3f + 0.7f * up_us / HOST_PMS_STEADY_US;
+  int32_t pm = (int32_t)(pm25 * spin + 0.5f) + noise();
+  if (pm < 0)
+    pm = 0;
+  uint16_t value[13] = {(uint16_t)(pm * 6 / 10), (uint16_t)pm, (uint16_t)(pm * 13 / 10),
+                        (uint16_t)(pm * 6 / 10), (uint16_t)pm, (uint16_t)(pm * 13 / 10),
+                        (uint16_t)(pm * 150), (uint16_t)(pm * 45), (uint16_t)(pm * 8),
+                        (uint16_t)(pm * 8 / 10), (uint16_t)(pm * 2 / 10), (uint16_t)(pm / 20), 0x9700};
+  uint8_t bytes[32] = {0x42, 0x4D, 0x00, 0x1C};
+  for (uint8_t i = 0; i < 13; i++)
+  {
+    bytes[4 + 2 * i] = value[i] >> 8;
+    bytes[5 + 2 * i] = value[i] & 0xFF;
+  }
+  uint16_t sum = 0;
+  for (uint8_t i = 0; i < 30; i++)
+    sum += bytes[i];
+  bytes[30] = sum >> 8;
+  bytes[31] = sum & 0xFF;
+  queue(bytes, sizeof(bytes), start_us);
+}
+
+// 0xE1 mode (0 passive, 1 active), 0xE2 passive read, 0xE4 sleep (0) / wake (1)
+void PMS5003_Device::command(uint8_t cmd, uint8_t data)
+{
+  uint64_t now = host_now_us();
+  if (cmd == 0xE2)  {
+    if (!active && awake)
+      frame(now);
+    return;
+  } //if (cmd == 0xE2)
+  if (cmd == 0xE1)  {
+    active = data;
+    next_frame_us = now + HOST_PMS_FRAME_US;
+  } else if (cmd == 0xE4)  {
+    if (data && !awake)  {
+      next_frame_us = now + HOST_PMS_FRAME_US;
+      woke_us = now;
+    } else if (!data && awake)  {
+      awake_us += now - woke_us;
+    } //if (wake / sleep)
+    awake = data;
+  } else {
+    return;
+  } //if (cmd)
+  uint8_t reply[8] = {0x42, 0x4D, 0x00, 0x04, cmd, data};
+  uint16_t sum = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    sum += reply[i];
+  reply[6] = sum >> 8;
+  reply[7] = sum & 0xFF;
+  queue(reply, sizeof(reply), now);
+}
+
+// 0x42 0x4D CMD DATAH DATAL LRCH LRCL
+void PMS5003_Device::receive(uint8_t c)
+{
+  if ((cmd_len == 0 && c != 0x42) || (cmd_len == 1 && c != 0x4D))  {
+    cmd_len = (c == 0x42) ? 1 : 0;
+    return;
+  } //if (not a command start)
+  cmd[cmd_len++] = c;
+  if (cmd_len < sizeof(cmd))
+    return;
+  cmd_len = 0;
+  uint16_t sum = 0;
+  for (uint8_t i = 0; i < 5; i++)
+    sum += cmd[i];
+  if (sum == ((cmd[5] << 8) | cmd[6]))
+    command(cmd[2], cmd[4]);
+}
+
+void PMS5003_Device::report()
+{
+  uint64_t now = host_now_us();
+  uint64_t on_us = awake_us + (awake ? now - woke_us : 0);
+  double charge_mAh = (on_us * HOST_PMS_ACTIVE_MA + (now - on_us) * HOST_PMS_STANDBY_MA) / 3.6e9;
+  fprintf(stderr, "[sim] PMS5003: fan on %.0f of %.0f s (%.0f%%), %.2f mAh\n", on_us / 1e6, now / 1e6,
+          now ? 100.0 * on_us / now : 0.0, charge_mAh);
+}
+
+bool PMS5003_Device::send(uint8_t &c)
+{
+  uint64_t now = host_now_us();
+  while (active && awake && next_frame_us <= now)
+  {
+    frame(next_frame_us);
+    next_frame_us += HOST_PMS_FRAME_US;
+  }
+  if (out.empty() || out.front().first > now)
+    return false;
+  c = out.front().second;
+  out.pop_front();
+  return true;
+}
+
+/****************** FRAM ********************/
+FRAM_Device::FRAM_Device()
+{
+  memset(mem, 0xFF, sizeof(mem));
+  write_enabled = false;
+  opcode = 0;
+  count = 0;
+  addr = 0;
+}
+
+// CS high ends the command; a finished WRITE clears the write enable latch
+void FRAM_Device::select(bool selected)
+{
+  if (!selected && opcode == 0x02 && count > 3)
+    write_enabled = false;
+  opcode = 0;
+  count = 0;
+}
+
+uint8_t FRAM_Device::transfer(uint8_t out)
+{
+  uint8_t in = 0xFF;
+  if (count == 0)  {
+    opcode = out;
+    if (opcode == 0x06)
+      write_enabled = true;
+    else if (opcode == 0x04)
+      write_enabled = false;
+  } else if (count < 3)  {
+    addr = (addr << 8) | out;
+  } else if (opcode == 0x03)  {
+    in = mem[addr++ % HOST_FRAM_BYTES];
+  } else if (opcode == 0x02 && write_enabled)  {
+    mem[addr++ % HOST_FRAM_BYTES] = out;
+  } //if (count)
+  if (count < 255)
+    count++;
+  return in;
+}
+
+/****************** DEFAULT BUS ********************/
+/*! Bench pod: ADS inputs (V) near the sensors' clean-air outputs, small
+ *  Alphasense differentials on the Quadstats, 420 ppm CO2, 12 ug/m3 PM2.5 */
+void host_attach_default_devices()
+{
+  static const struct { uint8_t addr; uint16_t noise; } noisy[] = {
+    {0x48, 4}, {0x49, 4}, {0x4A, 4}, {0x4B, 4}, {0x69, 3}, {0x6E, 3}, {0x76, 2}, {0x31, 3}
+  };
+  static const uint8_t ads_rdy_pins[4] = HOST_ADS_RDY_PINS;
+  ADS1115_Device *ads[4] = {
+    new ADS1115_Device(1.21f, 0.87f, 2.05f, 0.42f),
+    new ADS1115_Device(1.64f, 0.91f, 1.12f, 0.0f),
+    new ADS1115_Device(0.412f, 0.398f, 0.301f, 0.287f),
+    new ADS1115_Device(0.96f, 0.305f, 0.290f, 0.0f)
+  };
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    ads[i]->alert_on(ads_rdy_pins[i]);
+    host_i2c_attach(0x48 + i, ads[i]);
+  }
+  host_i2c_attach(0x69, new MCP3424_Device(0.0212f, -0.0041f, 0.0175f, 0.0033f));
+  host_i2c_attach(0x6E, new MCP3424_Device(0.0308f, 0.0012f, -0.0096f, 0.0027f));
+  host_i2c_attach(0x76, new BME680_Device());
+  host_i2c_attach(0x68, new DS3231_Device());
+  host_i2c_attach(0x31, new S300_Device(420));
+  host_uart_attach(1, new PMS5003_Device(12, 3));
+  host_spi_attach(HOST_FRAM_CS, new FRAM_Device());
+  for (uint8_t i = 0; i < sizeof(noisy) / sizeof(noisy[0]); i++)
+  {
+    host_profile_t p = {1.0f, noisy[i].noise, 0};
+    host_i2c_profile(noisy[i].addr, p);
+  }
+}
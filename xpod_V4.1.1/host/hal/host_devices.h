@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * @file    host_devices.h
+ * @brief   Register-level models of the pod's I2C sensors for xpod_sim, at the
+ *          addresses in xpod_node.h. Conversions take their datasheet time on the
+ *          virtual clock (x host_profile_t.latency), results get +/- noise LSBs,
+ *          and each one can NACK or hold the bus (Host_I2C_Device::inject()).
+ *          The PMS5003 on Serial1 sends its frames at 9600 baud on the same clock;
+ *          an SPI FRAM sits on the SD_SPOOL_FRAM_CS pin
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _HOST_DEVICES_H
+#define _HOST_DEVICES_H
+
+#include <stdint.h>
+#include <deque>
+
+#include "host_hal.h"
+
+/****************** SET ADDR & CONST ********************/
+#define HOST_ADS_WAKEUP_US    25      //single-shot power-up before the conversion
+#define HOST_ADS_RDY_PULSE_US 8       //ALERT/RDY low after each continuous conversion
+#define HOST_ADS_RDY_PINS     {2, 3, 18, 19}  //ADS_RDY_PINS: ALERT/RDY of 0x48, 0x49, 0x4A, 0x4B
+#define HOST_BME_TPH_CYCLE_US 1963    //per oversampling cycle (bme68x_get_meas_dur)
+#define HOST_BME_FIXED_US     (477 * 4 + 477 * 5 + 1000)  //switching, gas & wake up
+#define HOST_S300_UPDATE_US   3000000 //new CO2 value every 3 s
+#define HOST_S300_PREP_US     1000    //command to frame ready (clock stretched)
+#define HOST_UART_BYTE_US     1042    //10 bits at 9600 baud
+#define HOST_PMS_FRAME_US     1000000 //active mode (datasheet: 200-800 ms changing, 2.3 s steady)
+#define HOST_PMS_STEADY_US    30000000 //fan up to speed after wake: readings low until then
+#define HOST_PMS_ACTIVE_MA    100.0f  //datasheet max, fan & laser on
+#define HOST_PMS_STANDBY_MA   0.2f
+#define HOST_FRAM_CS          49      //SD_SPOOL_FRAM_CS
+#define HOST_SQW_PIN          2       //RTC_SQW_PIN
+#define HOST_FRAM_BYTES       8192    //MB85RS64V
+
+/****************** CLASSES ********************/
+/*! ADS1115: 4 inputs (V), pointer/config/conversion registers, single-shot &
+ *  continuous mode, conversion time from the data rate bits. With the thresholds
+ *  in conversion-ready mode, continuous conversions pulse ALERT/RDY (alert_on()) */
+class ADS1115_Device : public Host_I2C_Device {
+  public:
+    ADS1115_Device(float ain0, float ain1, float ain2, float ain3);
+    bool write(const uint8_t *buf, uint8_t count);
+    bool read(uint8_t *buf, uint8_t count);
+    void alert_on(uint8_t pin)    { alert_pin = pin; }
+
+  private:
+    void update();
+    void alert();
+    int16_t sample();
+    uint64_t conversion_us();
+
+    float ain[4];
+    uint16_t reg[4];              //conversion, config, lo_thresh, hi_thresh
+    uint8_t pointer;
+    bool converting;
+    uint64_t done_us;
+    uint8_t alert_pin;            //0xFF = not wired
+};
+
+/*! MCP3424: 4 differential inputs (V), one config byte, 12-18 bit (240-3.75 SPS),
+ *  one-shot & continuous, RDY cleared by a new result & set again once read;
+ *  answers the general call reset (0x06) & conversion (0x08) */
+class MCP3424_Device : public Host_I2C_Device {
+  public:
+    MCP3424_Device(float ch1, float ch2, float ch3, float ch4);
+    bool write(const uint8_t *buf, uint8_t count);
+    bool read(uint8_t *buf, uint8_t count);
+    bool general_call(uint8_t cmd);
+
+  private:
+    void start();
+    void update();
+    int32_t sample();
+    uint8_t resolution()          { return 12 + 2 * ((config >> 2) & 0x03); }
+
+    float ain[4];
+    uint8_t config;               //without the RDY bit
+    bool fresh;                   //result not read yet (RDY = 0)
+    bool converting;
+    uint64_t done_us;
+    int32_t result;
+};
+
+/*! BME680 (low gas variant): chip ID, calibration & field registers; a forced
+ *  mode write measures for the TPH oversampling time + the heater wait, with
+ *  fixed raw readings near 22 C, 840 hPa, 35 %RH & 63 kOhm */
+class BME680_Device : public Host_I2C_Device {
+  public:
+    BME680_Device();
+    bool write(const uint8_t *buf, uint8_t count);
+    bool read(uint8_t *buf, uint8_t count);
+
+  private:
+    void reset();
+    void calibrate();
+    void put16(uint8_t index, int16_t value);
+    void update();
+    uint64_t measurement_us();
+
+    uint8_t regs[256];
+    uint8_t pointer;
+    bool measuring;
+    uint64_t done_us;
+};
+
+/*! DS3231: time registers follow the virtual clock from host_rtc_start() (writing
+ *  them moves it); control, status & temperature registers as after a clean start.
+ *  INTCN cleared at the 1 Hz rate drives HOST_SQW_PIN (falls as the seconds count) */
+class DS3231_Device : public Host_I2C_Device {
+  public:
+    DS3231_Device();
+    bool write(const uint8_t *buf, uint8_t count);
+    bool read(uint8_t *buf, uint8_t count);
+
+  private:
+    static uint8_t bcd2bin(uint8_t v)  { return v - 6 * (v >> 4); }
+    static uint8_t bin2bcd(uint8_t v)  { return v + 6 * (v / 10); }
+    void control();
+
+    uint8_t regs[19];
+    uint8_t pointer;
+    int64_t offset_s;
+};
+
+/*! ELT S300: "R" (0x52) then a 7 byte frame - status, CO2 MSB, CO2 LSB, 4 reserved.
+ *  The reading moves every HOST_S300_UPDATE_US */
+class S300_Device : public Host_I2C_Device {
+  public:
+    S300_Device(uint16_t ppm);
+    bool write(const uint8_t *buf, uint8_t count);
+    bool read(uint8_t *buf, uint8_t count);
+
+  private:
+    uint16_t ppm;
+    uint16_t reading;
+    uint64_t next_update_us;
+    uint64_t ready_us;
+};
+
+/*! Plantower PMS5003 on a UART: 32 byte frames (PM1/2.5/10 CF=1 & atmospheric,
+ *  six particle counts) every HOST_PMS_FRAME_US in active mode, one per request in
+ *  passive mode; sleep/wake & mode commands answered with a 4 byte-length frame.
+ *  After a wake-up readings start at 30 % and reach the true value at
+ *  HOST_PMS_STEADY_US; report() gives fan time and charge drawn */
+class PMS5003_Device : public Host_UART_Device {
+  public:
+    PMS5003_Device(uint16_t pm25, uint16_t noise);
+    void receive(uint8_t c);
+    bool send(uint8_t &c);
+    void report();
+
+  private:
+    void command(uint8_t cmd, uint8_t data);
+    void frame(uint64_t start_us);
+    void queue(const uint8_t *bytes, uint8_t count, uint64_t start_us);
+    int32_t noise();
+
+    uint16_t pm25;                //ug/m3
+    uint16_t noise_ug;            //+/- on every frame
+    bool active;
+    bool awake;
+    uint64_t woke_us;
+    uint64_t awake_us;            //fan time before the current wake
+    uint64_t next_frame_us;       //active mode
+    uint64_t line_free_us;        //end of the last byte queued
+    std::deque<std::pair<uint64_t, uint8_t> > out;   //(fully sent at, byte)
+    uint8_t cmd[7];               //command being received
+    uint8_t cmd_len;
+    uint32_t rng;
+};
+
+/*! SPI FRAM (MB85RS64V): WREN, then WRITE/READ with a 2 byte address that
+ *  wraps; writes take no time beyond the bus. Starts erased (0xFF) */
+class FRAM_Device : public Host_SPI_Device {
+  public:
+    FRAM_Device();
+    void select(bool selected);
+    uint8_t transfer(uint8_t out);
+
+  private:
+    uint8_t mem[HOST_FRAM_BYTES];
+    bool write_enabled;
+    uint8_t opcode;
+    uint8_t count;                //bytes since select
+    uint16_t addr;
+};
+
+#endif //_HOST_DEVICES_H
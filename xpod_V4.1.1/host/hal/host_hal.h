@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * @file    host_hal.h
+ * @brief   Simulation side of the host HAL (not seen by the sketch): the virtual
+ *          clock, I/O counters and the I2C bus's, UARTs' & SPI chip selects' device
+ *          tables, for xpod_sim.cpp
+ *
+ *          Nothing runs in parallel: time only moves when the firmware reads the
+ *          clock, waits, or does I/O, each costing what it would on the Mega.
+ *          The sensor models behind the bus are in host_devices.h
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _HOST_HAL_H
+#define _HOST_HAL_H
+
+#include <stdint.h>
+
+/****************** SET ADDR & CONST ********************/
+#define HOST_CLOCK_READ_US    4     //millis()/micros() call (incl. the caller's compare)
+#define HOST_ANALOG_READ_US   112   //ADC: 13 cycles at 125 kHz (+ call)
+#define HOST_TIMER0_OVF_US    1024  //millis() interrupt: 256 x 64 prescaler at 16 MHz (wakes idle sleep)
+#define HOST_MCU_ACTIVE_MA    20.0  //ATmega2560 at 16 MHz, 5 V, running (datasheet typ.; MCU only -
+#define HOST_MCU_IDLE_MA      8.0   //  not the board's regulator or USB bridge), idle sleep,
+#define HOST_MCU_POWER_DOWN_MA 0.015 //  power-down with the watchdog on
+#define HOST_SD_US_PER_BYTE   2     //SPI at 8 MHz + SdFat overhead
+#define HOST_SD_SYNC_US       3000  //directory entry & FAT update
+#define HOST_SD_CREATE_US     3000  //new directory entry
+#define HOST_SD_ALLOC_US_PER_MB 8000  //FAT chain of 1 MB (32 KB clusters) found & written, or freed
+#define HOST_SD_ERASE_US      100000  //ERASE of a preallocated extent, until the card is ready again
+#define HOST_EEPROM_WRITE_US  3400  //erase + write of one EEPROM byte
+#define HOST_SPI_US_PER_BYTE  1     //SPI.transfer() at 8 MHz + call
+#define HOST_STACK_BYTES      8192  //FreeStack() with nothing on the stack (Mega: SRAM size)
+#define HOST_I2C_HZ           100000
+#define HOST_I2C_GENERAL_CALL 0x00
+#define HOST_START_UNIX       1792238400UL  //RTC at boot: 2026-10-17T12:00:00 (-t)
+
+/****************** STRUCTS, OBJECTS ********************/
+/*! What the firmware did to the outside world since boot */
+struct host_stats_t
+{
+  uint64_t serial_bytes[2];       //Serial, Serial1 TX
+  uint64_t serial_rx_bytes[2];    //sent by the device on the other end...
+  uint32_t serial_rx_lost[2];     //...and dropped: RX buffer full
+  uint64_t sd_bytes;              //handed to the card by File::write()
+  uint32_t sd_writes;
+  uint32_t sd_syncs;
+  uint32_t sd_failed;             //card calls that failed: card out (-c) or a handle from before
+  uint64_t idle_us;               //MCU asleep: idle (CPU clock off)...
+  uint64_t power_down_us;         //...powered down (all clocks off)
+  uint32_t i2c_transactions;
+  uint64_t i2c_bytes;
+  uint32_t i2c_nacks;
+  uint32_t i2c_timeouts;          //setWireTimeout() expired on a stuck bus
+  uint64_t i2c_stuck_us;          //time spent waiting on a stuck bus
+};
+
+/*! Injected I2C faults: NACK = the device drops off the bus,
+ *  STUCK = it holds SDA low, so every transaction on the bus hangs */
+enum host_fault_e
+{
+  HOST_FAULT_NONE,
+  HOST_FAULT_NACK,
+  HOST_FAULT_STUCK
+};
+
+/*! How far a model strays from its datasheet */
+struct host_profile_t
+{
+  float latency;                  //conversion/measurement time, x nominal
+  uint16_t noise;                 //+/- LSBs added to every result
+  uint32_t nack_ppm;              //random NACKs per million transactions
+};
+
+/****************** CLASSES ********************/
+/*! One I2C target. write() gets a master write (register pointer + data),
+ *  read() fills a master read; both return false to NACK. general_call() gets
+ *  a write to address 0x00 (true = ACK). TwoWire checks fault() first, so the
+ *  models only deal with their own registers */
+class Host_I2C_Device {
+  public:
+    Host_I2C_Device();
+    virtual ~Host_I2C_Device() {}
+    virtual bool write(const uint8_t *buf, uint8_t count) = 0;
+    virtual bool read(uint8_t *buf, uint8_t count) = 0;
+    virtual bool general_call(uint8_t cmd)        { (void)cmd; return false; }
+
+    void set_profile(const host_profile_t &p)     { profile = p; }
+    void inject(host_fault_e fault, uint64_t start_us, uint64_t length_us);
+    host_fault_e fault();
+    bool holds_bus();
+    uint64_t fault_end_us()                       { return fault_until_us; }
+
+  protected:
+    uint64_t scaled_us(uint64_t nominal_us);
+    int32_t noise();
+
+    host_profile_t profile;
+
+  private:
+    host_fault_e fault_type;
+    uint64_t fault_from_us;
+    uint64_t fault_until_us;
+    uint32_t rng;
+};
+
+/*! The far end of a UART. receive() gets each byte the firmware sends; send()
+ *  gives the next byte the device has finished sending by now (false = none yet);
+ *  report() adds its own line to the end-of-run report */
+class Host_UART_Device {
+  public:
+    virtual ~Host_UART_Device() {}
+    virtual void receive(uint8_t c) = 0;
+    virtual bool send(uint8_t &c) = 0;
+    virtual void report()                         {}
+};
+
+/*! An SPI target behind a chip select pin: select() follows the pin (LOW =
+ *  true), transfer() gets each byte the master clocks out and gives the reply */
+class Host_SPI_Device {
+  public:
+    virtual ~Host_SPI_Device() {}
+    virtual void select(bool selected) = 0;
+    virtual uint8_t transfer(uint8_t out) = 0;
+};
+
+/****************** FUNCTIONS ********************/
+uint64_t host_now_us();
+void host_advance_us(uint64_t us);
+void host_clock_ppm(int32_t ppm);
+void host_pin_wave(uint8_t pin, uint32_t period_us);
+void host_pin_pulse(uint8_t pin, uint32_t period_us, uint32_t low_us, uint64_t first_fall_us);
+host_stats_t &host_stats();
+
+void host_i2c_attach(uint8_t addr, Host_I2C_Device *device);
+Host_I2C_Device *host_i2c_device(uint8_t addr);
+void host_attach_default_devices();
+void host_rtc_start(uint32_t unix_s);
+bool host_i2c_fault(uint8_t addr, host_fault_e fault, double start_s, double length_s);
+bool host_i2c_profile(uint8_t addr, const host_profile_t &profile);
+void host_uart_attach(uint8_t port, Host_UART_Device *device);
+Host_UART_Device *host_uart_device(uint8_t port);
+void host_uart_noise(uint32_t bit_errors_ppm);
+void host_spi_attach(uint8_t cs_pin, Host_SPI_Device *device);
+
+bool host_wdt_expired();
+void host_stack_base(const void *base);
+bool host_eeprom_load(const char *path);
+bool host_eeprom_save(const char *path);
+bool host_eeprom_ready();
+
+void host_serial_echo(bool on);
+void host_set_sd_dir(const char *dir);
+const char *host_sd_dir();
+void host_sd_out(double start_s, double length_s);
+void host_sd_save();
+
+#endif //_HOST_HAL_H
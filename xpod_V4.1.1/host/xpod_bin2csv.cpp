@@ -0,0 +1,317 @@
+/*******************************************************************************
+ * @file    xpod_bin2csv.cpp
+ * @brief   Linux tool: converts a binary log (SD_BINARY_ENABLED, .BIN) into the
+ *          same CSV file the pod writes in text mode (header row + record_format_csv()).
+ *          Generic: every column (label, type, offset, scale) comes from the file header.
+ *          Packed logs (SD_BINARY_PACKED_ENABLED) are decoded block by block
+ *
+ *          usage: xpod_bin2csv MPOD00_2026_10_17.BIN [out.csv]   (default stdout)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "../record_format.h"
+
+/****************** OUTPUT (matches Arduino Print) ********************/
+static FILE *out;
+
+static void put(const char *s)    { fputs(s, out); }
+static void put_u(unsigned long v) { fprintf(out, "%lu", v); }
+static void put_i(long v)          { fprintf(out, "%ld", v); }
+
+// Print::printFloat(): double is 32 bit on AVR, so round & split in float too
+static void put_f(float number, uint8_t digits = 2)
+{
+  if (isnan(number))  { put("nan"); return; }
+  if (isinf(number))  { put("inf"); return; }
+  if (number > 4294967040.0f || number < -4294967040.0f)  { put("ovf"); return; }
+  if (number < 0.0f)  {
+    put("-");
+    number = -number;
+  } //if (number < 0.0f)
+
+  float rounding = 0.5f;
+  for (uint8_t i = 0; i < digits; ++i)
+    rounding /= 10.0f;
+  number += rounding;
+
+  unsigned long int_part = (unsigned long)number;
+  float remainder = number - (float)int_part;
+  put_u(int_part);
+  if (digits > 0)
+    put(".");
+  while (digits-- > 0)
+  {
+    remainder *= 10.0f;
+    unsigned int digit = (unsigned int)remainder;
+    put_u(digit);
+    remainder -= digit;
+  }
+} //static void put_f()
+
+/****************** RECORD ACCESS ********************/
+/*! v2 field table entry (1024 byte header, 8 bit offsets) */
+struct xpod_bin_field_v2_t
+{
+  char name[XPOD_BIN_NAME_LEN];
+  uint8_t type;
+  uint8_t offset;
+  uint8_t scale;
+  uint8_t valid;
+} __attribute__((packed));
+
+static xpod_bin_header_t header;
+static std::vector<xpod_bin_field_t> fields;
+static const uint8_t *rec;
+
+static uint32_t raw_at(const xpod_bin_field_t *f)
+{
+  const uint8_t *p = rec + f->offset;
+  switch (f->type)
+  {
+    case XPOD_BIN_U8:   return p[0];
+    case XPOD_BIN_U16:
+    case XPOD_BIN_I16:  return p[0] | (p[1] << 8);
+    default:            return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+} //static uint32_t raw_at()
+
+static uint8_t width_of(uint8_t type)
+{
+  return (type == XPOD_BIN_U8) ? 1 : (type == XPOD_BIN_U16 || type == XPOD_BIN_I16) ? 2 : 4;
+} //static uint8_t width_of()
+
+/****************** PACKED BLOCKS (record_format.h) ********************/
+/*! A stored field in record order: where it goes & how wide it is */
+struct packed_field_t
+{
+  uint16_t offset;
+  uint8_t width;
+  bool sign;                      //I16: sign extended before the delta
+};
+
+static std::vector<packed_field_t> packed;
+
+// Fields the pod codes per row: status, then every stored field by offset
+static size_t packed_layout()
+{
+  packed_field_t status = {XPOD_BIN_STATUS_AT, 1, false};
+  size_t bytes = XPOD_BIN_STATUS_AT + 1;
+  packed.assign(1, status);
+  for (size_t i = 0; i < fields.size(); i++)
+  {
+    if (fields[i].offset == XPOD_BIN_NOT_STORED)
+      continue;
+    packed_field_t f = {fields[i].offset, width_of(fields[i].type), fields[i].type == XPOD_BIN_I16};
+    packed.push_back(f);
+    bytes = std::max(bytes, (size_t)f.offset + f.width);
+  }
+  std::sort(packed.begin() + 1, packed.end(),
+            [](const packed_field_t &a, const packed_field_t &b) { return a.offset < b.offset; });
+  return bytes;
+} //static size_t packed_layout()
+
+static uint32_t get_bits(const uint8_t *r, const packed_field_t &f)
+{
+  uint32_t v = 0;
+  memcpy(&v, r + f.offset, f.width);        //little endian, like the AVR
+  if (f.sign && (v & 0x8000))
+    v |= 0xFFFF0000u;
+  return v;
+} //static uint32_t get_bits()
+
+/*! Decodes the next row of a block into row (holding the row before, zeros
+ *  before the first); false if the block ends inside it */
+static bool unpack_row(const uint8_t *block, size_t *pos, uint8_t *row)
+{
+  for (size_t i = 0; i < packed.size(); i++)
+  {
+    uint32_t z = 0;
+    for (int shift = 0; ; shift += 7)
+    {
+      if (*pos >= XPOD_BIN_BLOCK_BYTES || shift > 28)
+        return false;
+      uint8_t b = block[(*pos)++];
+      z |= (uint32_t)(b & 0x7F) << shift;
+      if (!(b & 0x80))
+        break;
+    }
+    uint32_t v = get_bits(row, packed[i]) + xpod_unzigzag(z);
+    memcpy(row + packed[i].offset, &v, packed[i].width);
+  }
+  return true;
+} //static bool unpack_row()
+
+/****************** CSV (same columns as record_format_csv) ********************/
+static const float POW10[] = {1.0f, 10.0f, 100.0f, 1000.0f};
+
+static void print_value(const xpod_bin_field_t *f)
+{
+  uint32_t raw = raw_at(f);
+  float scale = POW10[f->scale & 3];
+  switch (f->type)
+  {
+    case XPOD_BIN_TIME:  {
+      // unixtime() of a local DateTime - gmtime() gives back the same fields
+      time_t t = raw;
+      struct tm tm;
+      gmtime_r(&t, &tm);
+      fprintf(out, "%04u-%02u-%02uT%02u:%02u:%02u", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+              tm.tm_hour, tm.tm_min, tm.tm_sec);
+      break;
+    }
+    case XPOD_BIN_F32:  {
+      float v;
+      memcpy(&v, &raw, sizeof(v));
+      put_f(f->scale ? v / scale : v);
+      break;
+    }
+    case XPOD_BIN_I16:
+      if (f->scale)
+        put_f((int16_t)raw / scale);
+      else
+        put_i((int16_t)raw);
+      break;
+    default:
+      if (f->scale)
+        put_f((float)raw / scale);
+      else
+        put_u(raw);
+      break;
+  }
+} //static void print_value()
+
+static void print_labels()
+{
+  for (size_t i = 0; i < fields.size(); i++)
+  {
+    std::string n(fields[i].name, XPOD_BIN_NAME_LEN);
+    n.erase(n.find_last_not_of(' ') + 1);
+    fprintf(out, "%s,", n.c_str());
+  }
+} //static void print_labels()
+
+static void print_row()
+{
+  uint8_t status = rec[XPOD_BIN_STATUS_AT];
+  put("\r\n");
+  for (size_t i = 0; i < fields.size(); i++)
+  {
+    const xpod_bin_field_t *f = &fields[i];
+    if (f->offset != XPOD_BIN_NOT_STORED && (status & f->valid) == f->valid)
+      print_value(f);
+    put(",");
+  }
+} //static void print_row()
+
+/***************************************************************************************/
+int main(int argc, char **argv)
+{
+  if (argc < 2)  {
+    fprintf(stderr, "usage: %s LOG.BIN [out.csv]\n", argv[0]);
+    return 2;
+  } //if (argc < 2)
+
+  FILE *in = fopen(argv[1], "rb");
+  if (in == NULL)  {
+    perror(argv[1]);
+    return 1;
+  } //if (in == NULL)
+  out = (argc > 2) ? fopen(argv[2], "wb") : stdout;
+  if (out == NULL)  {
+    perror(argv[2]);
+    return 1;
+  } //if (out == NULL)
+
+  std::vector<uint8_t> block(sizeof(header));
+  if (fread(&header, 1, sizeof(header), in) != sizeof(header) ||
+      strncmp(header.magic, XPOD_BIN_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version < 2 || header.version > XPOD_BIN_VERSION || header.record_bytes == 0)  {
+    fprintf(stderr, "%s: not an XPOD binary log (v2-v%u)\n", argv[1], XPOD_BIN_VERSION);
+    return 1;
+  } //if (bad header)
+
+  // Field table right after the fixed part; v2 had a fixed 1024 byte header & 8 bit offsets
+  size_t header_bytes = (header.version == 2) ? 1024 : header.header_bytes;
+  size_t entry_bytes = (header.version == 2) ? sizeof(xpod_bin_field_v2_t) : sizeof(xpod_bin_field_t);
+  if (sizeof(header) + header.field_count * entry_bytes > header_bytes)  {
+    fprintf(stderr, "%s: field table bigger than the header\n", argv[1]);
+    return 1;
+  } //if (field table too big)
+  block.resize(header_bytes - sizeof(header));
+  if (fread(block.data(), 1, block.size(), in) != block.size())  {
+    fprintf(stderr, "%s: short header\n", argv[1]);
+    return 1;
+  } //if (fread(...) != block.size())
+  fields.resize(header.field_count);
+  for (size_t i = 0; i < fields.size(); i++)
+  {
+    if (header.version == 2)  {
+      xpod_bin_field_v2_t v2;
+      memcpy(&v2, &block[i * entry_bytes], sizeof(v2));
+      memcpy(fields[i].name, v2.name, XPOD_BIN_NAME_LEN);
+      fields[i].type = v2.type;
+      fields[i].scale = v2.scale;
+      fields[i].valid = v2.valid;
+      fields[i].offset = (v2.offset == 0xFF) ? XPOD_BIN_NOT_STORED : v2.offset;
+    } else {
+      memcpy(&fields[i], &block[i * entry_bytes], sizeof(xpod_bin_field_t));
+    }
+  }
+
+  print_labels();
+  bool is_packed = header.version >= 4 && header.packing == XPOD_BIN_PACK_DELTA;
+  uint8_t sync = is_packed ? XPOD_BIN_BLOCK_SYNC : XPOD_BIN_SYNC;
+  std::vector<uint8_t> row(is_packed ? packed_layout() : 0);
+  unsigned long rows = 0, skipped = 0, blocks = 0;
+  block.resize(header.record_bytes);
+  rec = is_packed ? row.data() : block.data();
+  while (fread(block.data(), 1, block.size(), in) == block.size())
+  {
+    if (block[0] == 0x00 || block[0] == 0xFF)
+      break;                          //erased tail of the preallocated file
+    if (block[0] != sync)  {
+      skipped++;
+      continue;
+    } //if (block[0] != sync)
+    if (!is_packed)  {
+      print_row();
+      rows++;
+      continue;
+    } //if (!is_packed)
+
+    // Packed: the block's rows, the first against zeros
+    size_t pos = XPOD_BIN_BLOCK_HEAD;
+    std::fill(row.begin(), row.end(), 0);
+    for (uint8_t n = 0; n < block[1]; n++)
+    {
+      if (!unpack_row(block.data(), &pos, row.data()))  {
+        skipped++;                    //corrupt block: the rest of it is lost
+        break;
+      } //if (!unpack_row(...))
+      print_row();
+      rows++;
+    }
+    blocks++;
+  }
+
+  if (is_packed)
+    fprintf(stderr, "%.8s: %lu rows in %lu packed blocks (%.1f B/row), %lu skipped\n", header.pod_id,
+            rows, blocks, rows ? (double)blocks * XPOD_BIN_BLOCK_BYTES / rows : 0.0, skipped);
+  else
+    fprintf(stderr, "%.8s: %lu rows (%u B/record), %lu skipped\n", header.pod_id, rows,
+            header.record_bytes, skipped);
+  fclose(in);
+  if (out != stdout)
+    fclose(out);
+  return 0;
+} //int main()
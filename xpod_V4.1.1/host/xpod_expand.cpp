@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * @file    xpod_expand.cpp
+ * @brief   Linux tool: expands a change-based CSV log (SD_DEADBAND_ENABLED) into
+ *          the dense table: every "=" column, and every column missing at the end
+ *          of a row, takes the text that column had in the row before. A dense
+ *          file comes out unchanged
+ *
+ *          usage: xpod_expand MPOD00_2026_10_17.CSV [out.csv]   (default stdout)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/****************** ROWS ********************/
+// Cells of one line: the text between ','s - a trailing ',' ends the last one
+static void split(const std::string &line, std::vector<std::string> &cells)
+{
+  cells.clear();
+  size_t from = 0;
+  for (size_t at; (at = line.find(',', from)) != std::string::npos; from = at + 1)
+    cells.push_back(line.substr(from, at - from));
+  if (from < line.size())
+    cells.push_back(line.substr(from));
+} //static void split()
+
+// Reads up to the next "\r\n" (the pod starts every row with one); the erased
+// tail of a preallocated file (0xFF) and padding (0x00) are not text
+static bool read_line(FILE *in, std::string &line)
+{
+  int c;
+  line.clear();
+  while ((c = fgetc(in)) != EOF)
+  {
+    if (c == '\n')
+      return true;
+    if (c != '\r' && c != 0xFF && c != 0x00)
+      line += (char)c;
+  }
+  return !line.empty();
+} //static bool read_line()
+
+/***************************************************************************************/
+int main(int argc, char **argv)
+{
+  if (argc < 2)  {
+    fprintf(stderr, "usage: %s LOG.CSV [out.csv]\n", argv[0]);
+    return 2;
+  } //if (argc < 2)
+
+  FILE *in = fopen(argv[1], "rb");
+  if (in == NULL)  {
+    perror(argv[1]);
+    return 1;
+  } //if (in == NULL)
+  FILE *out = (argc > 2) ? fopen(argv[2], "wb") : stdout;
+  if (out == NULL)  {
+    perror(argv[2]);
+    return 1;
+  } //if (out == NULL)
+
+  std::string line;
+  std::vector<std::string> cells, last;
+  if (!read_line(in, line))  {
+    fprintf(stderr, "%s: empty\n", argv[1]);
+    return 1;
+  } //if (!read_line(in, line))
+  fputs(line.c_str(), out);             //labels: one per column, each ending in ','
+  split(line, last);
+  size_t columns = last.size();
+  last.assign(columns, "");
+
+  unsigned long rows = 0, filled = 0, torn = 0;
+  while (read_line(in, line))
+  {
+    if (line.empty())
+      continue;
+    if (line[line.size() - 1] != ',')  {
+      torn++;                         //every row ends in ',': power cut mid-row
+      continue;
+    } //if (no trailing ',')
+    split(line, cells);
+    if (cells.size() > columns)  {
+      fprintf(stderr, "%s: row %lu has %zu columns, header %zu\n", argv[1], rows + 1,
+              cells.size(), columns);
+      return 1;
+    } //if (cells.size() > columns)
+    fputs("\r\n", out);
+    for (size_t i = 0; i < columns; i++)
+    {
+      if (i < cells.size() && cells[i] != "=")
+        last[i] = cells[i];
+      else
+        filled++;
+      fputs(last[i].c_str(), out);
+      fputc(',', out);
+    }
+    rows++;
+  }
+
+  fprintf(stderr, "%lu rows, %zu columns: %lu of %lu cells carried on, %lu torn rows dropped\n",
+          rows, columns, filled, rows * columns, torn);
+  fclose(in);
+  if (out != stdout)
+    fclose(out);
+  return 0;
+} //int main()
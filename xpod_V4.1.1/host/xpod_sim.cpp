@@ -0,0 +1,244 @@
+/*******************************************************************************
+ * @file    xpod_sim.cpp
+ * @brief   Linux build of the whole sketch (xpod_V4.1.1.ino + modules + the real
+ *          sensor libraries) against the host HAL (hal/): runs setup() & loop()
+ *          for a span of virtual time, then reports loop cycle time and what
+ *          was written to the card, the UARTs and the I2C bus
+ *
+ *          usage: xpod_sim [seconds] [sd_dir] [-q] [-f ...] [-p ...] [-n PPM] [-e FILE] [-r CAUSE] [-t TIME] [-c ...] [-d PPM]
+ *            seconds   virtual time to run (default 120)
+ *            sd_dir    where the card's files go (default ./sd)
+ *            -q        no Serial echo
+ *            -f ADDR:nack|stuck:START_S:LENGTH_S   inject a fault into the device at ADDR (hex)
+ *            -p ADDR:LATENCY:NOISE[:NACK_PPM]      its profile (x datasheet time, +/- LSBs, random NACKs)
+ *            -n PPM    line noise on the UARTs' RX: flipped bits per million bytes (PMS checksum drops)
+ *            -e FILE   EEPROM image: loaded at boot (missing = erased), saved at the end
+ *            -r CAUSE  reset cause in MCUSR at boot: por (default), ext, bor, wdt
+ *            -t TIME   RTC at boot: HH:MM:SS on 2026-10-17, or YYYY-MM-DDTHH:MM:SS (UTC)
+ *            -c START_S:LENGTH_S   SD card out of its slot for that long (repeatable)
+ *            -d PPM    the Mega's crystal off by that much vs the RTC (millis()/micros() drift)
+ *
+ * @cite    fake Wire/micros idea from libraries/MCP342x/test
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include <sys/stat.h>
+#include <time.h>
+#include <chrono>
+
+#include "Arduino.h"
+#include "host_hal.h"
+
+void setup();
+void loop();
+
+/****************** LOOP TIMING ********************/
+// loop() durations in powers of 2 us: [0] < 2 us ... [20] >= 1 s
+#define SIM_BUCKETS           21
+
+static uint64_t loops;
+static uint64_t loop_max_us;
+static uint64_t loop_max_at_us;   //when the slowest loop() started
+static uint64_t busy_loops;       //loops that did more than check the clock
+static uint64_t busy_us;
+static uint64_t bucket[SIM_BUCKETS];
+
+static void count_loop(uint64_t start_us, uint64_t us)
+{
+  loops++;
+  if (us > loop_max_us)  {
+    loop_max_us = us;
+    loop_max_at_us = start_us;
+  } //if (us > loop_max_us)
+  if (us > 2 * HOST_CLOCK_READ_US)  {
+    busy_loops++;
+    busy_us += us;
+  } //if (more than a clock read)
+  uint8_t b = 0;
+  while (b < SIM_BUCKETS - 1 && us >= (2ULL << b))
+    b++;
+  bucket[b]++;
+} //static void count_loop()
+
+static void report(double seconds, double wall_s)
+{
+  const host_stats_t &st = host_stats();
+  fprintf(stderr, "\n[sim] %.1f s virtual in %.2f s wall, %llu loop() calls\n", seconds, wall_s,
+          (unsigned long long)loops);
+  fprintf(stderr, "[sim] loop: %llu busy, mean %.0f us, max %llu us (at %.3f s); %.1f%% CPU busy\n",
+          (unsigned long long)busy_loops, busy_loops ? (double)busy_us / busy_loops : 0.0,
+          (unsigned long long)loop_max_us, loop_max_at_us / 1e6, 100.0 * busy_us / (seconds * 1e6));
+  fprintf(stderr, "[sim] loop histogram (us):");
+  for (int b = 0; b < SIM_BUCKETS; b++)
+  {
+    if (bucket[b])
+      fprintf(stderr, " <%llu:%llu", 2ULL << b, (unsigned long long)bucket[b]);
+  }
+  fprintf(stderr, "\n[sim] SD: %llu bytes in %u writes, %u syncs (%.0f B/min), %u failed calls\n",
+          (unsigned long long)st.sd_bytes, st.sd_writes, st.sd_syncs, st.sd_bytes * 60.0 / seconds,
+          st.sd_failed);
+  fprintf(stderr, "[sim] Serial: %llu bytes, Serial1: %llu bytes; Serial1 RX: %llu bytes, %u lost (buffer full)\n",
+          (unsigned long long)st.serial_bytes[0], (unsigned long long)st.serial_bytes[1],
+          (unsigned long long)st.serial_rx_bytes[1], st.serial_rx_lost[1]);
+  fprintf(stderr, "[sim] I2C: %u transactions, %llu bytes, %u NACKs, %u timeouts, %.1f ms stuck\n",
+          st.i2c_transactions, (unsigned long long)st.i2c_bytes, st.i2c_nacks, st.i2c_timeouts,
+          st.i2c_stuck_us / 1000.0);
+  double idle_s = st.idle_us / 1e6, down_s = st.power_down_us / 1e6;
+  double active_s = seconds - idle_s - down_s;
+  double mcu_mAh = (active_s * HOST_MCU_ACTIVE_MA + idle_s * HOST_MCU_IDLE_MA + down_s * HOST_MCU_POWER_DOWN_MA) / 3600;
+  fprintf(stderr, "[sim] MCU: %.1f%% running, %.1f%% idle, %.1f%% powered down: %.2f mA mean, %.3f mAh\n",
+          100 * active_s / seconds, 100 * idle_s / seconds, 100 * down_s / seconds, mcu_mAh * 3600 / seconds, mcu_mAh);
+  if (st.serial_rx_bytes[1] && host_uart_device(1) != NULL)
+    host_uart_device(1)->report();
+} //static void report()
+
+/****************** OPTIONS ********************/
+// -f 0x48:nack:30:5
+static bool parse_fault(const char *arg)
+{
+  unsigned addr;
+  char type[8];
+  double start_s, length_s;
+  if (sscanf(arg, "%x:%7[a-z]:%lf:%lf", &addr, type, &start_s, &length_s) != 4)
+    return false;
+  host_fault_e fault = (strcmp(type, "stuck") == 0) ? HOST_FAULT_STUCK :
+                       (strcmp(type, "nack") == 0) ? HOST_FAULT_NACK : HOST_FAULT_NONE;
+  return fault != HOST_FAULT_NONE && host_i2c_fault(addr, fault, start_s, length_s);
+} //static bool parse_fault()
+
+// -p 0x76:1.2:10:500
+static bool parse_profile(const char *arg)
+{
+  unsigned addr, noise, nack_ppm = 0;
+  float latency;
+  if (sscanf(arg, "%x:%f:%u:%u", &addr, &latency, &noise, &nack_ppm) < 3)
+    return false;
+  host_profile_t profile = {latency, (uint16_t)noise, nack_ppm};
+  return host_i2c_profile(addr, profile);
+} //static bool parse_profile()
+
+// -r wdt
+static bool parse_reset(const char *arg)
+{
+  static const char *const cause[] = {"por", "ext", "bor", "wdt", "jtag"};
+  for (uint8_t bit = 0; bit < 5; bit++)
+  {
+    if (strcmp(arg, cause[bit]) == 0)  {
+      MCUSR = 1 << bit;
+      return true;
+    } //if (strcmp(arg, cause[bit]) == 0)
+  }
+  return false;
+} //static bool parse_reset()
+
+// -t 23:58:30 or -t 2026-12-31T23:59:00
+static bool parse_time(const char *arg)
+{
+  int year = 2026, mon = 10, day = 17, hour, min, sec;
+  if (sscanf(arg, "%d-%d-%dT%d:%d:%d", &year, &mon, &day, &hour, &min, &sec) != 6)  {
+    year = 2026;  mon = 10;  day = 17;
+    if (sscanf(arg, "%d:%d:%d", &hour, &min, &sec) != 3)
+      return false;
+  } //if (not date & time)
+  struct tm tm;
+  memset(&tm, 0, sizeof(tm));
+  tm.tm_year = year - 1900;  tm.tm_mon = mon - 1;  tm.tm_mday = day;
+  tm.tm_hour = hour;  tm.tm_min = min;  tm.tm_sec = sec;
+  time_t t = timegm(&tm);
+  if (t < 946684800)              //the DS3231 counts from 2000
+    return false;
+  host_rtc_start((uint32_t)t);
+  return true;
+} //static bool parse_time()
+
+// -c 30:60
+static bool parse_card_out(const char *arg)
+{
+  double start_s, length_s;
+  if (sscanf(arg, "%lf:%lf", &start_s, &length_s) != 2 || start_s < 0 || length_s <= 0)
+    return false;
+  host_sd_out(start_s, length_s);
+  return true;
+} //static bool parse_card_out()
+
+/***************************************************************************************/
+int main(int argc, char **argv)
+{
+  double seconds = 120;
+  const char *dir = "sd";
+  const char *eeprom_file = NULL;
+  int arg = 0;
+  host_stack_base(__builtin_frame_address(0));
+  host_attach_default_devices();
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-q") == 0)  {
+      host_serial_echo(false);
+    } else if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "-p") == 0)  {
+      bool ok = (i + 1 < argc) && ((argv[i][1] == 'f') ? parse_fault(argv[i + 1]) : parse_profile(argv[i + 1]));
+      if (!ok)  {
+        fprintf(stderr, "%s: bad %s %s (no device there?)\n", argv[0], argv[i], (i + 1 < argc) ? argv[i + 1] : "");
+        return 2;
+      } //if (!ok)
+      i++;
+    } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)  {
+      host_clock_ppm(strtol(argv[++i], NULL, 0));
+    } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)  {
+      host_uart_noise(strtoul(argv[++i], NULL, 0));
+    } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)  {
+      eeprom_file = argv[++i];
+      host_eeprom_load(eeprom_file);
+    } else if (strcmp(argv[i], "-r") == 0)  {
+      if (i + 1 >= argc || !parse_reset(argv[i + 1]))  {
+        fprintf(stderr, "%s: bad -r %s (por, ext, bor, wdt, jtag)\n", argv[0], (i + 1 < argc) ? argv[i + 1] : "");
+        return 2;
+      } //if (bad cause)
+      i++;
+    } else if (strcmp(argv[i], "-t") == 0)  {
+      if (i + 1 >= argc || !parse_time(argv[i + 1]))  {
+        fprintf(stderr, "%s: bad -t %s (HH:MM:SS or YYYY-MM-DDTHH:MM:SS)\n", argv[0], (i + 1 < argc) ? argv[i + 1] : "");
+        return 2;
+      } //if (bad time)
+      i++;
+    } else if (strcmp(argv[i], "-c") == 0)  {
+      if (i + 1 >= argc || !parse_card_out(argv[i + 1]))  {
+        fprintf(stderr, "%s: bad -c %s (START_S:LENGTH_S)\n", argv[0], (i + 1 < argc) ? argv[i + 1] : "");
+        return 2;
+      } //if (bad window)
+      i++;
+    } else if (arg++ == 0)  {
+      seconds = atof(argv[i]);
+    } else {
+      dir = argv[i];
+    } //if (option)
+  }
+  mkdir(dir, 0755);
+  host_set_sd_dir(dir);
+
+  auto wall0 = std::chrono::steady_clock::now();
+  setup();
+  uint64_t end_us = host_now_us() + (uint64_t)(seconds * 1e6);
+  while (host_now_us() < end_us)
+  {
+    uint64_t t0 = host_now_us();
+    uint64_t slept0 = host_stats().idle_us + host_stats().power_down_us;
+    loop();
+    uint64_t slept_us = host_stats().idle_us + host_stats().power_down_us - slept0;
+    count_loop(t0, host_now_us() - t0 - slept_us);
+    if (host_wdt_expired())  {
+      fprintf(stderr, "\n[sim] watchdog reset at %.3f s: loop() ran %.0f ms\n", host_now_us() / 1e6,
+              (host_now_us() - t0) / 1000.0);
+      seconds = (host_now_us() - (end_us - (uint64_t)(seconds * 1e6))) / 1e6;
+      break;
+    } //if (host_wdt_expired())
+  }
+  fflush(stdout);
+  host_sd_save();
+  if (eeprom_file && !host_eeprom_save(eeprom_file))
+    fprintf(stderr, "%s: can't save EEPROM to %s\n", argv[0], eeprom_file);
+
+  double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+  report(seconds, wall_s);
+  return 0;
+} //int main()
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * @file    profile_module.cpp
+ * @brief   Hot-path profiler (PROFILE_ENABLED): per-stage n/min/mean/max of
+ *          the micros() spent in each PROFILE_SCOPE() over a window
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include "profile_module.h"
+
+#if PROFILE_ENABLED
+  Profiler profiler;
+#endif //PROFILE_ENABLED
+
+#define PROFILE_LABEL(stage, label)   label,
+static const char *const profile_label[PROFILE_STAGE_COUNT] = { PROFILE_STAGES(PROFILE_LABEL) };
+
+/**************************************************************************/
+ /*!
+ *    @brief  Empty window
+ */
+/**************************************************************************/
+Profiler::Profiler()
+{
+  reset();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Forgets every stage's calls (start of the next window)
+ */
+/**************************************************************************/
+void Profiler::reset()
+{
+  memset(stat, 0, sizeof(stat));
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Folds one timed call in
+ *        @param  stage  what was timed
+ *        @param  us     how long it took
+ */
+/**************************************************************************/
+void Profiler::add(profile_stage_e stage, uint32_t us)
+{
+  profile_stat_t *s = &stat[stage];
+  if (s->n == 0xFFFF)
+    return;
+  if (s->n == 0 || us < s->min_us)
+    s->min_us = us;
+  if (us > s->max_us)
+    s->max_us = us;
+  s->sum_us += us;
+  s->n++;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return calls of the stage timed this window
+ */
+/**************************************************************************/
+uint16_t Profiler::count(profile_stage_e stage)
+{
+  return stat[stage].n;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return mean time of one call (us, 0 if none)
+ */
+/**************************************************************************/
+uint32_t Profiler::mean(profile_stage_e stage)
+{
+  return stat[stage].n ? stat[stage].sum_us / stat[stage].n : 0;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return quickest call (us, 0 if none)
+ */
+/**************************************************************************/
+uint32_t Profiler::minimum(profile_stage_e stage)
+{
+  return stat[stage].min_us;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return slowest call (us, 0 if none)
+ */
+/**************************************************************************/
+uint32_t Profiler::maximum(profile_stage_e stage)
+{
+  return stat[stage].max_us;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Prints one "#prof,stage,n,min,mean,max" line (us) per stage that
+ *            ran this window, then starts the next window
+ *        @param  out  where to print (Serial)
+ */
+/**************************************************************************/
+void Profiler::report(Print &out)
+{
+  for (int i = 0; i < PROFILE_STAGE_COUNT; i++)
+  {
+    profile_stage_e stage = (profile_stage_e)i;
+    if (stat[i].n == 0)
+      continue;
+    out.println();
+    out.print(F("#prof,"));
+    out.print(profile_label[i]);
+    out.print(F(","));
+    out.print(count(stage));
+    out.print(F(","));
+    out.print(minimum(stage));
+    out.print(F(","));
+    out.print(mean(stage));
+    out.print(F(","));
+    out.print(maximum(stage));
+  }
+  reset();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Starts timing a stage (PROFILE_SCOPE())
+ *        @param  stage  stage the enclosing block belongs to
+ */
+/**************************************************************************/
+Profile_Scope::Profile_Scope(profile_stage_e stage) : stage(stage)
+{
+  t0 = micros();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  End of the block: hands the elapsed time to the profiler
+ */
+/**************************************************************************/
+Profile_Scope::~Profile_Scope()
+{
+  #if PROFILE_ENABLED
+    profiler.add(stage, micros() - t0);
+  #endif //PROFILE_ENABLED
+}
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * @file    profile_module.h
+ * @brief   Hot-path profiler (PROFILE_ENABLED): PROFILE_SCOPE(stage) times the
+ *          rest of its block with micros() and folds it into that stage's
+ *          n/min/mean/max for the current window. Logged per row as columns
+ *          (PROFILE_COLUMNS_ENABLED) or as "#prof," lines every PROFILE_REPORT_MS.
+ *          Disabled, PROFILE_SCOPE() compiles to nothing
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _PROFILE_MODULE_H
+#define _PROFILE_MODULE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "xpod_node.h"
+
+/****************** STRUCTS, OBJECTS ********************/
+// X(stage, label): one timed stage of the loop, in report order
+#define PROFILE_STAGES(X) \
+  X(RTC,       "rtc")       /*rtc.now()*/                                  \
+  X(VOLT,      "volt")      /*analogRead(IN_VOLT_PIN)*/                    \
+  X(ADS,       "ads")       /*each ADS start/poll/collect step*/           \
+  X(CO2,       "co2")       /*getS300CO2()*/                               \
+  X(BME,       "bme")       /*each BME start/poll/collect step*/           \
+  X(QUAD,      "quad")      /*each Quadstat start/poll/collect step*/      \
+  X(PMS,       "pms")       /*PMS request / UART drain*/                   \
+  X(ROW,       "row")       /*encode + format the row*/                    \
+  X(SD_OPEN,   "sd_open")   /*mount/open the day's file (+ header)*/       \
+  X(SD_WRITE,  "sd_write")  /*a write to the card (a sector, or the row)*/ \
+  X(SD_SYNC,   "sd_sync")   /*flush + directory entry update*/             \
+  X(SD_CLOSE,  "sd_close")  /*close (+ truncate)*/                         \
+  X(SERIAL_OUT, "serial")   /*row out of Serial*/
+
+#define PROFILE_ENUM(stage, label)    PROF_##stage,
+/*! Index of each timed stage */
+enum profile_stage_e
+{
+  PROFILE_STAGES(PROFILE_ENUM)
+  PROFILE_STAGE_COUNT
+}; //enum profile_stage_e
+
+/*! One stage's calls in the window - 14 bytes */
+struct profile_stat_t
+{
+  uint16_t n;                 //stops at 0xFFFF
+  uint32_t sum_us;
+  uint32_t min_us;
+  uint32_t max_us;
+};
+
+/****************** CLASSES ********************/
+/*! Per-stage timing of the current window */
+class Profiler {
+  public:
+    Profiler();
+    void reset();
+    void add(profile_stage_e stage, uint32_t us);
+
+    uint16_t count(profile_stage_e stage);
+    uint32_t mean(profile_stage_e stage);
+    uint32_t minimum(profile_stage_e stage);
+    uint32_t maximum(profile_stage_e stage);
+    void report(Print &out);
+
+  private:
+    profile_stat_t stat[PROFILE_STAGE_COUNT];
+};
+
+/*! Times its own lifetime (the rest of the enclosing block) */
+class Profile_Scope {
+  public:
+    Profile_Scope(profile_stage_e stage);
+    ~Profile_Scope();
+
+  private:
+    profile_stage_e stage;
+    uint32_t t0;
+};
+
+#if PROFILE_ENABLED
+  extern Profiler profiler;
+  #define PROFILE_SCOPE(stage)        Profile_Scope profile_scope(PROF_##stage)
+#else
+  #define PROFILE_SCOPE(stage)
+#endif //PROFILE_ENABLED
+
+#endif //_PROFILE_MODULE_H
@@ -17,6 +17,9 @@
 QUAD_Module::QUAD_Module()
 {
   status = true;
+  memset(frame, 0, sizeof(frame));
+  frame_index = 2 * MCP342x::numChannels;
+  pending = 0;
 }
 
 /**************************************************************************/
@@ -92,4 +95,137 @@ QUAD_Data QUAD_Module::return_updated()
   dataset.QS4_C2 = value_smallguy;
 
   return dataset;
-}
\ No newline at end of file
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Starts the one-shot conversion(s) for frame_index without waiting.
+ *            Lockstep: both boards get the channel written (configure() doesn't
+ *            start anything) and one general call starts them together.
+ *            Otherwise: alpha_one ch1-4, then alpha_two ch1-4, one at a time.
+ */
+/**************************************************************************/
+void QUAD_Module::start_conversion()
+{
+  static const MCP342x::Channel channels[MCP342x::numChannels] = {
+    MCP342x::channel1, MCP342x::channel2, MCP342x::channel3, MCP342x::channel4
+  };
+
+  #if QUAD_LOCKSTEP_ENABLED
+    MCP342x::Config config(channels[frame_index], MCP342x::oneShot, 
+                           MCP342x::resolution16, MCP342x::gain1);
+    if (alpha_one.configure(config) != MCP342x::errorNone)
+      HEALTH_COUNT(I2C_QUAD);
+    if (alpha_two.configure(config) != MCP342x::errorNone)
+      HEALTH_COUNT(I2C_QUAD);
+    if (MCP342x::generalCallConversion() != 0)
+      HEALTH_COUNT(I2C_QUAD);
+    pending = 0x03;
+  #else
+    MCP342x &adc = (frame_index < MCP342x::numChannels) ? alpha_one : alpha_two;
+    if (adc.convert(channels[frame_index % MCP342x::numChannels], MCP342x::oneShot, 
+                    MCP342x::resolution16, MCP342x::gain1) != MCP342x::errorNone)
+      HEALTH_COUNT(I2C_QUAD);
+  #endif //QUAD_LOCKSTEP_ENABLED
+  conversion_us = micros();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Begins a new frame by starting channel 1 (on both boards in lockstep)
+ */
+/**************************************************************************/
+void QUAD_Module::start()
+{
+  frame_index = 0;
+  start_conversion();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Reads the conversion(s) in flight once the conversion time has passed;
+ *            stores them and starts the next channel. A channel not ready within
+ *            1 s keeps its previous value (same timeout as convertAndRead).
+ *    @return True once all 8 channels of the frame are done
+ */
+/**************************************************************************/
+bool QUAD_Module::poll()
+{
+  #if QUAD_LOCKSTEP_ENABLED
+    while (frame_index < MCP342x::numChannels)
+    {
+      uint32_t waited_us = micros() - conversion_us;
+      if (waited_us < MCP342x::resolution16.getConversionTime())
+        return false;
+
+      for (uint8_t board = 0; board < 2; board++)
+      {
+        if (!(pending & (1 << board)))
+          continue;
+        MCP342x &adc = (board == 0) ? alpha_one : alpha_two;
+        MCP342x::Config config;
+        long value = 0;
+        if (adc.read(value, config) == MCP342x::errorNone && config.isReady())  {
+          frame[board * MCP342x::numChannels + frame_index] = value;
+          pending &= ~(1 << board);
+        } //if (adc.read(value, config) == MCP342x::errorNone && config.isReady())
+      }
+      if (pending && waited_us < 1000000)
+        return false;
+      if (pending & 0x01)
+        HEALTH_COUNT(I2C_QUAD);
+      if (pending & 0x02)
+        HEALTH_COUNT(I2C_QUAD);
+
+      frame_index++;
+      if (frame_index < MCP342x::numChannels)
+        start_conversion();
+    } //while (frame_index < MCP342x::numChannels)
+  #else
+    while (frame_index < 2 * MCP342x::numChannels)
+    {
+      uint32_t waited_us = micros() - conversion_us;
+      if (waited_us < MCP342x::resolution16.getConversionTime())
+        return false;
+
+      MCP342x &adc = (frame_index < MCP342x::numChannels) ? alpha_one : alpha_two;
+      MCP342x::Config config;
+      long value = 0;
+      MCP342x::error_t err = adc.read(value, config);
+      if (err == MCP342x::errorNone && config.isReady())  {
+        frame[frame_index] = value;
+      } else if (waited_us < 1000000)  {
+        return false;
+      } else {
+        HEALTH_COUNT(I2C_QUAD);
+      } //if (err == MCP342x::errorNone && config.isReady())
+
+      frame_index++;
+      if (frame_index < 2 * MCP342x::numChannels)
+        start_conversion();
+    } //while (frame_index < 2 * MCP342x::numChannels)
+  #endif //QUAD_LOCKSTEP_ENABLED
+
+  return true;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Returns the finished frame (call once poll() is true)
+ *    @return QUAD_Data structured dataset
+ */
+/**************************************************************************/
+QUAD_Data QUAD_Module::collect()
+{
+  QUAD_Data dataset;
+  dataset.QS1_C1 = frame[0];
+  dataset.QS1_C2 = frame[1];
+  dataset.QS2_C1 = frame[2];
+  dataset.QS2_C2 = frame[3];
+  dataset.QS3_C1 = frame[4];
+  dataset.QS3_C2 = frame[5];
+  dataset.QS4_C1 = frame[6];
+  dataset.QS4_C2 = frame[7];
+
+  return dataset;
+}
@@ -15,6 +15,7 @@
 #include <MCP342x.h>
 
 #include "xpod_node.h"
+#include "health_module.h"
 
 /****************** STRUCTS, OBJECTS ********************/
 /*! Quad data structure (ALL DATA) as respective datatypes */
@@ -38,10 +39,22 @@ class QUAD_Module
 
     QUAD_Data return_updated();
 
+    // Non-blocking frame for the scheduler: start() -> poll() until true -> collect()
+    void start();
+    bool poll();
+    QUAD_Data collect();
+
   private:
+    void start_conversion();
+
     MCP342x alpha_one;
     MCP342x alpha_two;
     bool status;
+
+    int16_t frame[2 * MCP342x::numChannels];   //QS1_C1 .. QS4_C2 in QUAD_Data order
+    uint8_t frame_index;                       //conversion in flight (8 = done; lockstep: channel, 4 = done)
+    uint32_t conversion_us;                    //micros() the conversion was started
+    uint8_t pending;                           //lockstep: boards not read yet (bit0 one, bit1 two)
 };
 
 #endif //_QUAD_Module_H
\ No newline at end of file
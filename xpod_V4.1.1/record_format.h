@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * @file    record_format.h
+ * @brief   On-card layout of the binary log (.BIN): one self-describing header
+ *          (fixed part + field table, padded to whole sectors) followed by
+ *          fixed-size, power-of-2 packed records - or (header packing
+ *          XPOD_BIN_PACK_DELTA) by 512 byte blocks of delta coded rows.
+ *          Plain C++ only - shared by the sketch and the host tools
+ *
+ * @cite    data_t record idea from SdFat's ExFatLogger example
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _RECORD_FORMAT_H
+#define _RECORD_FORMAT_H
+
+#include <stdint.h>
+
+/****************** SET ADDR & CONST ********************/
+#define XPOD_BIN_MAGIC        "XPODBIN"   //header starts with these 7 chars + '\0'
+#define XPOD_BIN_VERSION      4           //v2: 1024 byte header, 44 fields max, 8 bit offsets; v3: no packing
+#define XPOD_BIN_SECTOR       512         //header_bytes is a multiple - records start sector aligned
+#define XPOD_BIN_NAME_LEN     16          //space padded, not '\0' terminated
+#define XPOD_BIN_SYNC         0xA5        //record byte 0 (never 0x00/0xFF = erased)
+#define XPOD_BIN_STATUS_AT    1           //record byte 1: XPOD_REC_* bits
+#define XPOD_BIN_NOT_STORED   0xFFFF      //field offset of a column the pod leaves empty
+
+// Packed blocks (header packing XPOD_BIN_PACK_DELTA, record_bytes = XPOD_BIN_BLOCK_BYTES):
+//   byte 0 XPOD_BIN_BLOCK_SYNC, byte 1 rows in the block, then the rows, then zeros.
+//   A row is every stored field - status first, then by offset - as the varint
+//   (7 bits a byte, low first, 0x80 = more) of the zig-zag of its change since the
+//   row before: the 16 bit types sign (I16) or zero extended, 32 bit ones (F32: the
+//   bits) modulo 2^32. A block's first row is against zeros, so every block decodes alone
+#define XPOD_BIN_PACK_NONE    0           //fixed-size records
+#define XPOD_BIN_PACK_DELTA   1           //delta/zig-zag/varint rows in blocks
+#define XPOD_BIN_BLOCK_BYTES  XPOD_BIN_SECTOR
+#define XPOD_BIN_BLOCK_SYNC   0x5B        //block byte 0 (never 0x00/0xFF = erased)
+#define XPOD_BIN_BLOCK_HEAD   2           //sync + row count
+
+// Field types (header field table)
+#define XPOD_BIN_U8           1
+#define XPOD_BIN_U16          2
+#define XPOD_BIN_I16          3
+#define XPOD_BIN_U32          4
+#define XPOD_BIN_F32          5
+#define XPOD_BIN_TIME         6           //uint32 unixtime, printed YYYY-MM-DDThh:mm:ss
+
+// Per-record status bits (record .status): the module has data in this row
+// (averaged rows: at least one sample in the interval)
+#define XPOD_REC_PM_RETURNED  0x01
+#define XPOD_REC_PM_PARTICLES 0x02
+#define XPOD_REC_VOLT         0x04
+#define XPOD_REC_ADS          0x08
+#define XPOD_REC_CO2          0x10
+#define XPOD_REC_BME          0x20
+#define XPOD_REC_QUAD         0x40
+
+/****************** STRUCTS ********************/
+/*! One CSV column in the header's field table, in CSV order (22 bytes) */
+struct xpod_bin_field_t
+{
+  char name[XPOD_BIN_NAME_LEN];   //CSV header label
+  uint8_t type;                   //XPOD_BIN_*
+  uint8_t scale;                  //printed as value / 10^scale
+  uint8_t valid;                  //XPOD_REC_* bits the record needs, else empty
+  uint8_t reserved;
+  uint16_t offset;                //byte offset inside a record (XPOD_BIN_NOT_STORED = empty column)
+} __attribute__((packed));
+
+/*! Header: identifies the pod; field_count xpod_bin_field_t follow it, then
+ *  zeros up to header_bytes */
+struct xpod_bin_header_t
+{
+  char magic[8];
+  uint16_t version;
+  uint16_t record_bytes;          //power of 2 (divides 512, or whole sectors)
+  uint16_t field_count;
+  uint16_t header_bytes;          //first record starts here (v2: 0, meaning 1024)
+  char pod_id[8];
+  uint8_t packing;                //XPOD_BIN_PACK_* (v4; v2/v3: 0, fixed-size records)
+  uint8_t reserved[7];
+} __attribute__((packed));
+
+/****************** FUNCTIONS ********************/
+// Zig-zag: small changes either way -> small unsigned (0, -1, 1, -2... -> 0, 1, 2, 3...)
+static inline uint32_t xpod_zigzag(uint32_t delta)
+{
+  return (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+}
+
+static inline uint32_t xpod_unzigzag(uint32_t z)
+{
+  return (z >> 1) ^ (0 - (z & 1));
+}
+
+#endif //_RECORD_FORMAT_H
@@ -0,0 +1,721 @@
+/*******************************************************************************
+ * @file    record_module.cpp
+ * @brief   One row of logged data, built once per LOG_PERIOD_MS from row_schema.h:
+ *          the packed record (binary log) and its CSV text (SD & Serial), formatted
+ *          with integer/fixed-point helpers straight into one static buffer
+ *
+ * @cite    data_t record idea from SdFat's ExFatLogger example
+ *          shift/add divide by 10 as in SdFat's FmtNumber fmtBase10() (Hacker's Delight)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include "record_module.h"
+#include <stddef.h>
+
+/****************** DIGITS ********************/
+// n / 10 & n % 10 without a divide (AVR has no divider: __udivmodsi4 is ~600 cycles)
+static inline uint32_t divmod10(uint32_t n, uint8_t *rem)
+{
+  uint32_t q = (n >> 1) + (n >> 2);
+  q += q >> 4;
+  q += q >> 8;
+  q += q >> 16;
+  q >>= 3;
+  uint8_t r = n - ((q << 2) + q) * 2;
+  if (r > 9)  {
+    q++;
+    r -= 10;
+  } //if (r > 9)
+  *rem = r;
+  return q;
+} //static inline uint32_t divmod10()
+
+// 16 bit version for the common case (ADS, Quadstat, CO2 & PM counts)
+static inline uint16_t divmod10_16(uint16_t n, uint8_t *rem)
+{
+  uint16_t q = (n >> 1) + (n >> 2);
+  q += q >> 4;
+  q += q >> 8;
+  q >>= 3;
+  uint8_t r = n - ((q << 2) + q) * 2;
+  if (r > 9)  {
+    q++;
+    r -= 10;
+  } //if (r > 9)
+  *rem = r;
+  return q;
+} //static inline uint16_t divmod10_16()
+
+// Days since 1970-01-01 -> civil date (H. Hinnant's days_from_civil, inverted)
+static void civil_from_days(uint32_t days, uint16_t *y, uint8_t *m, uint8_t *d)
+{
+  uint32_t z = days + 719468;
+  uint32_t era = z / 146097;
+  uint32_t doe = z - era * 146097;
+  uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  uint32_t mp = (5 * doy + 2) / 153;
+  *d = doy - (153 * mp + 2) / 5 + 1;
+  *m = (mp < 10) ? mp + 3 : mp - 9;
+  *y = yoe + era * 400 + (*m <= 2);
+} //static void civil_from_days()
+
+// Fixed width decimal (leading zeros) into p[0..n-1]
+static void iso_digits(char *p, uint16_t value, uint8_t n)
+{
+  uint8_t rem;
+  while (n > 0)
+  {
+    value = divmod10_16(value, &rem);
+    p[--n] = '0' + rem;
+  }
+} //static void iso_digits()
+
+/****************** SCHEMA EXPANSIONS ********************/
+// Header field: where the column is stored (or that it isn't)
+#define ROW_OFFSET_1(member)  offsetof(xpod_fields_t, member)
+#define ROW_OFFSET_0(member)  XPOD_BIN_NOT_STORED
+#define ROW_FIELD(member, label, type, en, src, scale, valid) \
+  write_field(out, PSTR(label), XPOD_BIN_##type, ROW_CAT(ROW_OFFSET_, en)(member), scale, valid);
+#define ROW_FIELD_STAT(...)   ROW_STAT(ROW_FIELD, __VA_ARGS__)
+
+// CSV column: value (if stored & valid) then ','
+#define ROW_PRINT(member, label, type, en, src, scale, valid) \
+  ROW_CAT(ROW_PRINT_, en)(member, type, scale, valid)
+#define ROW_PRINT_1(member, type, scale, valid) \
+  if ((record->f.status & (valid)) == (valid)) \
+    ROW_PUT_##type(record->f.member, scale); \
+  out.put(',');
+#define ROW_PRINT_0(member, type, scale, valid) \
+  out.put(',');
+#define ROW_PRINT_STAT(...)   ROW_STAT(ROW_PRINT, __VA_ARGS__)
+
+// Formatter of each schema type
+#define ROW_PUT_U8(v, scale)    out.put_unsigned(v, scale)
+#define ROW_PUT_U16(v, scale)   out.put_unsigned(v, scale)
+#define ROW_PUT_U32(v, scale)   out.put_unsigned(v, scale)
+#define ROW_PUT_I16(v, scale)   out.put_signed(v, scale)
+#define ROW_PUT_F32(v, scale)   out.put_float(v, scale)
+#define ROW_PUT_TIME(v, scale)  out.put_time(v)
+
+// CSV header column
+#define ROW_LABEL(member, label, type, en, src, scale, valid) \
+  out.print(F(label ","));
+#define ROW_LABEL_STAT(...)   ROW_STAT(ROW_LABEL, __VA_ARGS__)
+
+// Deadband of each column: row_band::member - XPOD_ROW_DEADBAND's, else row_band_any's 0
+// (a namespace's own name hides one it only gets through "using namespace")
+#define ROW_BAND_ANY(member, label, type, en, src, scale, valid) \
+  constexpr float member = 0;
+#define ROW_BAND_ANY_STAT(...) ROW_STAT(ROW_BAND_ANY, __VA_ARGS__)
+#define ROW_BAND_SET(member, band) \
+  constexpr float member = band;
+namespace row_band_any { XPOD_LOG_SCHEMA(ROW_BAND_ANY) }
+namespace row_band
+{
+  using namespace row_band_any;
+  XPOD_ROW_DEADBAND(ROW_BAND_SET)
+}
+
+// Change-based CSV column (Row_Deadband::format()): empty if not valid, the value if it
+// moved past its band (or the file showed no value / the row is whole), else "=".
+// keep = end of the last column that has to be printed
+#define ROW_SPARSE(member, label, type, en, src, scale, valid) \
+  ROW_CAT(ROW_SPARSE_, en)(member, type, scale, valid)
+#define ROW_SPARSE_1(member, type, scale, valid) \
+  if ((record->f.status & (valid)) != (valid))  { \
+    out.put(','); \
+    if (whole || (last.status & (valid)) == (valid)) \
+      keep = out.length(); \
+  } else if (whole || (last.status & (valid)) != (valid) || \
+             ROW_MOVED_##type(record->f.member, last.member, row_band::member))  { \
+    ROW_PUT_##type(record->f.member, scale); \
+    out.put(','); \
+    next.member = record->f.member; \
+    keep = out.length(); \
+  } else { \
+    out.put('='); \
+    out.put(','); \
+  }
+#define ROW_SPARSE_0(member, type, scale, valid) \
+  out.put(',');
+#define ROW_SPARSE_STAT(...)  ROW_STAT(ROW_SPARSE, __VA_ARGS__)
+
+// Moved past the band (NaN always has); the timestamp is always printed
+#define ROW_MOVED_U8(v, last, band)     row_moved(v, last, band)
+#define ROW_MOVED_U16(v, last, band)    row_moved(v, last, band)
+#define ROW_MOVED_U32(v, last, band)    row_moved(v, last, band)
+#define ROW_MOVED_I16(v, last, band)    row_moved(v, last, band)
+#define ROW_MOVED_F32(v, last, band)    row_moved(v, last, band)
+#define ROW_MOVED_TIME(v, last, band)   true
+
+// Packed row field (Row_Pack::add()): its bits, sign extended for I16 (record_format.h)
+#define ROW_PACK(member, label, type, en, src, scale, valid) \
+  ROW_CAT(ROW_PACK_, en)(member, type)
+#define ROW_PACK_1(member, type) \
+  put(ROW_BITS_##type(record->f.member), ROW_BITS_##type(last.member));
+#define ROW_PACK_0(member, type)
+#define ROW_PACK_STAT(...)    ROW_STAT(ROW_PACK, __VA_ARGS__)
+
+#define ROW_BITS_U8(v)        (uint32_t)(v)
+#define ROW_BITS_U16(v)       (uint32_t)(v)
+#define ROW_BITS_I16(v)       (uint32_t)(int32_t)(v)
+#define ROW_BITS_U32(v)       (uint32_t)(v)
+#define ROW_BITS_F32(v)       row_bits(v)
+#define ROW_BITS_TIME(v)      (uint32_t)(v)
+
+static inline uint32_t row_bits(float v)
+{
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  return bits;
+} //static inline uint32_t row_bits()
+
+template <typename T>
+static inline bool row_moved(T value, T last, float band)
+{
+  if (value == last)
+    return false;
+  if (band == 0)
+    return true;
+  float d = (float)value - (float)last;
+  return !(d <= band && d >= -band);
+} //static inline bool row_moved()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Writes one column of the header's field table (label kept in flash)
+ *        @param  out     where the header goes
+ *        @param  name    PSTR() label
+ *        @param  type    XPOD_BIN_* type code
+ *        @param  offset  offsetof() the member in xpod_fields_t, or XPOD_BIN_NOT_STORED
+ *        @param  scale   printed as value / 10^scale
+ *        @param  valid   XPOD_REC_* bits needed for a value
+ */
+/**************************************************************************/
+static void write_field(Print &out, const char *name, uint8_t type, uint16_t offset,
+                        uint8_t scale, uint8_t valid)
+{
+  xpod_bin_field_t field;
+  size_t len = strlen_P(name);
+  if (len > XPOD_BIN_NAME_LEN)
+    len = XPOD_BIN_NAME_LEN;
+  memset(&field, 0, sizeof(field));
+  memset(field.name, ' ', XPOD_BIN_NAME_LEN);
+  memcpy_P(field.name, name, len);
+  field.type = type;
+  field.offset = offset;
+  field.scale = scale;
+  field.valid = valid;
+  out.write((const uint8_t *)&field, sizeof(field));
+} //static void write_field()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Zeroes a record (padding included) and stamps the sync byte
+ *        @param  record  record to reset before filling
+ */
+/**************************************************************************/
+void record_clear(xpod_record_t *record)
+{
+  memset(record->raw, 0, sizeof(record->raw));
+  record->f.sync = XPOD_BIN_SYNC;
+} //void record_clear()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Writes the binary file header: pod, then every CSV column (stored
+ *            or not), zero padded to XPOD_HEADER_BYTES - so the converter needs
+ *            no copy of this firmware's config. Streamed, never all in RAM
+ *        @param  out  where the header goes (the open log)
+ */
+/**************************************************************************/
+void record_header(Print &out, uint8_t packing)
+{
+  xpod_bin_header_t header;
+  memset(&header, 0, sizeof(header));
+  strcpy(header.magic, XPOD_BIN_MAGIC);
+  header.version = XPOD_BIN_VERSION;
+  header.record_bytes = (packing == XPOD_BIN_PACK_NONE) ? XPOD_RECORD_BYTES : XPOD_BIN_BLOCK_BYTES;
+  header.field_count = XPOD_LOG_COLUMNS;
+  header.header_bytes = XPOD_HEADER_BYTES;
+  strncpy(header.pod_id, XPODID, sizeof(header.pod_id));
+  header.packing = packing;
+  out.write((const uint8_t *)&header, sizeof(header));
+
+  XPOD_LOG_SCHEMA(ROW_FIELD)
+
+  for (size_t n = sizeof(header) + XPOD_LOG_COLUMNS * sizeof(xpod_bin_field_t); n < XPOD_HEADER_BYTES; n++)
+    out.write((uint8_t)0);
+} //void record_header()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Formats a record as one CSV row: leading newline, every column
+ *            followed by ',' (empty if disabled or not valid this row).
+ *            Same text as Print::print() gave, two decimals for scaled/float values
+ *        @param  record  filled record
+ *        @param  out     row buffer (cleared first)
+ */
+/**************************************************************************/
+void record_format_csv(const xpod_record_t *record, Row_Text &out)
+{
+  out.clear();
+  out.put('\r');
+  out.put('\n');
+  XPOD_LOG_SCHEMA(ROW_PRINT)
+} //void record_format_csv()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Prints the CSV header row (no newline - every row starts with one)
+ *        @param  out  where to print
+ */
+/**************************************************************************/
+void record_print_labels(Print &out)
+{
+  XPOD_LOG_SCHEMA(ROW_LABEL)
+} //void record_print_labels()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Empty row buffer
+ */
+/**************************************************************************/
+Row_Text::Row_Text()
+{
+  iso_time = 0;
+  clear();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Empties the buffer for the next row
+ */
+/**************************************************************************/
+void Row_Text::clear()
+{
+  len = 0;
+  text[0] = '\0';
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Print sink: appends (drops what doesn't fit ROW_TEXT_BYTES)
+ *    @return bytes kept
+ */
+/**************************************************************************/
+size_t Row_Text::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+size_t Row_Text::write(const uint8_t *buf, size_t size)
+{
+  if (size > sizeof(text) - 1 - len)
+    size = sizeof(text) - 1 - len;
+  memcpy(text + len, buf, size);
+  len += size;
+  text[len] = '\0';
+  return size;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Appends one character
+ */
+/**************************************************************************/
+void Row_Text::put(char c)
+{
+  if (len < sizeof(text) - 1)  {
+    text[len++] = c;
+    text[len] = '\0';
+  } //if (len < sizeof(text) - 1)
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Appends an integer: as is (scale 0), or value / 10^scale with two
+ *            decimals, rounded half up like Print::print(double)
+ *        @param  value  raw value
+ *        @param  scale  decimal places to shift (P: 2, GR: 3)
+ */
+/**************************************************************************/
+void Row_Text::put_unsigned(uint32_t value, uint8_t scale)
+{
+  if (scale == 0)  {
+    put_digits(value, 1);
+    return;
+  } //if (scale == 0)
+
+  // to hundredths: x10 for scale 1, /10^(scale-2) rounded for scale >= 2
+  uint32_t div = 1;
+  for (uint8_t i = 2; i < scale; i++)
+    div *= 10;
+  put_hundredths((scale == 1) ? value * 10 : (value + div / 2) / div);
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Signed put_unsigned()
+ */
+/**************************************************************************/
+void Row_Text::put_signed(int32_t value, uint8_t scale)
+{
+  if (value < 0)  {
+    put('-');
+    put_unsigned(-(uint32_t)value, scale);
+  } else {
+    put_unsigned(value, scale);
+  }
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Appends a float with two decimals: one multiply & round to
+ *            hundredths, then integer digits (nan/inf/ovf like Print)
+ *        @param  value  value to print
+ *        @param  scale  value / 10^scale first (0 for the BME & Vin floats)
+ */
+/**************************************************************************/
+void Row_Text::put_float(float value, uint8_t scale)
+{
+  while (scale--)
+    value /= 10.0f;
+
+  if (isnan(value))  {
+    write("nan");
+    return;
+  } //if (isnan(value))
+  if (isinf(value))  {
+    write("inf");
+    return;
+  } //if (isinf(value))
+  if (value > 42949672.0f || value < -42949672.0f)  {
+    write("ovf");                   //hundredths would not fit 32 bits
+    return;
+  } //if (out of range)
+
+  if (value < 0.0f)  {
+    put('-');
+    value = -value;
+  } //if (value < 0.0f)
+  put_hundredths((uint32_t)(value * 100.0f + 0.5f));
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Appends YYYY-MM-DDThh:mm:ss (same text as the old bufftime). Up
+ *            to ROW_TIME_STEPS s after the last one the digits are counted on
+ *            from it; the date (midnight), a step back or a jump converts again
+ *        @param  unixtime  row time (Timebase::unixtime())
+ */
+/**************************************************************************/
+void Row_Text::put_time(uint32_t unixtime)
+{
+  if (iso_time == 0 || unixtime < iso_time || unixtime - iso_time > ROW_TIME_STEPS)  {
+    format_time(unixtime);
+  } else {
+    while (iso_time != unixtime)
+    {
+      if (!tick_time())  {
+        format_time(unixtime);
+        break;
+      } //if (!tick_time())
+    }
+  } //if (too far from the last one)
+  write((const uint8_t *)iso, sizeof(iso));
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Converts unixtime to the timestamp text from scratch
+ */
+/**************************************************************************/
+void Row_Text::format_time(uint32_t unixtime)
+{
+  uint32_t minutes = unixtime / 60;
+  uint8_t sec = unixtime - minutes * 60;
+  uint32_t hours = minutes / 60;
+  uint8_t min = minutes - hours * 60;
+  uint32_t days = hours / 24;
+  uint8_t hour = hours - days * 24;
+
+  uint16_t year;
+  uint8_t month, day;
+  civil_from_days(days, &year, &month, &day);
+
+  iso_digits(iso, year, 4);
+  iso[4] = '-';
+  iso_digits(iso + 5, month, 2);
+  iso[7] = '-';
+  iso_digits(iso + 8, day, 2);
+  iso[10] = 'T';
+  iso_digits(iso + 11, hour, 2);
+  iso[13] = ':';
+  iso_digits(iso + 14, min, 2);
+  iso[16] = ':';
+  iso_digits(iso + 17, sec, 2);
+  iso_time = unixtime;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Counts the timestamp text on by one second (carry up to the hour)
+ *    @return false at midnight - the date has to be converted again
+ */
+/**************************************************************************/
+bool Row_Text::tick_time()
+{
+  iso_time++;
+  if (++iso[18] <= '9')
+    return true;
+  iso[18] = '0';
+  if (++iso[17] <= '5')
+    return true;
+  iso[17] = '0';
+  if (++iso[15] <= '9')
+    return true;
+  iso[15] = '0';
+  if (++iso[14] <= '5')
+    return true;
+  iso[14] = '0';
+  if (iso[11] == '2' && iso[12] == '3')
+    return false;
+  if (++iso[12] <= '9')
+    return true;
+  iso[12] = '0';
+  iso[11]++;
+  return true;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Appends the decimal digits of value (zero padded to min_digits)
+ */
+/**************************************************************************/
+void Row_Text::put_digits(uint32_t value, uint8_t min_digits)
+{
+  char buf[10];
+  char *end = buf + sizeof(buf);
+  char *str = end;
+  uint8_t rem;
+
+  while (value > 0xFFFF)
+  {
+    value = divmod10(value, &rem);
+    *--str = '0' + rem;
+  }
+  uint16_t v16 = value;
+  do {
+    v16 = divmod10_16(v16, &rem);
+    *--str = '0' + rem;
+  } while (v16);
+  while (end - str < min_digits)
+    *--str = '0';
+  write((const uint8_t *)str, end - str);
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Appends hundredths as "int.dd"
+ */
+/**************************************************************************/
+void Row_Text::put_hundredths(uint32_t hundredths)
+{
+  uint8_t d1, d0;
+  uint32_t tenths = divmod10(hundredths, &d0);
+  put_digits(divmod10(tenths, &d1), 1);
+  put('.');
+  put('0' + d1);
+  put('0' + d0);
+}
+
+/**************************************************************************/
+ /*!
+ *    @return the row text ('\0' terminated)
+ */
+/**************************************************************************/
+const char *Row_Text::c_str()
+{
+  return text;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return length of the row text
+ */
+/**************************************************************************/
+size_t Row_Text::length()
+{
+  return len;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Drops the text after the first length characters
+ *        @param  length  characters to keep (<= length())
+ */
+/**************************************************************************/
+void Row_Text::trim(size_t length)
+{
+  if (length < len)  {
+    len = length;
+    text[len] = '\0';
+  } //if (length < len)
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Nothing shown yet: the first row is whole
+ */
+/**************************************************************************/
+Row_Deadband::Row_Deadband()
+{
+  memset(&last, 0, sizeof(last));
+  next = last;
+  reset();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  The next row is printed whole (new file, or a file reopened at
+ *            its last committed row)
+ */
+/**************************************************************************/
+void Row_Deadband::reset()
+{
+  rows = 0;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Formats a record as one change-based CSV row: leading newline,
+ *            the timestamp, then every column that moved past its band, "="
+ *            for the others up to the last one printed. A row read as the
+ *            previous row's text with its "=" (and missing) columns filled
+ *            in is record_format_csv()'s, up to the bands
+ *        @param  record  filled record
+ *        @param  out     row buffer (cleared first)
+ */
+/**************************************************************************/
+void Row_Deadband::format(const xpod_record_t *record, Row_Text &out)
+{
+  bool whole = (rows == 0);
+  size_t keep;
+
+  next = last;
+  next.status = record->f.status;
+  out.clear();
+  out.put('\r');
+  out.put('\n');
+  keep = out.length();
+  XPOD_LOG_SCHEMA(ROW_SPARSE)
+  out.trim(keep);
+} //void Row_Deadband::format()
+
+/**************************************************************************/
+ /*!
+ *    @brief  The row format() made is on its way to the file: its values are
+ *            what the next row is compared against
+ */
+/**************************************************************************/
+void Row_Deadband::commit()
+{
+  last = next;
+  if (++rows >= ROW_KEY_ROWS)
+    rows = 0;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Empty block
+ */
+/**************************************************************************/
+Row_Pack::Row_Pack()
+{
+  clear();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Starts the next block: no rows, zeros to code the first against
+ */
+/**************************************************************************/
+void Row_Pack::clear()
+{
+  memset(buf, 0, sizeof(buf));
+  buf[0] = XPOD_BIN_BLOCK_SYNC;
+  len = XPOD_BIN_BLOCK_HEAD;
+  memset(&last, 0, sizeof(last));
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Codes a row onto the end of the block: status, then every stored
+ *            field, each as the change since the row before
+ *        @param  record  filled record
+ *    @return false if it doesn't fit (the block is left as it was: write it out,
+ *            clear() & add again) or the block already holds 255 rows
+ */
+/**************************************************************************/
+bool Row_Pack::add(const xpod_record_t *record)
+{
+  uint16_t start = len;
+  if (buf[1] == 0xFF)
+    return false;
+
+  put(record->f.status, last.status);
+  XPOD_LOG_SCHEMA(ROW_PACK)
+  if (len > XPOD_BIN_BLOCK_BYTES)  {
+    memset(buf + start, 0, XPOD_BIN_BLOCK_BYTES - start);
+    len = start;
+    return false;
+  } //if (len > XPOD_BIN_BLOCK_BYTES)
+
+  memcpy(&last, &record->f, sizeof(last));
+  buf[1]++;
+  return true;
+} //bool Row_Pack::add()
+
+/**************************************************************************/
+ /*!
+ *    @return rows in the block
+ */
+/**************************************************************************/
+uint8_t Row_Pack::rows()
+{
+  return buf[1];
+}
+
+/**************************************************************************/
+ /*!
+ *    @return the block (XPOD_BIN_BLOCK_BYTES, zero after the last row)
+ */
+/**************************************************************************/
+const uint8_t *Row_Pack::block()
+{
+  return buf;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Appends one field: varint of the zig-zag of value - prev. Past the
+ *            end of the block only len moves on (add() then drops the row)
+ */
+/**************************************************************************/
+void Row_Pack::put(uint32_t value, uint32_t prev)
+{
+  uint32_t z = xpod_zigzag(value - prev);
+  while (true)
+  {
+    uint8_t b = z & 0x7F;
+    z >>= 7;
+    if (len < XPOD_BIN_BLOCK_BYTES)
+      buf[len] = z ? (b | 0x80) : b;
+    len++;
+    if (z == 0)
+      return;
+  }
+}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * @file    record_module.h
+ * @brief   One row of logged data, built once per LOG_PERIOD_MS from row_schema.h:
+ *          the packed record (binary log) and its CSV text (SD & Serial), formatted
+ *          with integer/fixed-point helpers straight into one static buffer
+ *
+ * @cite    data_t record idea from SdFat's ExFatLogger example
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _RECORD_MODULE_H
+#define _RECORD_MODULE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "xpod_node.h"
+#include "record_format.h"
+#include "row_schema.h"
+
+/****************** SET ADDR & CONST ********************/
+#define ROW_TEXT_BYTES        (2 + XPOD_LOG_TEXT_MAX + 1)   //longest CSV row: "\r\n", columns, '\0'
+#define ROW_TIME_STEPS        60    //put_time() counts on up to this many seconds, else converts
+#define ROW_KEY_ROWS          ((SD_DEADBAND_HEARTBEAT_S * 1000UL + LOG_PERIOD_MS - 1) / LOG_PERIOD_MS)  //Row_Deadband: whole row every this many
+
+/****************** STRUCTS, OBJECTS ********************/
+/*! Raw values of one row; only enabled columns take space */
+struct xpod_fields_t
+{
+  uint8_t sync;                   //XPOD_BIN_SYNC
+  uint8_t status;                 //XPOD_REC_* bits
+  XPOD_LOG_SCHEMA(ROW_MEMBER)
+} __attribute__((packed));
+
+// Smallest power of 2 >= n (records never straddle a 512 byte sector)
+constexpr uint16_t record_pow2(uint16_t n, uint16_t p = 1)
+{
+  return (p >= n) ? p : record_pow2(n, p * 2);
+}
+
+#define XPOD_RECORD_BYTES     record_pow2(sizeof(xpod_fields_t))
+
+// Binary header: fixed part + one field per CSV column, padded to whole sectors
+#define XPOD_HEADER_BYTES     ((sizeof(xpod_bin_header_t) + XPOD_LOG_COLUMNS * sizeof(xpod_bin_field_t) \
+                                + XPOD_BIN_SECTOR - 1) / XPOD_BIN_SECTOR * XPOD_BIN_SECTOR)
+
+/*! One record as written to the card: the fields, zero padded to XPOD_RECORD_BYTES */
+union xpod_record_t
+{
+  xpod_fields_t f;
+  uint8_t raw[XPOD_RECORD_BYTES];
+};
+
+static_assert(XPOD_RECORD_BYTES <= 512, "binary log record bigger than a sector");
+static_assert(XPOD_HEADER_BYTES <= 0xFFFF, "binary log header too big");
+
+// Encoder - expanded in the sketch (where the sources live) as XPOD_LOG_SCHEMA(ROW_ENCODE)
+// with the record in scope as "rec"; disabled columns never see their source
+#define ROW_ENCODE(member, label, type, en, src, scale, valid) \
+  ROW_CAT(ROW_ENCODE_, en)(member, src)
+#define ROW_ENCODE_1(member, src)     rec->f.member = (src);
+#define ROW_ENCODE_0(member, src)
+#define ROW_ENCODE_STAT(...)          ROW_STAT(ROW_ENCODE, __VA_ARGS__)
+
+/****************** CLASSES ********************/
+/*! Fixed RAM buffer the row is formatted into once, then handed to every sink.
+ *  The put_*() formatters are integer only (no float division / printFloat);
+ *  put_time() moves the last timestamp's text on instead of converting again */
+class Row_Text : public Print {
+  public:
+    Row_Text();
+    void clear();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buf, size_t size);
+    using Print::write;
+
+    void put(char c);
+    void put_unsigned(uint32_t value, uint8_t scale);
+    void put_signed(int32_t value, uint8_t scale);
+    void put_float(float value, uint8_t scale);
+    void put_time(uint32_t unixtime);
+
+    const char *c_str();
+    size_t length();
+    void trim(size_t length);
+
+  private:
+    void put_digits(uint32_t value, uint8_t min_digits);
+    void put_hundredths(uint32_t hundredths);
+    void format_time(uint32_t unixtime);
+    bool tick_time();
+
+    char text[ROW_TEXT_BYTES];
+    size_t len;
+    char iso[ROW_CHARS_TIME];     //last put_time() text (no '\0')...
+    uint32_t iso_time;            //...and its unixtime (0 = none yet)
+};
+
+/*! Change-based CSV for the SD (SD_DEADBAND_ENABLED): a column is printed when it
+ *  moved past its XPOD_ROW_DEADBAND band since the value the file last showed, else
+ *  as "=" - and "=" columns at the end of the row are left off. Every ROW_KEY_ROWS-th
+ *  row, and the first after reset() (each file), is printed whole.
+ *  format() makes the row, commit() once it is staged makes it the file's last */
+class Row_Deadband {
+  public:
+    Row_Deadband();
+    void reset();
+    void format(const xpod_record_t *record, Row_Text &out);
+    void commit();
+
+  private:
+    xpod_fields_t last;           //values the file shows (printed, or carried on by "=")...
+    xpod_fields_t next;           //...and after the row format() made
+    uint16_t rows;                //rows since the last whole one (0 = next is whole)
+};
+
+/*! Packed binary log (SD_BINARY_PACKED_ENABLED): rows delta/zig-zag/varint coded
+ *  into one XPOD_BIN_BLOCK_BYTES block (record_format.h), written out whole.
+ *  The block is built here in RAM: add() until it is full, then the block
+ *  goes to the card and clear() starts the next one from zeros */
+class Row_Pack {
+  public:
+    Row_Pack();
+    void clear();
+    bool add(const xpod_record_t *record);
+    uint8_t rows();
+    const uint8_t *block();
+
+  private:
+    void put(uint32_t value, uint32_t prev);
+
+    uint8_t buf[XPOD_BIN_BLOCK_BYTES];
+    uint16_t len;                 //bytes used (> XPOD_BIN_BLOCK_BYTES: the row didn't fit)
+    xpod_fields_t last;           //previous row in the block (zeros before the first)
+};
+
+/****************** FUNCTIONS ********************/
+void record_clear(xpod_record_t *record);
+void record_header(Print &out, uint8_t packing = XPOD_BIN_PACK_NONE);
+void record_format_csv(const xpod_record_t *record, Row_Text &out);
+void record_print_labels(Print &out);
+
+#endif //_RECORD_MODULE_H
@@ -0,0 +1,327 @@
+/*******************************************************************************
+ * @file    row_schema.h
+ * @brief   THE list of logged columns - the only place a field is named. The
+ *          record struct, binary encoder & field table, CSV header row, row
+ *          formatter and empty placeholders are all expanded from XPOD_ROW_SCHEMA
+ *          (through XPOD_LOG_SCHEMA, which adds the averaged-row, timebase, PMS, health & profile columns)
+ *
+ *          Add a column: one X() line here (+ its ROW_EN_* flag if it is new)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _ROW_SCHEMA_H
+#define _ROW_SCHEMA_H
+
+#include "xpod_node.h"
+#include "record_format.h"
+
+/****************** COLUMN ENABLES (must be a plain 0 or 1) ********************/
+#if RTC_ENABLED
+  #define ROW_EN_RTC          1
+#else
+  #define ROW_EN_RTC          0
+#endif //RTC_ENABLED
+#if INPUTVOLT_ENABLED
+  #define ROW_EN_VOLT         1
+#else
+  #define ROW_EN_VOLT         0
+#endif //INPUTVOLT_ENABLED
+#if ADS_ENABLED
+  #define ROW_EN_ADS          1
+#else
+  #define ROW_EN_ADS          0
+#endif //ADS_ENABLED
+#if ADS_ENABLED && MQ_ENABLED
+  #define ROW_EN_MQ           1
+#else
+  #define ROW_EN_MQ           0
+#endif //ADS_ENABLED && MQ_ENABLED
+#if ADS_ENABLED && PID_ENABLED
+  #define ROW_EN_PID          1
+#else
+  #define ROW_EN_PID          0
+#endif //ADS_ENABLED && PID_ENABLED
+#if CO2_ENABLED
+  #define ROW_EN_CO2          1
+#else
+  #define ROW_EN_CO2          0
+#endif //CO2_ENABLED
+#if BME_ENABLED
+  #define ROW_EN_BME          1
+#else
+  #define ROW_EN_BME          0
+#endif //BME_ENABLED
+#if QUAD_ENABLED
+  #define ROW_EN_QUAD         1
+#else
+  #define ROW_EN_QUAD         0
+#endif //QUAD_ENABLED
+#if PMS_ENABLED
+  #define ROW_EN_PMS          1
+#else
+  #define ROW_EN_PMS          0
+#endif //PMS_ENABLED
+#if PMS_ENABLED && INCLUDE_STANDARD
+  #define ROW_EN_PMS_STD      1
+#else
+  #define ROW_EN_PMS_STD      0
+#endif //PMS_ENABLED && INCLUDE_STANDARD
+#if PMS_ENABLED && INCLUDE_PARTICLES
+  #define ROW_EN_PMS_PART     1
+#else
+  #define ROW_EN_PMS_PART     0
+#endif //PMS_ENABLED && INCLUDE_PARTICLES
+#if SD_ENABLED && SD_PERSISTENT_ENABLED && SD_SPOOL_ENABLED
+  #define ROW_EN_SPOOL        1
+#else
+  #define ROW_EN_SPOOL        0
+#endif //SD_ENABLED && SD_PERSISTENT_ENABLED && SD_SPOOL_ENABLED
+
+#define ROW_PM_OK             XPOD_REC_PM_RETURNED
+#define ROW_PM_PART           (XPOD_REC_PM_RETURNED | XPOD_REC_PM_PARTICLES)
+// Status of a row built from the latest readings: every non-PM module has data
+#define ROW_OK_LATEST         (XPOD_REC_VOLT | XPOD_REC_ADS | XPOD_REC_CO2 | XPOD_REC_BME | XPOD_REC_QUAD)
+
+/****************** SCHEMA ********************/
+// X(member, label, type, enable, source, scale, valid)
+//   member  name in xpod_fields_t          label   CSV header / binary field name
+//   type    U8 U16 I16 U32 F32 TIME        enable  ROW_EN_* - 0 = empty column, not stored
+//   source  expression in the sketch       scale   printed as value / 10^scale
+//   valid   record status bits needed (the module's XPOD_REC_* bit), else the column is left empty
+// Only the sketch expands source, and only for enabled columns
+#define XPOD_ROW_SCHEMA(X) \
+  X(time,            "DateTime",  TIME, ROW_EN_RTC,      row_time,                      0, 0)             \
+  X(in_volt,         "Vin",       F32,  ROW_EN_VOLT,     in_volt_val,                   0, XPOD_REC_VOLT) \
+  X(Fig1,            "Fig1",      U16,  ROW_EN_ADS,      ads_data.Fig1,                 0, XPOD_REC_ADS)  \
+  X(Fig2,            "Fig2",      U16,  ROW_EN_ADS,      ads_data.Fig2,                 0, XPOD_REC_ADS)  \
+  X(Fig3,            "Fig3",      U16,  ROW_EN_ADS,      ads_data.Fig3,                 0, XPOD_REC_ADS)  \
+  X(Fig3_heater,     "Fig3_heat", U16,  ROW_EN_ADS,      ads_data.Fig3_heater,          0, XPOD_REC_ADS)  \
+  X(Fig4,            "Fig4",      U16,  ROW_EN_ADS,      ads_data.Fig4,                 0, XPOD_REC_ADS)  \
+  X(Fig4_heater,     "Fig4_heat", U16,  ROW_EN_ADS,      ads_data.Fig4_heater,          0, XPOD_REC_ADS)  \
+  X(Mq,              "MQ",        U16,  ROW_EN_MQ,       ads_data.Mq,                   0, XPOD_REC_ADS)  \
+  X(Pid,             "PID",       U16,  ROW_EN_PID,      ads_data.Pid,                  0, XPOD_REC_ADS)  \
+  X(Misc2611,        "MiSC2611",  U16,  ROW_EN_ADS,      ads_data.Misc2611,             0, XPOD_REC_ADS)  \
+  X(Auxiliary,       "B4_Aux",    I16,  ROW_EN_ADS,      ads_data.Auxiliary,            0, XPOD_REC_ADS)  \
+  X(Worker,          "B4_Work",   I16,  ROW_EN_ADS,      ads_data.Worker,               0, XPOD_REC_ADS)  \
+  X(CO2,             "CO2",       U16,  ROW_EN_CO2,      CO2,                           0, XPOD_REC_CO2)  \
+  X(T,               "T_C",       F32,  ROW_EN_BME,      bme_data.T,                    0, XPOD_REC_BME)  \
+  X(P,               "P_hPa",     U32,  ROW_EN_BME,      bme_data.P,                    2, XPOD_REC_BME)  \
+  X(RH,              "RH_pct",    F32,  ROW_EN_BME,      bme_data.RH,                   0, XPOD_REC_BME)  \
+  X(GR,              "GR_kOhm",   U32,  ROW_EN_BME,      bme_data.GR,                   3, XPOD_REC_BME)  \
+  X(QS1_C1,          "QS1_C1",    I16,  ROW_EN_QUAD,     quadstat_data.QS1_C1,          0, XPOD_REC_QUAD) \
+  X(QS1_C2,          "QS1_C2",    I16,  ROW_EN_QUAD,     quadstat_data.QS1_C2,          0, XPOD_REC_QUAD) \
+  X(QS2_C1,          "QS2_C1",    I16,  ROW_EN_QUAD,     quadstat_data.QS2_C1,          0, XPOD_REC_QUAD) \
+  X(QS2_C2,          "QS2_C2",    I16,  ROW_EN_QUAD,     quadstat_data.QS2_C2,          0, XPOD_REC_QUAD) \
+  X(QS3_C1,          "QS3_C1",    I16,  ROW_EN_QUAD,     quadstat_data.QS3_C1,          0, XPOD_REC_QUAD) \
+  X(QS3_C2,          "QS3_C2",    I16,  ROW_EN_QUAD,     quadstat_data.QS3_C2,          0, XPOD_REC_QUAD) \
+  X(QS4_C1,          "QS4_C1",    I16,  ROW_EN_QUAD,     quadstat_data.QS4_C1,          0, XPOD_REC_QUAD) \
+  X(QS4_C2,          "QS4_C2",    I16,  ROW_EN_QUAD,     quadstat_data.QS4_C2,          0, XPOD_REC_QUAD) \
+  X(pm10_env,        "PM1_env",   U16,  ROW_EN_PMS,      pms_data.pm10_env,             0, ROW_PM_OK)     \
+  X(pm25_env,        "PM25_env",  U16,  ROW_EN_PMS,      pms_data.pm25_env,             0, ROW_PM_OK)     \
+  X(pm100_env,       "PM10_env",  U16,  ROW_EN_PMS,      pms_data.pm100_env,            0, ROW_PM_OK)     \
+  X(pm10_standard,   "PM1_std",   U16,  ROW_EN_PMS_STD,  pms_data.pm10_standard,        0, ROW_PM_OK)     \
+  X(pm25_standard,   "PM25_std",  U16,  ROW_EN_PMS_STD,  pms_data.pm25_standard,        0, ROW_PM_OK)     \
+  X(pm100_standard,  "PM10_std",  U16,  ROW_EN_PMS_STD,  pms_data.pm100_standard,       0, ROW_PM_OK)     \
+  X(particles_03um,  "N0.3",      U16,  ROW_EN_PMS_PART, pms_data.particles_03um,       0, ROW_PM_PART)   \
+  X(particles_05um,  "N0.5",      U16,  ROW_EN_PMS_PART, pms_data.particles_05um,       0, ROW_PM_PART)   \
+  X(particles_10um,  "N1.0",      U16,  ROW_EN_PMS_PART, pms_data.particles_10um,       0, ROW_PM_PART)   \
+  X(particles_25um,  "N2.5",      U16,  ROW_EN_PMS_PART, pms_data.particles_25um,       0, ROW_PM_PART)   \
+  X(particles_50um,  "N5.0",      U16,  ROW_EN_PMS_PART, pms_data.particles_50um,       0, ROW_PM_PART)   \
+  X(particles_100um, "N10",       U16,  ROW_EN_PMS_PART, pms_data.particles_100um,      0, ROW_PM_PART)
+
+// Averaged rows (STATS_ENABLED) also log how many samples each module gave
+#define XPOD_ROW_COUNTS(X) \
+  X(n_volt,          "Vin_n",     U16,  ROW_EN_VOLT,     row_stats.in_volt.count(),     0, 0) \
+  X(n_ads,           "ADS_n",     U16,  ROW_EN_ADS,      row_stats.Fig1.count(),        0, 0) \
+  X(n_co2,           "CO2_n",     U16,  ROW_EN_CO2,      row_stats.CO2.count(),         0, 0) \
+  X(n_bme,           "BME_n",     U16,  ROW_EN_BME,      row_stats.T.count(),           0, 0) \
+  X(n_quad,          "QUAD_n",    U16,  ROW_EN_QUAD,     row_stats.QS1_C1.count(),      0, 0) \
+  X(n_pms,           "PM_n",      U16,  ROW_EN_PMS,      row_stats.pm25_env.count(),    0, 0)
+
+// PMS averaging (PMS_AVERAGE_ENABLED): frames in the row's PM means (0 = none came,
+// the means are the previous row's) & frames dropped on a bad checksum since boot
+#define XPOD_ROW_PMS(X) \
+  X(pm_frames,         "PM_frames",       U16, ROW_EN_PMS,   pms_frames,                        0, 0) \
+  X(pm_drops,          "PM_drops",        U16, ROW_EN_PMS,   pms.checksumErrors(),              0, 0)
+
+// Profiled rows (PROFILE_ENABLED & PROFILE_COLUMNS_ENABLED): mean & max us of each
+// stage's calls this row (profile_module.h)
+#define XPOD_ROW_PROFILE(X) \
+  X(prof_rtc,          "rtc_us",          U32, ROW_EN_RTC,   profiler.mean(PROF_RTC),           0, 0) \
+  X(prof_rtc_max,      "rtc_max_us",      U32, ROW_EN_RTC,   profiler.maximum(PROF_RTC),        0, 0) \
+  X(prof_volt,         "volt_us",         U32, ROW_EN_VOLT,  profiler.mean(PROF_VOLT),          0, 0) \
+  X(prof_volt_max,     "volt_max_us",     U32, ROW_EN_VOLT,  profiler.maximum(PROF_VOLT),       0, 0) \
+  X(prof_ads,          "ads_us",          U32, ROW_EN_ADS,   profiler.mean(PROF_ADS),           0, 0) \
+  X(prof_ads_max,      "ads_max_us",      U32, ROW_EN_ADS,   profiler.maximum(PROF_ADS),        0, 0) \
+  X(prof_co2,          "co2_us",          U32, ROW_EN_CO2,   profiler.mean(PROF_CO2),           0, 0) \
+  X(prof_co2_max,      "co2_max_us",      U32, ROW_EN_CO2,   profiler.maximum(PROF_CO2),        0, 0) \
+  X(prof_bme,          "bme_us",          U32, ROW_EN_BME,   profiler.mean(PROF_BME),           0, 0) \
+  X(prof_bme_max,      "bme_max_us",      U32, ROW_EN_BME,   profiler.maximum(PROF_BME),        0, 0) \
+  X(prof_quad,         "quad_us",         U32, ROW_EN_QUAD,  profiler.mean(PROF_QUAD),          0, 0) \
+  X(prof_quad_max,     "quad_max_us",     U32, ROW_EN_QUAD,  profiler.maximum(PROF_QUAD),       0, 0) \
+  X(prof_pms,          "pms_us",          U32, ROW_EN_PMS,   profiler.mean(PROF_PMS),           0, 0) \
+  X(prof_pms_max,      "pms_max_us",      U32, ROW_EN_PMS,   profiler.maximum(PROF_PMS),        0, 0) \
+  X(prof_row,          "row_us",          U32, 1,            profiler.mean(PROF_ROW),           0, 0) \
+  X(prof_row_max,      "row_max_us",      U32, 1,            profiler.maximum(PROF_ROW),        0, 0) \
+  X(prof_sd_open,      "sd_open_us",      U32, 1,            profiler.mean(PROF_SD_OPEN),       0, 0) \
+  X(prof_sd_open_max,  "sd_open_max_us",  U32, 1,            profiler.maximum(PROF_SD_OPEN),    0, 0) \
+  X(prof_sd_write,     "sd_write_us",     U32, 1,            profiler.mean(PROF_SD_WRITE),      0, 0) \
+  X(prof_sd_write_max, "sd_write_max_us", U32, 1,            profiler.maximum(PROF_SD_WRITE),   0, 0) \
+  X(prof_sd_sync,      "sd_sync_us",      U32, 1,            profiler.mean(PROF_SD_SYNC),       0, 0) \
+  X(prof_sd_sync_max,  "sd_sync_max_us",  U32, 1,            profiler.maximum(PROF_SD_SYNC),    0, 0) \
+  X(prof_sd_close,     "sd_close_us",     U32, 1,            profiler.mean(PROF_SD_CLOSE),      0, 0) \
+  X(prof_sd_close_max, "sd_close_max_us", U32, 1,            profiler.maximum(PROF_SD_CLOSE),   0, 0) \
+  X(prof_serial,       "serial_us",       U32, 1,            profiler.mean(PROF_SERIAL_OUT),    0, 0) \
+  X(prof_serial_max,   "serial_max_us",   U32, 1,            profiler.maximum(PROF_SERIAL_OUT), 0, 0)
+
+// Timebase rows (TIMEBASE_COLUMNS_ENABLED): ms into the DateTime second the row was
+// stamped, and how old each module's latest sample was then (sub-second lag analysis)
+#define XPOD_ROW_TIMEBASE(X) \
+  X(time_ms,           "DateTime_ms",     U16, 1,            timebase.msec(row_ms),             0, 0) \
+  X(volt_age,          "volt_age_ms",     U16, ROW_EN_VOLT,  sample_age(TASK_VOLT),             0, 0) \
+  X(ads_age,           "ads_age_ms",      U16, ROW_EN_ADS,   sample_age(TASK_ADS),              0, 0) \
+  X(co2_age,           "co2_age_ms",      U16, ROW_EN_CO2,   sample_age(TASK_CO2),              0, 0) \
+  X(bme_age,           "bme_age_ms",      U16, ROW_EN_BME,   sample_age(TASK_BME),              0, 0) \
+  X(quad_age,          "quad_age_ms",     U16, ROW_EN_QUAD,  sample_age(TASK_QUAD),             0, 0) \
+  X(pms_age,           "pms_age_ms",      U16, ROW_EN_PMS,   sample_age(TASK_PMS),              0, 0)
+
+// Health rows (HEALTH_ENABLED): boot count & reset cause, this row's scheduler ticks,
+// least free stack and error counts since boot (health_module.h), rows waiting for the card
+#define XPOD_ROW_HEALTH(X) \
+  X(boots,             "boots",           U32, 1,            health.boots(),                    0, 0) \
+  X(reset_cause,       "reset",           U8,  1,            health.reset_cause(),              0, 0) \
+  X(tick_us,           "tick_us",         U32, 1,            health.tick_mean_us(),             0, 0) \
+  X(tick_max_us,       "tick_max_us",     U32, 1,            health.tick_max_us(),              0, 0) \
+  X(jitter_ms,         "jitter_ms",       U16, 1,            health.jitter_ms(),                0, 0) \
+  X(stack_free,        "stack_free",      U16, 1,            health.stack_free(),               0, 0) \
+  X(ads_err,           "ads_err",         U16, ROW_EN_ADS,   health.counter(HEALTH_I2C_ADS),    0, 0) \
+  X(co2_err,           "co2_err",         U16, ROW_EN_CO2,   health.counter(HEALTH_I2C_CO2),    0, 0) \
+  X(bme_err,           "bme_err",         U16, ROW_EN_BME,   health.counter(HEALTH_I2C_BME),    0, 0) \
+  X(quad_err,          "quad_err",        U16, ROW_EN_QUAD,  health.counter(HEALTH_I2C_QUAD),   0, 0) \
+  X(sentinels,         "sentinels",       U16, 1,            health.counter(HEALTH_SENTINEL),   0, 0) \
+  X(pms_timeouts,      "pms_timeouts",    U16, ROW_EN_PMS,   health.counter(HEALTH_PMS_TIMEOUT), 0, 0) \
+  X(sd_retries,        "sd_retries",      U16, 1,            health.counter(HEALTH_SD_RETRY),   0, 0) \
+  X(sd_lost,           "sd_lost",         U16, ROW_EN_SPOOL, health.counter(HEALTH_SD_LOST),    0, 0) \
+  X(sd_queue,          "sd_queue",        U16, ROW_EN_SPOOL, sd_spool.count(),                  0, 0)
+
+// Change-based SD rows (SD_DEADBAND_ENABLED): how far a channel moves, in its record
+// units (before scale), before it is logged again - smaller moves log "=". Columns not
+// listed here log any change; averaged rows (STATS_ENABLED) band the means only
+#define XPOD_ROW_DEADBAND(X) \
+  X(in_volt,         0.05f)   /* V                          */ \
+  X(Fig1,            4)       /* ADS1115 counts: ~0.5 mV    */ \
+  X(Fig2,            4)                                        \
+  X(Fig3,            4)                                        \
+  X(Fig3_heater,     4)                                        \
+  X(Fig4,            4)                                        \
+  X(Fig4_heater,     4)                                        \
+  X(Mq,              4)                                        \
+  X(Pid,             4)                                        \
+  X(Misc2611,        4)                                        \
+  X(Auxiliary,       4)                                        \
+  X(Worker,          4)                                        \
+  X(CO2,             2)       /* ppm                        */ \
+  X(T,               0.05f)   /* C                          */ \
+  X(P,               5)       /* Pa (0.05 hPa)              */ \
+  X(RH,              0.2f)    /* %                          */ \
+  X(GR,              1000)    /* Ohm (1 kOhm)               */ \
+  X(QS1_C1,          3)       /* MCP3424 counts             */ \
+  X(QS1_C2,          3)                                        \
+  X(QS2_C1,          3)                                        \
+  X(QS2_C2,          3)                                        \
+  X(QS3_C1,          3)                                        \
+  X(QS3_C2,          3)                                        \
+  X(QS4_C1,          3)                                        \
+  X(QS4_C2,          3)
+
+/****************** EXPANSION HELPERS ********************/
+#define ROW_CAT(a, b)         ROW_CAT_I(a, b)
+#define ROW_CAT_I(a, b)       a##b
+
+// C type of each schema type
+#define ROW_CTYPE_U8          uint8_t
+#define ROW_CTYPE_U16         uint16_t
+#define ROW_CTYPE_I16         int16_t
+#define ROW_CTYPE_U32         uint32_t
+#define ROW_CTYPE_F32         float
+#define ROW_CTYPE_TIME        uint32_t
+
+// Most characters a value of each type prints (scaled U32: "42949672.95", F32: "-42949672.00")
+#define ROW_CHARS_U8          3
+#define ROW_CHARS_U16         5
+#define ROW_CHARS_I16         6
+#define ROW_CHARS_U32         11
+#define ROW_CHARS_F32         12
+#define ROW_CHARS_TIME        19
+
+// Averaged column set: every channel becomes mean (its own label), _sd, _min & _max -
+// mean & sd as F32 at the channel's scale, min & max in its own type. Sources are the
+// sketch's row_stats accumulators (stats_module.h); the timestamp stays one column.
+// Each expansion X used with XPOD_LOG_SCHEMA needs an X_STAT twin: ROW_STAT(X, ...)
+#define ROW_STAT(X, member, label, type, en, src, scale, valid) \
+  ROW_CAT(ROW_STAT_, type)(X, member, label, type, en, src, scale, valid)
+#define ROW_STAT_TIME(X, member, label, type, en, src, scale, valid) \
+  X(member, label, type, en, src, scale, valid)
+#define ROW_STAT_CHANNEL(X, member, label, type, en, src, scale, valid) \
+  X(member,       label,        F32,  en, row_stats.member.mean(),    scale, valid) \
+  X(member##_sd,  label "_sd",  F32,  en, row_stats.member.stddev(),  scale, valid) \
+  X(member##_min, label "_min", type, en, row_stats.member.minimum(), scale, valid) \
+  X(member##_max, label "_max", type, en, row_stats.member.maximum(), scale, valid)
+#define ROW_STAT_U8           ROW_STAT_CHANNEL
+#define ROW_STAT_U16          ROW_STAT_CHANNEL
+#define ROW_STAT_I16          ROW_STAT_CHANNEL
+#define ROW_STAT_U32          ROW_STAT_CHANNEL
+#define ROW_STAT_F32          ROW_STAT_CHANNEL
+
+// What actually gets logged: one column per channel, or the averaged set + sample counts,
+// then the timebase, PMS averaging, health & profile columns if those are on
+#if PMS_ENABLED && PMS_AVERAGE_ENABLED
+  #define XPOD_LOG_PMS(X)     XPOD_ROW_PMS(X)
+#else
+  #define XPOD_LOG_PMS(X)
+#endif //PMS_ENABLED && PMS_AVERAGE_ENABLED
+#if RTC_ENABLED && TIMEBASE_COLUMNS_ENABLED
+  #define XPOD_LOG_TIMEBASE(X) XPOD_ROW_TIMEBASE(X)
+#else
+  #define XPOD_LOG_TIMEBASE(X)
+#endif //RTC_ENABLED && TIMEBASE_COLUMNS_ENABLED
+#if HEALTH_ENABLED
+  #define XPOD_LOG_HEALTH(X)  XPOD_ROW_HEALTH(X)
+#else
+  #define XPOD_LOG_HEALTH(X)
+#endif //HEALTH_ENABLED
+#if PROFILE_ENABLED && PROFILE_COLUMNS_ENABLED
+  #define XPOD_LOG_PROFILE(X) XPOD_ROW_PROFILE(X)
+#else
+  #define XPOD_LOG_PROFILE(X)
+#endif //PROFILE_ENABLED && PROFILE_COLUMNS_ENABLED
+#if STATS_ENABLED
+  #define XPOD_LOG_SCHEMA(X)  XPOD_ROW_SCHEMA(X##_STAT) XPOD_ROW_COUNTS(X) XPOD_LOG_TIMEBASE(X) XPOD_LOG_PMS(X) \
+                              XPOD_LOG_HEALTH(X) XPOD_LOG_PROFILE(X)
+#else
+  #define XPOD_LOG_SCHEMA(X)  XPOD_ROW_SCHEMA(X) XPOD_LOG_TIMEBASE(X) XPOD_LOG_PMS(X) XPOD_LOG_HEALTH(X) \
+                              XPOD_LOG_PROFILE(X)
+#endif //STATS_ENABLED
+
+// Struct member - only enabled columns take space in the record
+#define ROW_MEMBER(member, label, type, en, src, scale, valid) \
+  ROW_CAT(ROW_MEMBER_, en)(member, type)
+#define ROW_MEMBER_1(member, type)    ROW_CTYPE_##type member;
+#define ROW_MEMBER_0(member, type)
+#define ROW_MEMBER_STAT(...)          ROW_STAT(ROW_MEMBER, __VA_ARGS__)
+
+// Number of columns
+#define ROW_COUNT(member, label, type, en, src, scale, valid)   +1
+#define ROW_COUNT_STAT(...)           ROW_STAT(ROW_COUNT, __VA_ARGS__)
+#define XPOD_LOG_COLUMNS      (0 XPOD_LOG_SCHEMA(ROW_COUNT))
+
+// Longest CSV text of a row: value (enabled columns) + ',' each
+#define ROW_TEXT_MAX(member, label, type, en, src, scale, valid) \
+  + ROW_CAT(ROW_TEXT_MAX_, en)(type) + 1
+#define ROW_TEXT_MAX_1(type)          ROW_CHARS_##type
+#define ROW_TEXT_MAX_0(type)          0
+#define ROW_TEXT_MAX_STAT(...)        ROW_STAT(ROW_TEXT_MAX, __VA_ARGS__)
+#define XPOD_LOG_TEXT_MAX     (0 XPOD_LOG_SCHEMA(ROW_TEXT_MAX))
+
+#endif //_ROW_SCHEMA_H
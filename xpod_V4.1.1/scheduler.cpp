@@ -0,0 +1,318 @@
+/*******************************************************************************
+ * @file    scheduler.cpp
+ * @brief   Cooperative fixed-tick task scheduler that replaces the delay()
+ *          driven loop(); every module runs as a start/poll/collect task
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include "scheduler.h"
+
+/**************************************************************************/
+ /*!
+ *    @brief  Scheduler object; clears the task table (unregistered tasks never run)
+ */
+/**************************************************************************/
+Scheduler::Scheduler()
+{
+  memset(task, 0, sizeof(task));
+  memset(offset, 0, sizeof(offset));
+  next_tick_ms = 0;
+  tick_count = 0;
+  late_ticks = 0;
+  last_late_ms = 0;
+  begin_ms = 0;
+  grid_ms = 0;
+  aligned = false;
+} //Scheduler()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Registers a task in its slot
+ *        @param  id          slot of the task (also its run order within a tick)
+ *        @param  name        short label used by report()
+ *        @param  period_ms   time between the starts of two cycles (0 = back to back)
+ *        @param  offset_ms   delay of the first cycle after begin()
+ *        @param  start       kicks off the work (NULL if nothing to start)
+ *        @param  poll        returns true once ready (NULL = ready immediately)
+ *        @param  collect     pulls the results in; ends the cycle
+ */
+/**************************************************************************/
+void Scheduler::add(sched_task_id_e id, const char *name, uint32_t period_ms, uint32_t offset_ms,
+                    task_start_fn start, task_poll_fn poll, task_collect_fn collect)
+{
+  sched_task_t *t = &task[id];
+  t->name = name;
+  t->period_ms = period_ms;
+  t->start = start;
+  t->poll = poll;
+  t->collect = collect;
+  t->state = TASK_IDLE;
+  offset[id] = offset_ms;
+} //void Scheduler::add()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Aligns every task's first cycle to now (+ its offset)
+ */
+/**************************************************************************/
+void Scheduler::begin()
+{
+  begin_ms = millis();
+  grid_ms = begin_ms;
+  next_tick_ms = begin_ms;
+  for (int i = 0; i < SCHED_TASK_COUNT; i++)
+    task[i].due_ms = begin_ms + offset[i];
+} //void Scheduler::begin()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Runs one tick if SCHED_TICK_MS has elapsed; call from loop()
+ *    @return True if a tick ran, False if it was not time yet
+ */
+/**************************************************************************/
+bool Scheduler::run()
+{
+  uint32_t now = millis();
+  if ((int32_t)(now - next_tick_ms) < 0)
+    return false;
+
+  uint32_t late_ms = now - next_tick_ms;
+  last_late_ms = (late_ms > 0xFFFF) ? 0xFFFF : late_ms;
+  next_tick_ms += SCHED_TICK_MS;
+  if ((int32_t)(now - next_tick_ms) >= 0)  {
+    // A whole tick was missed (a step blocked) - don't try to catch up
+    late_ticks++;
+    next_tick_ms = now + SCHED_TICK_MS;
+  } //if ((int32_t)(now - next_tick_ms) >= 0)
+  tick_count++;
+
+  for (int i = 0; i < SCHED_TASK_COUNT; i++)
+  {
+    if (task[i].collect != NULL)
+      step(&task[i], now);
+  }
+  return true;
+} //bool Scheduler::run()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Moves every task's timing onto the RTC's second edges: frames then
+ *            start on unixtimes that are a multiple of SCHED_FRAME_MS (0 to
+ *            2 x SCHED_ALIGN_SLACK_MS after the edge, never before it), and the
+ *            ticks fall on the frame start. The first call moves frames earlier
+ *            by up to a whole one (one short frame), later ones only by the
+ *            drift of millis() - call on every edge
+ *        @param  edge_ms    millis() at the edge
+ *        @param  edge_unix  the second that started there
+ */
+/**************************************************************************/
+void Scheduler::align(uint32_t edge_ms, uint32_t edge_unix)
+{
+  const int32_t frame = SCHED_FRAME_MS;
+  uint32_t frame_start = edge_ms - (edge_unix % (frame / 1000)) * 1000UL + SCHED_ALIGN_SLACK_MS;
+  int32_t err = (int32_t)(frame_start - grid_ms) % frame;
+  if (!aligned)  {
+    // First edge: always earlier - the frame running now is cut short rather
+    // than a second (unixtime of the next row) skipped
+    if (err > SCHED_ALIGN_SLACK_MS)
+      err -= frame;
+    else if (err <= SCHED_ALIGN_SLACK_MS - frame)
+      err += frame;
+    aligned = true;
+  } else if (err >= frame / 2)  {
+    err -= frame;
+  } else if (err < -frame / 2)  {
+    err += frame;
+  } //if (!aligned)
+
+  if (err > SCHED_ALIGN_SLACK_MS || err < -SCHED_ALIGN_SLACK_MS)  {
+    grid_ms += err;
+    for (int i = 0; i < SCHED_TASK_COUNT; i++)
+      task[i].due_ms += err;
+  } //if (off the edge)
+
+  // Ticks on the grid too (a late tick restarts them off it); never earlier, so none is missed
+  int32_t phase = (int32_t)(grid_ms - next_tick_ms) % SCHED_TICK_MS;
+  if (phase < 0)
+    phase += SCHED_TICK_MS;
+  next_tick_ms += phase;
+} //void Scheduler::align()
+
+/**************************************************************************/
+ /*!
+ *    @brief  How long nothing needs the CPU (for sleeping through it).
+ *            Free-running tasks are due every tick - left out unless mid-cycle,
+ *            the caller knows if they have anything to do
+ *        @param  now  millis()
+ *    @return ms until the next periodic task is due (0: one is mid-cycle or late)
+ */
+/**************************************************************************/
+uint32_t Scheduler::quiet_ms(uint32_t now) const
+{
+  uint32_t quiet = 0xFFFFFFFF;
+  for (int i = 0; i < SCHED_TASK_COUNT; i++)
+  {
+    if (task[i].collect == NULL)
+      continue;
+    if (task[i].state != TASK_IDLE)
+      return 0;
+    if (task[i].period_ms == 0)
+      continue;
+    int32_t until = task[i].due_ms - now;
+    if (until <= 0)
+      return 0;
+    if ((uint32_t)until < quiet)
+      quiet = until;
+  }
+  return quiet;
+} //uint32_t Scheduler::quiet_ms()
+
+/**************************************************************************/
+ /*!
+ *    @brief  After a sleep with millis() moved on past the ticks that would
+ *            have run: the next tick is the first one still ahead, on the same
+ *            phase, and none of them counts as late
+ */
+/**************************************************************************/
+void Scheduler::resume()
+{
+  int32_t behind = millis() - next_tick_ms;
+  if (behind > 0)
+    next_tick_ms += ((uint32_t)behind + SCHED_TICK_MS - 1) / SCHED_TICK_MS * SCHED_TICK_MS;
+} //void Scheduler::resume()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Advances one task's state machine and updates its counters
+ *        @param  task  task to advance
+ *        @param  now   millis() at the start of the tick
+ */
+/**************************************************************************/
+void Scheduler::step(sched_task_t *task, uint32_t now)
+{
+  uint32_t t0 = micros();
+
+  if (task->state == TASK_IDLE)  {
+    if ((int32_t)(now - task->due_ms) < 0)
+      return;
+
+    if (task->period_ms == 0)  {
+      task->due_ms = now;       //free-running - never late
+    } else {
+      task->due_ms += task->period_ms;
+      if ((int32_t)(now - task->due_ms) >= 0)  {
+        // Previous cycle ran past its period - skip ahead instead of bunching up
+        task->stats.overruns++;
+        task->due_ms = now + task->period_ms;
+      } //if ((int32_t)(now - task->due_ms) >= 0)
+    } //if (task->period_ms == 0)
+
+    task->started_ms = millis();
+    if (task->start != NULL)
+      task->start();
+    task->state = TASK_POLLING;
+  } //if (task->state == TASK_IDLE)
+
+  if (task->poll == NULL || task->poll())  {
+    task->collect();
+    task->state = TASK_IDLE;
+
+    uint32_t done_ms = millis();
+    uint16_t cycle_ms = done_ms - task->started_ms;
+    task->stats.collected_ms = done_ms;
+    task->stats.cycles++;
+    task->stats.last_cycle_ms = cycle_ms;
+    if (cycle_ms > task->stats.max_cycle_ms)
+      task->stats.max_cycle_ms = cycle_ms;
+  } //if (task->poll == NULL || task->poll())
+
+  uint32_t step_us = micros() - t0;
+  task->stats.busy_us += step_us;
+  if (step_us > task->stats.max_step_us)
+    task->stats.max_step_us = (step_us > 0xFFFF) ? 0xFFFF : step_us;
+} //void Scheduler::step()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Timing counters for one task
+ *        @param  id  task slot
+ *    @return sched_stats_t of that task
+ */
+/**************************************************************************/
+const sched_stats_t &Scheduler::stats(sched_task_id_e id) const
+{
+  return task[id].stats;
+} //const sched_stats_t &Scheduler::stats()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Number of ticks run since boot
+ */
+/**************************************************************************/
+uint32_t Scheduler::ticks() const
+{
+  return tick_count;
+} //uint32_t Scheduler::ticks()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Number of ticks that started more than SCHED_TICK_MS late
+ */
+/**************************************************************************/
+uint16_t Scheduler::tick_overruns() const
+{
+  return late_ticks;
+} //uint16_t Scheduler::tick_overruns()
+
+/**************************************************************************/
+ /*!
+ *    @brief  How far after its SCHED_TICK_MS slot the latest tick started (ms)
+ */
+/**************************************************************************/
+uint16_t Scheduler::tick_late_ms() const
+{
+  return last_late_ms;
+} //uint16_t Scheduler::tick_late_ms()
+
+/**************************************************************************/
+ /*!
+ *    @brief  Prints one "#task,..." line per task so the cycle budget can be checked
+ *            Columns: name, cycles, overruns, last & max cycle (ms), max step (us),
+ *            CPU load (per mille of wall time since begin())
+ *        @param  out  where to print (Serial)
+ */
+/**************************************************************************/
+void Scheduler::report(Print &out) const
+{
+  uint32_t elapsed_ms = millis() - begin_ms;
+  if (elapsed_ms == 0)
+    elapsed_ms = 1;
+
+  out.println();
+  out.print(F("#sched,"));
+  out.print(tick_count);
+  out.print(F(","));
+  out.print(late_ticks);
+  for (int i = 0; i < SCHED_TASK_COUNT; i++)
+  {
+    const sched_task_t *t = &task[i];
+    if (t->collect == NULL)
+      continue;
+    out.println();
+    out.print(F("#task,"));
+    out.print(t->name);
+    out.print(F(","));
+    out.print(t->stats.cycles);
+    out.print(F(","));
+    out.print(t->stats.overruns);
+    out.print(F(","));
+    out.print(t->stats.last_cycle_ms);
+    out.print(F(","));
+    out.print(t->stats.max_cycle_ms);
+    out.print(F(","));
+    out.print(t->stats.max_step_us);
+    out.print(F(","));
+    out.print(t->stats.busy_us / elapsed_ms);   //us per ms == per mille
+  }
+} //void Scheduler::report()
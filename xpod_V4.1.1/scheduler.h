@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * @file    scheduler.h
+ * @brief   Cooperative fixed-tick task scheduler that replaces the delay()
+ *          driven loop(); every module runs as a start/poll/collect task
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "xpod_node.h"
+
+/****************** STRUCTS, OBJECTS ********************/
+/*! Index: one task per module plus the row stamp and the output sinks */
+enum sched_task_id_e
+{
+    #if RTC_ENABLED
+      TASK_TIME,
+    #endif //RTC_ENABLED
+    #if INPUTVOLT_ENABLED
+      TASK_VOLT,
+    #endif //INPUTVOLT_ENABLED
+    #if ADS_ENABLED
+      TASK_ADS,
+    #endif //ADS_ENABLED
+    #if CO2_ENABLED
+      TASK_CO2,
+    #endif //CO2_ENABLED
+    #if BME_ENABLED
+      TASK_BME,
+    #endif //BME_ENABLED
+    #if QUAD_ENABLED
+      TASK_QUAD,
+    #endif //QUAD_ENABLED
+    #if PMS_ENABLED
+      TASK_PMS,
+    #endif //PMS_ENABLED
+    TASK_ROW,
+    #if SD_ENABLED
+      TASK_SD,
+    #endif //SD_ENABLED
+    #if SERIAL_ENABLED
+      TASK_SERIAL,
+    #endif //SERIAL_ENABLED
+    #if SD_ENABLED && SD_PERSISTENT_ENABLED && SD_SPOOL_ENABLED
+      TASK_SD_SPOOL,              //after SERIAL: reuses the row buffer for backlog rows
+    #endif //SD_ENABLED && SD_PERSISTENT_ENABLED && SD_SPOOL_ENABLED
+    #if SD_ENABLED
+      #if SD_PERSISTENT_ENABLED && SD_ROLLOVER_ENABLED && RTC_ENABLED
+        TASK_SD_NEXT,
+      #endif //SD_PERSISTENT_ENABLED && SD_ROLLOVER_ENABLED && RTC_ENABLED
+    #endif //SD_ENABLED
+    #if SERIAL_ENABLED && SCHED_REPORT_ENABLED
+      TASK_REPORT,
+    #endif //SERIAL_ENABLED && SCHED_REPORT_ENABLED
+    #if SERIAL_ENABLED && PROFILE_ENABLED && !PROFILE_COLUMNS_ENABLED
+      TASK_PROFILE,
+    #endif //SERIAL_ENABLED && PROFILE_ENABLED && !PROFILE_COLUMNS_ENABLED
+    SCHED_TASK_COUNT
+}; //enum sched_task_id_e
+
+/*! Where a task is in its cycle: waiting for its period, or started & polling */
+enum sched_state_e
+{
+    TASK_IDLE = 0,
+    TASK_POLLING
+}; //enum sched_state_e
+
+typedef void (*task_start_fn)(void);    //kick off work (conversion, request, ...)
+typedef bool (*task_poll_fn)(void);     //true once the work is ready to collect
+typedef void (*task_collect_fn)(void);  //pull results into the row data
+
+/*! Per-task timing counters (cycle = start -> collect, step = one call) */
+struct sched_stats_t
+{
+    uint32_t cycles;          //completed start -> collect cycles
+    uint16_t overruns;        //cycles that started late or ran past period_ms
+    uint16_t last_cycle_ms;   //start -> collect latency of the last cycle
+    uint16_t max_cycle_ms;    //worst start -> collect latency
+    uint16_t max_step_us;     //worst CPU time of a single start/poll/collect call
+    uint32_t busy_us;         //CPU time spent inside this task since boot
+    uint32_t collected_ms;    //millis() of the last collect (the module's data is from then)
+}; //struct sched_stats_t
+
+/*! (per each task) name, period, start/poll/collect steps, state, counters */
+struct sched_task_t
+{
+    const char *name;
+    uint32_t period_ms;       //0 = free-running: next cycle starts as soon as this one is collected
+    task_start_fn start;      //may be NULL
+    task_poll_fn poll;        //may be NULL (collect straight after start)
+    task_collect_fn collect;
+    sched_state_e state;
+    uint32_t due_ms;          //when the next cycle should start
+    uint32_t started_ms;
+    sched_stats_t stats;
+}; //struct sched_task_t
+
+/****************** CLASSES ********************/
+/*! Runs every registered task once per SCHED_TICK_MS in sched_task_id_e order */
+class Scheduler {
+  public:
+    Scheduler();
+    void add(sched_task_id_e id, const char *name, uint32_t period_ms, uint32_t offset_ms,
+             task_start_fn start, task_poll_fn poll, task_collect_fn collect);
+    void begin();
+    bool run();
+    void align(uint32_t edge_ms, uint32_t edge_unix);
+    uint32_t quiet_ms(uint32_t now) const;
+    void resume();
+
+    const sched_stats_t &stats(sched_task_id_e id) const;
+    uint32_t ticks() const;
+    uint16_t tick_overruns() const;
+    uint16_t tick_late_ms() const;
+    void report(Print &out) const;
+
+  private:
+    void step(sched_task_t *task, uint32_t now);
+
+    sched_task_t task[SCHED_TASK_COUNT];
+    uint32_t offset[SCHED_TASK_COUNT];
+    uint32_t next_tick_ms;
+    uint32_t tick_count;
+    uint16_t late_ticks;
+    uint16_t last_late_ms;
+    uint32_t begin_ms;
+    uint32_t grid_ms;           //a frame start: offsets & periods count from here
+    bool aligned;               //align() has moved it onto an edge
+};
+
+#endif //_SCHEDULER_H
@@ -0,0 +1,473 @@
+/*******************************************************************************
+ * @file    sd_module.cpp
+ * @brief   Keeps the daily CSV open all day; rows are staged in a RingBuf and
+ *          written to the card as whole 512 byte sectors
+ *
+ * @cite    SdFat RingBuf & preAllocate usage from SdFat's ExFatLogger/TeensySdioLogger
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ * @log     Oct 2026: next day's file created, preallocated & erased ahead (prepare(),
+ *          a step per call), open() at midnight then only swaps handles
+ *          Oct 2026: written() & commit() for the SD_SPOOL_ENABLED queue; reopening
+ *          the file a failed write dropped resumes at the last committed row
+ *          Oct 2026: only .BIN logs preallocated unless SD_PREALLOC_CSV_ENABLED - a
+ *          CSV on a card pulled mid-day is just its rows
+ ******************************************************************************/
+#include "sd_module.h"
+
+/**************************************************************************/
+ /*!
+ *    @brief  nothing mounted or open until begin()/open()
+ */
+/**************************************************************************/
+SD_Module::SD_Module()
+{
+  file = &slot[0];
+  spare = &slot[1];
+  spare_state = SD_SPARE_EMPTY;
+  open_name[0] = '\0';
+  spare_name[0] = '\0';
+  spare_end = 0;
+  commit_pos = 0;
+  resume_name[0] = '\0';
+  resume_pos = 0;
+  last_sync_ms = 0;
+  mounted = false;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Mounts the FAT volume (once - not every row like before)
+ *    @return true/false - did the card mount?
+ */
+/**************************************************************************/
+bool SD_Module::begin()
+{
+  mounted = sd.begin(SD_CS);
+  return mounted;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Opens (or creates) a log file and keeps it open. A new file gets a
+ *            contiguous SD_EXTENT_BYTES extent (if any) that is erased right away,
+ *            so the unwritten tail reads back as 0x00/0xFF; an existing file is resumed
+ *            at the end of its data (also after a power cut mid-day) - or, if a
+ *            failed write dropped it, at the last commit(): the rows after that
+ *            are written again over whatever part of them made it.
+ *            If prepare() already made this file, the handles are just swapped:
+ *            the previous file's staged tail is written out, the rest of its
+ *            close waits for the next prepare()
+ *        @param  file_name     name of the daily log
+ *        @param  record_bytes  1 for text, else the fixed record size (binary log)
+ *        @param  header_bytes  bytes before the first record (binary log)
+ *    @return true/false - is the file open & positioned for writing?
+ */
+/**************************************************************************/
+bool SD_Module::open(const char *file_name, uint16_t record_bytes, uint16_t header_bytes)
+{
+  if (spare_state == SD_SPARE_READY && strcmp(spare_name, file_name) == 0)  {
+    if (file->isOpen())
+      rb.sync();
+    File *previous = file;
+    file = spare;
+    spare = previous;
+    spare_state = spare->isOpen() ? SD_SPARE_RETIRED : SD_SPARE_EMPTY;
+    spare_end = spare->curPosition();
+    spare_name[0] = '\0';
+  } else {
+    close();
+    if (spare_state != SD_SPARE_RETIRED && strcmp(spare_name, file_name) == 0)
+      drop_spare();       //midnight came before prepare() was done with it
+    if (!mounted && !begin())
+      return false;
+
+    // no O_APPEND: with a preallocated extent the "end of file" is the extent's end
+    if (!file->open(file_name, O_RDWR | O_CREAT))  {
+      mounted = false;
+      return false;
+    } //if (!file->open(file_name, O_RDWR | O_CREAT))
+
+    if (SD_EXTENT_BYTES > 0 && file->fileSize() == 0 && file->preAllocate(SD_EXTENT_BYTES) && !erase_extent(file))
+      file->truncate(0);    //can't trust the tail - grow the file normally instead
+  } //if (prepared by prepare())
+
+  if (!find_end(record_bytes, header_bytes))  {
+    file->close();
+    return false;
+  } //if (!find_end(record_bytes, header_bytes))
+  if (strcmp(resume_name, file_name) == 0 && resume_pos < file->curPosition())
+    file->seekSet(resume_pos);
+  resume_name[0] = '\0';
+
+  rb.begin(file);
+  commit_pos = file->curPosition();
+  strncpy(open_name, file_name, sizeof(open_name) - 1);
+  open_name[sizeof(open_name) - 1] = '\0';
+  last_sync_ms = millis();
+  return true;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Gets the next log file (tomorrow's) ready in the spare handle, one
+ *            step per call so no call blocks long: create, preallocate, erase.
+ *            A previous day's file still waiting to be closed (after the swap)
+ *            goes first, its unused extent freed SD_TRIM_STEP_BYTES per call
+ *            (freeing 16 MB of clusters at once stalls like preallocating them).
+ *            Call it between rows
+ *        @param  file_name  name of the file open() will be asked for next
+ *                           (NULL: only close the previous day's file)
+ *    @return true once open(file_name) will only swap handles
+ */
+/**************************************************************************/
+bool SD_Module::prepare(const char *file_name)
+{
+  if (spare_state != SD_SPARE_EMPTY && spare_state != SD_SPARE_RETIRED &&
+      (file_name == NULL || strcmp(spare_name, file_name) != 0))
+    drop_spare();         //the date moved (RTC set) - not that file after all
+  if (spare_state == SD_SPARE_READY)
+    return true;
+  if (file->isBusy() || (file_name == NULL && spare_state != SD_SPARE_RETIRED))
+    return false;
+  if (spare_state != SD_SPARE_RETIRED && (!mounted || strcmp(open_name, file_name) == 0))
+    return false;
+
+  PROFILE_SCOPE(SD_OPEN);
+  switch (spare_state)
+  {
+    case SD_SPARE_RETIRED:
+      if (spare->fileSize() <= spare_end + SD_TRIM_STEP_BYTES ||
+          !spare->truncate(spare->fileSize() - SD_TRIM_STEP_BYTES))
+        drop_spare();       //last slice (or the card failed): trimmed to its data & closed
+      break;
+    case SD_SPARE_EMPTY:
+      if (!spare->open(file_name, O_RDWR | O_CREAT))
+        break;
+      strncpy(spare_name, file_name, sizeof(spare_name) - 1);
+      spare_name[sizeof(spare_name) - 1] = '\0';
+      // Already there (made before a reboot): open() resumes it as it is
+      spare_state = (spare->fileSize() == 0) ? SD_SPARE_CREATED : SD_SPARE_READY;
+      break;
+    case SD_SPARE_CREATED:
+      spare_state = (SD_EXTENT_BYTES > 0 && spare->preAllocate(SD_EXTENT_BYTES)) ? SD_SPARE_ALLOCATED : SD_SPARE_READY;
+      break;
+    case SD_SPARE_ALLOCATED:
+      if (!erase_extent(spare))
+        spare->truncate(0);
+      spare_state = SD_SPARE_READY;
+      break;
+    default:
+      break;
+  } //switch (spare_state)
+  return spare_state == SD_SPARE_READY;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Writes out everything staged, trims the unused part of the extent & closes
+ */
+/**************************************************************************/
+void SD_Module::close()
+{
+  if (file->isOpen())  {
+    PROFILE_SCOPE(SD_CLOSE);
+    rb.sync();
+    file->truncate();      //at the current position = end of the text
+    file->close();
+  } //if (file->isOpen())
+  open_name[0] = '\0';
+}
+
+/**************************************************************************/
+ /*!
+ *    @return true/false - is a log file open?
+ */
+/**************************************************************************/
+bool SD_Module::is_open()
+{
+  return file->isOpen();
+}
+
+/**************************************************************************/
+ /*!
+ *    @return name of the open log file ("" if none)
+ */
+/**************************************************************************/
+const char *SD_Module::name()
+{
+  return open_name;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return bytes logged to the open file so far (written + staged)
+ */
+/**************************************************************************/
+uint32_t SD_Module::length()
+{
+  return file->isOpen() ? file->curPosition() + rb.bytesUsed() : 0;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return bytes of the open file handed to the card (staged ones not included)
+ */
+/**************************************************************************/
+uint32_t SD_Module::written()
+{
+  return file->isOpen() ? file->curPosition() : 0;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Marks a row end (a length()) as on the card: if a write fails
+ *            later, open() of this file picks up from here
+ *        @param  pos  file offset, <= written()
+ */
+/**************************************************************************/
+void SD_Module::commit(uint32_t pos)
+{
+  commit_pos = pos;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Writes out the staged tail now (before the queue moves to another
+ *            day's file), so written() covers every row started so far
+ *    @return false if the card failed (the file is dropped, as in poll())
+ */
+/**************************************************************************/
+bool SD_Module::write_out()
+{
+  if (!file->isOpen())
+    return false;
+  if (rb.sync())
+    return true;
+  failed();
+  return false;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Stages a block bigger than a row (file header), writing out as it goes
+ *        @param  buf   bytes to write
+ *        @param  size  number of bytes
+ *    @return bytes staged (size unless the card failed)
+ */
+/**************************************************************************/
+size_t SD_Module::write(const uint8_t *buf, size_t size)
+{
+  size_t done = 0;
+  while (file->isOpen() && done < size)
+  {
+    if (rb.bytesFree() == 0 && rb.writeOut(rb.bytesUsed()) == 0)
+      break;
+    size_t n = size - done;
+    if (n > rb.bytesFree())
+      n = rb.bytesFree();
+    done += rb.write(buf + done, n);
+  }
+  return done;
+}
+
+size_t SD_Module::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  The RingBuf rows are printed into - same Print calls as a File
+ *    @return Print sink of the open file
+ */
+/**************************************************************************/
+Print &SD_Module::row()
+{
+  return rb;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Makes sure a whole row fits in the RingBuf (writes out now if it
+ *            doesn't, so a row is never cut in half)
+ *        @param  bytes  length of the row about to be printed
+ *    @return true/false - can the row be printed to row()?
+ */
+/**************************************************************************/
+bool SD_Module::start_row(size_t bytes)
+{
+  if (!file->isOpen())
+    return false;
+
+  if (rb.bytesFree() < bytes)  {
+    PROFILE_SCOPE(SD_WRITE);
+    size_t n = rb.bytesUsed();
+    if (rb.writeOut(n) != n)  {
+      failed();
+      return false;
+    } //if (rb.writeOut(n) != n)
+  } //if (rb.bytesFree() < bytes)
+  return rb.bytesFree() >= bytes;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Writes out one full sector (first one tops up a partly written sector)
+ *            when the RingBuf has one and the card isn't busy
+ *    @return true once less than a sector is left staged
+ */
+/**************************************************************************/
+bool SD_Module::poll()
+{
+  if (!file->isOpen())
+    return true;
+
+  size_t n = SD_SECTOR_BYTES - (file->curPosition() & (SD_SECTOR_BYTES - 1));
+  if (rb.bytesUsed() < n)
+    return true;
+  if (file->isBusy())
+    return false;
+
+  size_t written;
+  {
+    PROFILE_SCOPE(SD_WRITE);
+    written = rb.writeOut(n);
+  }
+  if (written != n)  {
+    failed();
+    return true;
+  } //if (rb.writeOut(n) != n)
+
+  return false;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Sync policy: every SD_SYNC_MS the staged tail is written & the
+ *            directory entry updated, bounding what a power cut can lose
+ */
+/**************************************************************************/
+void SD_Module::collect()
+{
+  if (!file->isOpen() || (millis() - last_sync_ms) < SD_SYNC_MS)
+    return;
+
+  PROFILE_SCOPE(SD_SYNC);
+  if (!rb.sync() || !file->sync())
+    failed();
+  last_sync_ms = millis();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Seeks to the end of the data: text never holds 0x00/0xFF and a
+ *            binary record always starts with XPOD_BIN_SYNC, while the erased
+ *            extent is nothing but 0x00/0xFF - so binary search for the first
+ *            erased record (a byte, for text)
+ *        @param  record_bytes  record size (1 for text)
+ *        @param  header_bytes  bytes before the first record
+ *    @return true/false - did the seeks/reads work?
+ */
+/**************************************************************************/
+bool SD_Module::find_end(uint16_t record_bytes, uint16_t header_bytes)
+{
+  uint32_t size = file->fileSize();
+  bool erased;
+
+  // Fresh extent (or empty file): header & all still to be written
+  if (size == 0)
+    return file->seekSet(0);
+  if (!erased_at(0, &erased))
+    return false;
+  if (erased || size <= header_bytes)
+    return file->seekSet(erased ? 0 : size);
+
+  uint32_t lo = 0;                                      //records before lo hold data
+  uint32_t hi = (size - header_bytes) / record_bytes;   //records from hi on are erased
+  while (lo < hi)
+  {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (!erased_at(header_bytes + mid * record_bytes, &erased))
+      return false;
+
+    if (erased)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return file->seekSet(header_bytes + lo * record_bytes);
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Reads one byte of the file
+ *        @param  pos     file offset
+ *        @param  erased  set true if the byte is 0x00/0xFF
+ *    @return true/false - did the seek/read work?
+ */
+/**************************************************************************/
+bool SD_Module::erased_at(uint32_t pos, bool *erased)
+{
+  if (!file->seekSet(pos))
+    return false;
+  int c = file->read();
+  if (c < 0)
+    return false;
+  *erased = (c == 0x00 || c == 0xFF);
+  return true;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Erases a just preallocated extent, so its unwritten tail reads back
+ *            as 0x00/0xFF (find_end())
+ *        @param  f  file holding nothing but the extent
+ *    @return true/false - is the whole extent erased?
+ */
+/**************************************************************************/
+bool SD_Module::erase_extent(File *f)
+{
+  uint32_t first_sector, last_sector;
+  return f->contiguousRange(&first_sector, &last_sector) && sd.card()->erase(first_sector, last_sector);
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Empties the spare handle: a retired file is trimmed & closed like
+ *            close(), a part-made one removed (its extent isn't erased yet)
+ */
+/**************************************************************************/
+void SD_Module::drop_spare()
+{
+  if (spare_state == SD_SPARE_RETIRED)  {
+    PROFILE_SCOPE(SD_CLOSE);
+    spare->truncate(spare_end);   //truncate(length) moves the position: not truncate()
+    spare->close();
+  } else if (spare_state == SD_SPARE_READY)  {
+    spare->close();
+  } else if (spare->isOpen())  {
+    spare->remove();
+  } //if (spare_state)
+  spare_state = SD_SPARE_EMPTY;
+  spare_name[0] = '\0';
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Card went away (a write or sync failed): drops the handles & the
+ *            mount - the next open() remounts - and notes where to resume
+ */
+/**************************************************************************/
+void SD_Module::failed()
+{
+  file->close();
+  strcpy(resume_name, open_name);
+  resume_pos = commit_pos;
+  open_name[0] = '\0';
+  spare->close();
+  spare_state = SD_SPARE_EMPTY;
+  spare_name[0] = '\0';
+  mounted = false;
+}
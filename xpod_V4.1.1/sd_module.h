@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * @file    sd_module.h
+ * @brief   Keeps the daily CSV open all day; rows are staged in a RingBuf and
+ *          written to the card as whole 512 byte sectors
+ *
+ * @cite    SdFat RingBuf & preAllocate usage from SdFat's ExFatLogger/TeensySdioLogger
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ * @log     Oct 2026: next day's file created, preallocated & erased ahead (prepare(),
+ *          a step per call), open() at midnight then only swaps handles
+ *          Oct 2026: written(), commit() & write_out() for the SD_SPOOL_ENABLED queue; reopening
+ *          the file a failed write dropped resumes at the last committed row
+ *          Oct 2026: only .BIN logs preallocated unless SD_PREALLOC_CSV_ENABLED - a
+ *          CSV on a card pulled mid-day is just its rows
+ ******************************************************************************/
+#ifndef _SD_MODULE_H
+#define _SD_MODULE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <SdFat.h>
+#include <RingBuf.h>
+
+#include "xpod_node.h"
+#include "profile_module.h"
+
+/****************** SET ADDR & CONST ********************/
+#define SD_SECTOR_BYTES       512
+#if SD_BINARY_ENABLED || SD_PREALLOC_CSV_ENABLED
+  #define SD_EXTENT_BYTES     SD_PREALLOC_BYTES
+#else
+  #define SD_EXTENT_BYTES     0UL   //CSV grows row by row: a pulled card shows just the rows
+#endif //SD_BINARY_ENABLED || SD_PREALLOC_CSV_ENABLED
+
+/****************** STRUCTS, OBJECTS ********************/
+/*! What the spare handle holds: next day's file (a step further each prepare())
+ *  or, after the swap, the previous day's file until prepare() trims & closes it */
+enum sd_spare_e
+{
+  SD_SPARE_EMPTY,
+  SD_SPARE_CREATED,           //directory entry made
+  SD_SPARE_ALLOCATED,         //extent preallocated
+  SD_SPARE_READY,             //extent erased (or none, or an existing file): open() swaps to it
+  SD_SPARE_RETIRED            //previous day's file, still to be trimmed (a slice each) & closed
+}; //enum sd_spare_e
+
+/****************** CLASSES ********************/
+/*! Persistent (.BIN: preallocated) daily log file with RingBuf-backed writes.
+ *  As a Print it takes blocks bigger than a row (file header) */
+class SD_Module : public Print {
+  public:
+    SD_Module();
+    bool begin();
+    bool open(const char *file_name, uint16_t record_bytes = 1, uint16_t header_bytes = 0);
+    void close();
+    bool prepare(const char *file_name);
+    bool is_open();
+    const char *name();
+    uint32_t length();
+    uint32_t written();
+    void commit(uint32_t pos);
+    bool write_out();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buf, size_t size);
+    using Print::write;
+
+    Print &row();           //print the row here (between start_row() and poll())
+    bool start_row(size_t bytes);
+    bool poll();
+    void collect();
+
+  private:
+    bool find_end(uint16_t record_bytes, uint16_t header_bytes);
+    bool erased_at(uint32_t pos, bool *erased);
+    bool erase_extent(File *f);
+    void drop_spare();
+    void failed();
+
+    SdFat sd;
+    File slot[2];
+    File *file;                 //the log being written
+    File *spare;                //see sd_spare_e
+    sd_spare_e spare_state;
+    RingBuf<File, SD_RINGBUF_BYTES> rb;
+    char open_name[32];
+    char spare_name[32];
+    uint32_t spare_end;         //SD_SPARE_RETIRED: end of its data (the extent is trimmed down to it)
+    uint32_t commit_pos;        //end of the last row known to be on the card
+    char resume_name[32];       //file a failed write dropped...
+    uint32_t resume_pos;        //...and its commit_pos then
+    uint32_t last_sync_ms;
+    bool mounted;
+};
+
+#endif //_SD_MODULE_H
@@ -0,0 +1,336 @@
+/*******************************************************************************
+ * @file    spool_module.cpp
+ * @brief   Write-behind queue of log records for SD outages: a RAM ring in front
+ *          of a non-volatile ring (the Mega's EEPROM, or an SPI FRAM) that the
+ *          oldest records spill to while the card is out
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include "spool_module.h"
+
+#if SD_SPOOL_FRAM_ENABLED
+  #include <SPI.h>
+#else
+  #include <EEPROM.h>
+  #include <avr/eeprom.h>
+#endif //SD_SPOOL_FRAM_ENABLED
+
+/**************************************************************************/
+ /*!
+ *    @brief  Empty until begin() finds what was spilled before a reset
+ */
+/**************************************************************************/
+Row_Spool::Row_Spool()
+{
+  ram_head = 0;
+  ram_count = 0;
+  nv_head = 0;
+  nv_tail = 0;
+  nv_freed = 0;
+  nv_seq = 1;
+  spill_pos = 0;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Picks up the non-volatile ring left by the last run (its records
+ *            come first): the longest run of slots whose sequence bytes follow
+ *            on from each other. A live slot outside it (a write cut short by a
+ *            reset) is freed; a blank or foreign memory (other record size) has
+ *            every live-looking slot freed
+ */
+/**************************************************************************/
+void Row_Spool::begin()
+{
+  #if SD_SPOOL_FRAM_ENABLED
+    pinMode(SD_SPOOL_FRAM_CS, OUTPUT);
+    digitalWrite(SD_SPOOL_FRAM_CS, HIGH);
+    SPI.begin();
+  #endif //SD_SPOOL_FRAM_ENABLED
+
+  uint8_t magic;
+  nv_read(SPOOL_NV_BASE + SPOOL_HDR_MAGIC, &magic, 1);
+  bool foreign = (magic != SPOOL_MAGIC || nv_read16(SPOOL_NV_BASE + SPOOL_HDR_RECORD) != SPOOL_REC_BYTES);
+
+  uint16_t best = 0;
+  nv_head = 0;
+  nv_tail = 0;
+  nv_seq = 1;
+  for (uint16_t slot = 0; slot < SPOOL_NV_SLOTS && !foreign; slot++)
+  {
+    uint8_t seq = slot_seq(slot);
+    uint8_t before = slot_seq((slot + SPOOL_NV_SLOTS - 1) % SPOOL_NV_SLOTS);
+    if (!seq_live(seq) || (seq_live(before) && seq_next(before) == seq))
+      continue;                 //not where a run starts
+
+    uint16_t length = 1;
+    while (length < SPOOL_NV_SLOTS - 1 && slot_seq((slot + length) % SPOOL_NV_SLOTS) == seq_next(seq))
+    {
+      seq = seq_next(seq);
+      length++;
+    }
+    if (length > best)  {
+      best = length;
+      nv_head = slot;
+      nv_tail = (slot + length) % SPOOL_NV_SLOTS;
+      nv_seq = seq_next(seq);
+    } //if (length > best)
+  }
+
+  for (uint16_t i = best; i < SPOOL_NV_SLOTS; i++)
+  {
+    uint16_t slot = (nv_head + i) % SPOOL_NV_SLOTS;
+    if (seq_live(slot_seq(slot)))
+      slot_free(slot);
+  }
+  nv_freed = nv_head;
+
+  if (foreign)  {
+    nv_write16(SPOOL_NV_BASE + SPOOL_HDR_RECORD, SPOOL_REC_BYTES);
+    magic = SPOOL_MAGIC;
+    nv_write(SPOOL_NV_BASE + SPOOL_HDR_MAGIC, &magic, 1);
+  } //if (foreign)
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Queues the newest record in RAM
+ *        @param  rec  the row
+ *    @return false if RAM is full (the row is lost)
+ */
+/**************************************************************************/
+bool Row_Spool::push(const xpod_record_t &rec)
+{
+  if (ram_count >= SD_SPOOL_RAM_ROWS)
+    return false;
+  ram[(ram_head + ram_count) % SD_SPOOL_RAM_ROWS] = rec;
+  ram_count++;
+  return true;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Copies out a queued record
+ *        @param  i    0 = oldest, < count()
+ *        @param  rec  where it goes
+ */
+/**************************************************************************/
+void Row_Spool::get(uint16_t i, xpod_record_t &rec)
+{
+  uint16_t spilled = stored();
+  if (i < spilled)  {
+    memset(rec.raw, 0, sizeof(rec.raw));
+    nv_read(nv_slot_addr((nv_head + i) % SPOOL_NV_SLOTS) + SPOOL_SLOT_DATA, rec.raw, SPOOL_REC_BYTES);
+  } else {
+    rec = ram[(ram_head + i - spilled) % SD_SPOOL_RAM_ROWS];
+  } //if (i < spilled)
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Drops the n oldest records (the card has them). Spilled ones only
+ *            leave the ring in RAM here; tidy() frees their slots after
+ *        @param  n  how many, <= count()
+ */
+/**************************************************************************/
+void Row_Spool::pop(uint16_t n)
+{
+  uint16_t spilled = stored();
+  uint16_t from_nv = (n < spilled) ? n : spilled;
+  if (from_nv > 0)  {
+    nv_head = (nv_head + from_nv) % SPOOL_NV_SLOTS;
+    n -= from_nv;
+  } //if (from_nv > 0)
+  if (n > ram_count)
+    n = ram_count;
+  if (n > 0)  {
+    ram_head = (ram_head + n) % SD_SPOOL_RAM_ROWS;
+    ram_count -= n;
+    spill_pos = 0;            //the record being spilled is gone
+  } //if (n > 0)
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Moves the oldest RAM record on into the non-volatile ring, as far
+ *            as the memory is ready for it: SPOOL_NV_STEP bytes at a time (an
+ *            EEPROM byte that didn't change costs no write cycle), then the
+ *            slot's sequence byte. Never waits - call every tick while the card is out
+ *    @return true if there is still something to spill (and room for it)
+ */
+/**************************************************************************/
+bool Row_Spool::spill()
+{
+  tidy();
+  if (ram_count == 0 || (nv_tail + 1) % SPOOL_NV_SLOTS == nv_freed)
+    return false;
+  uint16_t addr = nv_slot_addr(nv_tail);
+  while (spill_pos < SPOOL_REC_BYTES && nv_ready())
+  {
+    uint16_t n = SPOOL_REC_BYTES - spill_pos;
+    if (n > SPOOL_NV_STEP)
+      n = SPOOL_NV_STEP;
+    nv_write(addr + SPOOL_SLOT_DATA + spill_pos, ram[ram_head].raw + spill_pos, n);
+    spill_pos += n;
+  }
+  if (spill_pos < SPOOL_REC_BYTES || !nv_ready())
+    return true;
+
+  // Whole record in its slot: the sequence byte makes it part of the ring (one write)
+  nv_write(addr + SPOOL_SLOT_SEQ, &nv_seq, 1);
+  nv_seq = seq_next(nv_seq);
+  nv_tail = (nv_tail + 1) % SPOOL_NV_SLOTS;
+  ram_head = (ram_head + 1) % SD_SPOOL_RAM_ROWS;
+  ram_count--;
+  spill_pos = 0;
+  return ram_count > 0;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Frees the slots pop() dropped (sequence byte 0), as far as the
+ *            memory is ready for it - an EEPROM write each. Never waits - call
+ *            every tick. A reset before it gets there replays those records again
+ */
+/**************************************************************************/
+void Row_Spool::tidy()
+{
+  while (nv_freed != nv_head && nv_ready())
+  {
+    slot_free(nv_freed);
+    nv_freed = (nv_freed + 1) % SPOOL_NV_SLOTS;
+  }
+}
+
+/**************************************************************************/
+ /*!
+ *    @return records queued (spilled + RAM)
+ */
+/**************************************************************************/
+uint16_t Row_Spool::count()
+{
+  return stored() + ram_count;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return records in the non-volatile ring
+ */
+/**************************************************************************/
+uint16_t Row_Spool::stored()
+{
+  return (nv_tail + SPOOL_NV_SLOTS - nv_head) % SPOOL_NV_SLOTS;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return address of a slot in the non-volatile memory
+ */
+/**************************************************************************/
+uint16_t Row_Spool::nv_slot_addr(uint16_t slot)
+{
+  return SPOOL_NV_BASE + SPOOL_HDR_BYTES + slot * SPOOL_SLOT_BYTES;
+}
+
+uint8_t Row_Spool::slot_seq(uint16_t slot)
+{
+  uint8_t seq;
+  nv_read(nv_slot_addr(slot) + SPOOL_SLOT_SEQ, &seq, 1);
+  return seq;
+}
+
+void Row_Spool::slot_free(uint16_t slot)
+{
+  uint8_t seq = 0;
+  nv_write(nv_slot_addr(slot) + SPOOL_SLOT_SEQ, &seq, 1);
+}
+
+uint16_t Row_Spool::nv_read16(uint16_t addr)
+{
+  uint8_t b[2];
+  nv_read(addr, b, 2);
+  return b[0] | ((uint16_t)b[1] << 8);
+}
+
+// Only the header's record size, when the ring is made
+void Row_Spool::nv_write16(uint16_t addr, uint16_t v)
+{
+  uint8_t b[2] = {(uint8_t)v, (uint8_t)(v >> 8)};
+  nv_write(addr, b, 2);
+}
+
+#if SD_SPOOL_FRAM_ENABLED
+  /**************************************************************************/
+   /*!
+   *    @brief  FRAM read: opcode, 2 address bytes, then the data
+   */
+  /**************************************************************************/
+  void Row_Spool::nv_read(uint16_t addr, uint8_t *buf, uint16_t n)
+  {
+    SPI.beginTransaction(SPISettings(FRAM_SPI_HZ, MSBFIRST, SPI_MODE0));
+    digitalWrite(SD_SPOOL_FRAM_CS, LOW);
+    SPI.transfer(FRAM_READ);
+    SPI.transfer(addr >> 8);
+    SPI.transfer(addr & 0xFF);
+    for (uint16_t i = 0; i < n; i++)
+      buf[i] = SPI.transfer(0);
+    digitalWrite(SD_SPOOL_FRAM_CS, HIGH);
+    SPI.endTransaction();
+  }
+
+  /**************************************************************************/
+   /*!
+   *    @brief  FRAM write: write enable, then opcode, 2 address bytes & the data
+   *            (no write cycle to wait for)
+   */
+  /**************************************************************************/
+  void Row_Spool::nv_write(uint16_t addr, const uint8_t *buf, uint16_t n)
+  {
+    SPI.beginTransaction(SPISettings(FRAM_SPI_HZ, MSBFIRST, SPI_MODE0));
+    digitalWrite(SD_SPOOL_FRAM_CS, LOW);
+    SPI.transfer(FRAM_WREN);
+    digitalWrite(SD_SPOOL_FRAM_CS, HIGH);
+    digitalWrite(SD_SPOOL_FRAM_CS, LOW);
+    SPI.transfer(FRAM_WRITE);
+    SPI.transfer(addr >> 8);
+    SPI.transfer(addr & 0xFF);
+    for (uint16_t i = 0; i < n; i++)
+      SPI.transfer(buf[i]);
+    digitalWrite(SD_SPOOL_FRAM_CS, HIGH);
+    SPI.endTransaction();
+  }
+
+  bool Row_Spool::nv_ready()
+  {
+    return true;
+  }
+#else
+  /**************************************************************************/
+   /*!
+   *    @brief  EEPROM read (waits for a byte write still in progress)
+   */
+  /**************************************************************************/
+  void Row_Spool::nv_read(uint16_t addr, uint8_t *buf, uint16_t n)
+  {
+    for (uint16_t i = 0; i < n; i++)
+      buf[i] = EEPROM.read(addr + i);
+  }
+
+  /**************************************************************************/
+   /*!
+   *    @brief  EEPROM write of the bytes that differ - each one after the
+   *            last finished (3.4 ms), so spill() writes up to one per call
+   */
+  /**************************************************************************/
+  void Row_Spool::nv_write(uint16_t addr, const uint8_t *buf, uint16_t n)
+  {
+    for (uint16_t i = 0; i < n; i++)
+      EEPROM.update(addr + i, buf[i]);
+  }
+
+  bool Row_Spool::nv_ready()
+  {
+    return eeprom_is_ready();
+  }
+#endif //SD_SPOOL_FRAM_ENABLED
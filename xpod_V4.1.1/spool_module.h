@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * @file    spool_module.h
+ * @brief   Write-behind queue of log records for SD outages: a RAM ring in front
+ *          of a non-volatile ring (the Mega's EEPROM, or an SPI FRAM) that the
+ *          oldest records spill to while the card is out. Records leave only
+ *          once the card has them, oldest first
+ *
+ * @cite    MB85RS64V datasheet (opcodes); eeprom_is_ready() from avr-libc
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _SPOOL_MODULE_H
+#define _SPOOL_MODULE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "xpod_node.h"
+#include "record_module.h"
+
+/****************** SET ADDR & CONST ********************/
+// Non-volatile ring: header, then SPOOL_NV_SLOTS slots (one kept free), each a
+// sequence byte and the record's fields - not the padding up to XPOD_RECORD_BYTES.
+// No head/tail cells to wear out: a slot is in the ring while its sequence byte
+// is live, and begin() finds the ring as the longest run of consecutive ones
+#define SPOOL_MAGIC           0x5B
+#define SPOOL_REC_BYTES       sizeof(xpod_fields_t)
+#define SPOOL_HDR_MAGIC       0     //SPOOL_MAGIC
+#define SPOOL_HDR_RECORD      1     //uint16_t SPOOL_REC_BYTES (else the ring is from another build)
+#define SPOOL_HDR_BYTES       4
+#define SPOOL_SLOT_SEQ        0     //1-254 (SPOOL_SEQ_MAX): in the ring; 0 replayed, 0xFF erased
+#define SPOOL_SLOT_DATA       1     //the record's fields
+#define SPOOL_SLOT_BYTES      (SPOOL_SLOT_DATA + SPOOL_REC_BYTES)
+#define SPOOL_SEQ_MAX         254
+#if SD_SPOOL_FRAM_ENABLED
+  #define SPOOL_NV_BYTES      SD_SPOOL_FRAM_BYTES
+  #define SPOOL_NV_BASE       0
+  #define SPOOL_NV_STEP       SPOOL_REC_BYTES     //FRAM writes at bus speed: a record per spill()
+#else
+  #define SPOOL_NV_BYTES      (4096 - SD_SPOOL_NV_ADDR)
+  #define SPOOL_NV_BASE       SD_SPOOL_NV_ADDR
+  #define SPOOL_NV_STEP       1                   //EEPROM: a byte at a time, 3.4 ms each in the background
+#endif //SD_SPOOL_FRAM_ENABLED
+#define SPOOL_NV_SLOTS        ((SPOOL_NV_BYTES - SPOOL_HDR_BYTES) / SPOOL_SLOT_BYTES)
+
+// FRAM (MB85RS64V & pin-compatible parts, 2 address bytes)
+#define FRAM_WREN             0x06
+#define FRAM_READ             0x03
+#define FRAM_WRITE            0x02
+#define FRAM_SPI_HZ           8000000
+
+static_assert(SPOOL_NV_SLOTS >= 2, "no room for the spool's non-volatile ring");
+
+/****************** CLASSES ********************/
+/*! FIFO of whole records: index 0 is the oldest, in the non-volatile ring
+ *  first (spilled), then in RAM. Survives a reset as far as it had spilled */
+class Row_Spool {
+  public:
+    Row_Spool();
+    void begin();
+    bool push(const xpod_record_t &rec);
+    void get(uint16_t i, xpod_record_t &rec);
+    void pop(uint16_t n);
+    bool spill();
+    void tidy();
+    uint16_t count();
+    uint16_t stored();
+
+  private:
+    static bool seq_live(uint8_t seq)   { return seq != 0 && seq <= SPOOL_SEQ_MAX; }
+    static uint8_t seq_next(uint8_t seq)  { return seq % SPOOL_SEQ_MAX + 1; }
+    uint8_t slot_seq(uint16_t slot);
+    void slot_free(uint16_t slot);
+    uint16_t nv_slot_addr(uint16_t slot);
+    void nv_read(uint16_t addr, uint8_t *buf, uint16_t n);
+    void nv_write(uint16_t addr, const uint8_t *buf, uint16_t n);
+    bool nv_ready();
+    uint16_t nv_read16(uint16_t addr);
+    void nv_write16(uint16_t addr, uint16_t v);
+
+    xpod_record_t ram[SD_SPOOL_RAM_ROWS];
+    uint8_t ram_head;           //oldest RAM record
+    uint8_t ram_count;
+    uint16_t nv_head;           //oldest spilled record (slot)
+    uint16_t nv_tail;           //next free slot
+    uint16_t nv_freed;          //first slot pop() dropped that tidy() hasn't freed yet (nv_head: none)
+    uint8_t nv_seq;             //sequence byte of the next record spilled
+    uint16_t spill_pos;         //bytes of ram[ram_head] copied into slot nv_tail so far
+};
+
+#endif //_SPOOL_MODULE_H
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * @file    stats_module.cpp
+ * @brief   Constant-memory running statistics for averaged rows (STATS_ENABLED):
+ *          every module sample is folded into one Running_Stat per channel and
+ *          each row logs mean/sd/min/max + sample count for its LOG_PERIOD_MS
+ *
+ * @cite    Welford's online mean/variance (Knuth TAOCP vol. 2, 4.2.2)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include "stats_module.h"
+
+/**************************************************************************/
+ /*!
+ *    @brief  Empty accumulator
+ */
+/**************************************************************************/
+Running_Stat::Running_Stat()
+{
+  reset();
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Forgets every sample (start of the next interval)
+ */
+/**************************************************************************/
+void Running_Stat::reset()
+{
+  n = 0;
+  avg = 0.0f;
+  m2 = 0.0f;
+  lo = 0.0f;
+  hi = 0.0f;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Folds one sample in. Welford's update keeps the variance accurate
+ *            in float - no sum of squares to cancel against (ADS counts ~ 2^15)
+ *        @param  x  sample
+ */
+/**************************************************************************/
+void Running_Stat::add(float x)
+{
+  if (n == 0xFFFF)
+    return;
+
+  if (n == 0)  {
+    lo = x;
+    hi = x;
+  } else {
+    if (x < lo)
+      lo = x;
+    if (x > hi)
+      hi = x;
+  } //if (n == 0)
+
+  n++;
+  float delta = x - avg;
+  avg += delta / n;
+  m2 += delta * (x - avg);
+}
+
+/**************************************************************************/
+ /*!
+ *    @return samples in the interval
+ */
+/**************************************************************************/
+uint16_t Running_Stat::count()
+{
+  return n;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return mean of the interval (0 if no samples)
+ */
+/**************************************************************************/
+float Running_Stat::mean()
+{
+  return avg;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return sample standard deviation (0 with fewer than 2 samples)
+ */
+/**************************************************************************/
+float Running_Stat::stddev()
+{
+  return (n > 1) ? sqrt(m2 / (n - 1)) : 0.0f;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return smallest sample of the interval
+ */
+/**************************************************************************/
+float Running_Stat::minimum()
+{
+  return lo;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return largest sample of the interval
+ */
+/**************************************************************************/
+float Running_Stat::maximum()
+{
+  return hi;
+}
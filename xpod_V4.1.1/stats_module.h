@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * @file    stats_module.h
+ * @brief   Constant-memory running statistics for averaged rows (STATS_ENABLED):
+ *          every module sample is folded into one Running_Stat per channel and
+ *          each row logs mean/sd/min/max + sample count for its LOG_PERIOD_MS
+ *
+ * @cite    Welford's online mean/variance (Knuth TAOCP vol. 2, 4.2.2)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _STATS_MODULE_H
+#define _STATS_MODULE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "xpod_node.h"
+#include "row_schema.h"
+
+/****************** CLASSES ********************/
+/*! Count, mean, variance (Welford), min & max of one channel - 18 bytes */
+class Running_Stat {
+  public:
+    Running_Stat();
+    void reset();
+    void add(float x);
+
+    uint16_t count();
+    float mean();
+    float stddev();
+    float minimum();
+    float maximum();
+
+  private:
+    uint16_t n;       //stops at 0xFFFF - later samples are dropped
+    float avg;
+    float m2;         //sum of squared differences from the mean
+    float lo;
+    float hi;
+};
+
+/****************** STRUCTS, OBJECTS ********************/
+// One accumulator per enabled, non-timestamp column
+#define ROW_STAT_MEMBER(member, label, type, en, src, scale, valid) \
+  ROW_CAT(ROW_STAT_MEMBER_, en)(member, type)
+#define ROW_STAT_MEMBER_1(member, type)   ROW_STAT_MEMBER_##type(member)
+#define ROW_STAT_MEMBER_0(member, type)
+#define ROW_STAT_MEMBER_TIME(member)
+#define ROW_STAT_MEMBER_U8(member)        Running_Stat member;
+#define ROW_STAT_MEMBER_U16(member)       Running_Stat member;
+#define ROW_STAT_MEMBER_I16(member)       Running_Stat member;
+#define ROW_STAT_MEMBER_U32(member)       Running_Stat member;
+#define ROW_STAT_MEMBER_F32(member)       Running_Stat member;
+
+/*! The interval's statistics, one member per channel (named as in xpod_fields_t) */
+struct xpod_stats_t
+{
+  XPOD_ROW_SCHEMA(ROW_STAT_MEMBER)
+};
+
+// Sampler - expanded in the sketch (where the sources live) as XPOD_ROW_SCHEMA(ROW_ACCUMULATE)
+// with the XPOD_REC_* bits of the module that just collected in scope as "module"
+#define ROW_ACCUMULATE(member, label, type, en, src, scale, valid) \
+  ROW_CAT(ROW_ACCUMULATE_, en)(member, type, src, valid)
+#define ROW_ACCUMULATE_1(member, type, src, valid)  ROW_ACCUMULATE_##type(member, src, valid)
+#define ROW_ACCUMULATE_0(member, type, src, valid)
+#define ROW_ACCUMULATE_TIME(member, src, valid)
+#define ROW_ACCUMULATE_ANY(member, src, valid) \
+  if ((valid) != 0 && (module & (valid)) == (valid)) \
+    row_stats.member.add(src);
+#define ROW_ACCUMULATE_U8     ROW_ACCUMULATE_ANY
+#define ROW_ACCUMULATE_U16    ROW_ACCUMULATE_ANY
+#define ROW_ACCUMULATE_I16    ROW_ACCUMULATE_ANY
+#define ROW_ACCUMULATE_U32    ROW_ACCUMULATE_ANY
+#define ROW_ACCUMULATE_F32    ROW_ACCUMULATE_ANY
+
+#endif //_STATS_MODULE_H
@@ -0,0 +1,325 @@
+/*******************************************************************************
+ * @file    timebase_module.cpp
+ * @brief   RTC-disciplined millisecond clock (see timebase_module.h)
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#include "timebase_module.h"
+
+#if RTC_SQW_ENABLED && SLEEP_ENABLED && SLEEP_DEEP_ENABLED
+  #include <avr/sleep.h>
+#endif //RTC_SQW_ENABLED && SLEEP_ENABLED && SLEEP_DEEP_ENABLED
+
+#if RTC_SQW_ENABLED
+  static volatile uint32_t sqw_ms = 0;    //millis() at the latest SQW falling edge...
+  static volatile uint8_t sqw_edges = 0;  //...and how many there were (wraps)
+
+  // A flag left over from switching the interrupt's mode is the same edge again
+  static void sqw_isr()
+  {
+    uint32_t now = millis();
+    if (sqw_edges != 0 && now - sqw_ms < TIMEBASE_SQW_SAME_MS)
+      return;
+    sqw_ms = now;
+    sqw_edges++;
+  }
+
+  // Latest edge, read with the interrupt held off
+  static uint8_t sqw_latest(uint32_t *ms)
+  {
+    noInterrupts();
+    uint8_t n = sqw_edges;
+    if (ms != NULL)
+      *ms = sqw_ms;
+    interrupts();
+    return n;
+  }
+
+  #if SLEEP_ENABLED && SLEEP_DEEP_ENABLED
+    extern volatile unsigned long timer0_millis;  //wiring.c: what millis() returns
+
+    // Woken from power-down: LOW fires for as long as the line is low, so once
+    static void sqw_wake_isr()
+    {
+      detachInterrupt(digitalPinToInterrupt(RTC_SQW_PIN));
+      sqw_isr();
+    }
+  #endif //SLEEP_ENABLED && SLEEP_DEEP_ENABLED
+#endif //RTC_SQW_ENABLED
+
+/**************************************************************************/
+ /*!
+ *    @brief  No anchor until begin()
+ */
+/**************************************************************************/
+Timebase::Timebase()
+{
+  rtc = NULL;
+  anchor_unix = 0;
+  anchor_ms = 0;
+  have_lock = false;
+  last_step_ms = 0;
+  search_from_ms = 0;
+  prev_unix = 0;
+  prev_ms = 0;
+  have_prev = false;
+  found_unix = 0;
+  found_ms = 0;
+  found = false;
+  #if RTC_SQW_ENABLED
+    sqw_alive = true;
+    sqw_seen = 0;
+    search_edges = 0;
+    found_edges = 0;
+  #endif //RTC_SQW_ENABLED
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  One RTC read for a first anchor (up to 1 s off until the first
+ *            edge search - schedule that right away); RTC_SQW_ENABLED: turns
+ *            the 1 Hz square wave on and its interrupt
+ *        @param  clock  the DS3231, begin() done
+ */
+/**************************************************************************/
+void Timebase::begin(RTC_DS3231 *clock)
+{
+  rtc = clock;
+  anchor_unix = rtc->now().unixtime();
+  anchor_ms = millis();
+  have_lock = false;
+  #if RTC_SQW_ENABLED
+    rtc->writeSqwPinMode(DS3231_SquareWave1Hz);   //falls as the seconds register counts
+    pinMode(RTC_SQW_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(RTC_SQW_PIN), sqw_isr, FALLING);
+  #endif //RTC_SQW_ENABLED
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Starts an edge search at the next predicted second edge that is
+ *            at least TIMEBASE_GUARD_MS away
+ */
+/**************************************************************************/
+void Timebase::start()
+{
+  search_from_ms = edge_after(millis() + TIMEBASE_GUARD_MS) - TIMEBASE_GUARD_MS;
+  have_prev = false;
+  found = false;
+  #if RTC_SQW_ENABLED
+    uint32_t edge_ms;
+    search_edges = sqw_latest(&edge_ms);
+    if (search_edges != 0 && millis() - edge_ms < TIMEBASE_GUARD_MS)
+      search_edges--;           //an edge just went by (a frame start): read now, not a second later
+  #endif //RTC_SQW_ENABLED
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Edge search step: nothing before search_from_ms, then one RTC
+ *            read per call until the seconds change (or TIMEBASE_SEARCH_MS)
+ *    @return true when done (edge found or given up)
+ */
+/**************************************************************************/
+bool Timebase::poll()
+{
+  #if RTC_SQW_ENABLED
+    if (sqw_alive)
+      return poll_sqw();
+  #endif //RTC_SQW_ENABLED
+
+  uint32_t t0 = millis();
+  if ((int32_t)(t0 - search_from_ms) < 0)
+    return false;
+
+  uint32_t now_unix = rtc->now().unixtime();
+  uint32_t t = t0 + (millis() - t0) / 2;      //middle of the read
+  if (have_prev && now_unix != prev_unix)  {
+    found_unix = now_unix;                    //it started between the two reads
+    found_ms = prev_ms + (t - prev_ms) / 2;
+    found = true;
+    return true;
+  } //if (seconds changed)
+  prev_unix = now_unix;
+  prev_ms = t;
+  have_prev = true;
+  return (t - search_from_ms) > TIMEBASE_SEARCH_MS;
+}
+
+/**************************************************************************/
+ /*!
+ *    @brief  Moves the anchor to the edge the search found (if it did)
+ */
+/**************************************************************************/
+void Timebase::collect()
+{
+  if (!found)
+    return;
+  int32_t predicted_ms = anchor_ms + (int32_t)(found_unix - anchor_unix) * 1000;
+  int32_t step = (int32_t)(found_ms - predicted_ms);
+  last_step_ms = (step > 32767) ? 32767 : (step < -32768) ? -32768 : step;
+  anchor_unix = found_unix;
+  anchor_ms = found_ms;
+  have_lock = true;
+  #if RTC_SQW_ENABLED
+    sqw_seen = found_edges;     //edge() counts on from the edge found
+  #endif //RTC_SQW_ENABLED
+}
+
+/**************************************************************************/
+ /*!
+ *    @param  ms  a millis() value (before or after the anchor)
+ *    @return unixtime (RTC seconds) at that moment
+ */
+/**************************************************************************/
+uint32_t Timebase::unixtime(uint32_t ms)
+{
+  int32_t since = ms - anchor_ms;
+  if (since >= 0)
+    return anchor_unix + (uint32_t)since / 1000;
+  return anchor_unix - ((uint32_t)(-since) + 999) / 1000;
+}
+
+/**************************************************************************/
+ /*!
+ *    @param  ms  a millis() value (before or after the anchor)
+ *    @return milliseconds into that RTC second (0-999)
+ */
+/**************************************************************************/
+uint16_t Timebase::msec(uint32_t ms)
+{
+  int32_t since = ms - anchor_ms;
+  if (since >= 0)
+    return (uint32_t)since % 1000;
+  uint16_t before = (uint32_t)(-since) % 1000;
+  return before ? 1000 - before : 0;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return true once an edge search found the RTC's second edge
+ */
+/**************************************************************************/
+bool Timebase::locked()
+{
+  return have_lock;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return ms the last edge search moved the anchor (millis() drift vs the RTC)
+ */
+/**************************************************************************/
+int16_t Timebase::step_ms()
+{
+  return last_step_ms;
+}
+
+/**************************************************************************/
+ /*!
+ *    @return millis() of the first predicted second edge at or after ms
+ */
+/**************************************************************************/
+uint32_t Timebase::edge_after(uint32_t ms)
+{
+  uint16_t into = msec(ms);
+  return into ? ms + (1000 - into) : ms;
+}
+
+#if RTC_SQW_ENABLED
+  /**************************************************************************/
+   /*!
+   *    @brief  SQW edge search step: waits for the first edge after start(),
+   *            then one RTC read - that second started at the edge (read again
+   *            if the next edge came in during the read). No edge in
+   *            TIMEBASE_SEARCH_MS: the SQW line is dead, searches read from now on
+   *    @return true when done (edge found or given up)
+   */
+  /**************************************************************************/
+  bool Timebase::poll_sqw()
+  {
+    uint32_t edge_ms;
+    uint8_t n = sqw_latest(&edge_ms);
+    if (n == search_edges)  {
+      if ((int32_t)(millis() - search_from_ms) <= TIMEBASE_SEARCH_MS)
+        return false;
+      sqw_alive = false;
+      return true;
+    } //if (no edge yet)
+
+    uint32_t now_unix = rtc->now().unixtime();
+    if (sqw_latest(NULL) != n)
+      return false;
+    found_unix = now_unix;
+    found_ms = edge_ms;
+    found_edges = n;
+    found = true;
+    return true;
+  }
+
+  /**************************************************************************/
+   /*!
+   *    @brief  Moves the anchor onto the SQW edges since the last call - no
+   *            I2C; call from loop()
+   *        @param  ms  millis() of the newest edge
+   *    @return true if there was a new edge and the anchor is locked to the SQW
+   */
+  /**************************************************************************/
+  bool Timebase::edge(uint32_t &ms)
+  {
+    uint8_t n = sqw_latest(&ms);
+    uint8_t since = n - sqw_seen;
+    if (since == 0)
+      return false;
+    sqw_seen = n;
+    if (!have_lock || !sqw_alive)
+      return false;
+    anchor_unix += since;
+    anchor_ms = ms;
+    return true;
+  }
+
+  #if SLEEP_ENABLED && SLEEP_DEEP_ENABLED
+    /**************************************************************************/
+     /*!
+     *    @brief  Powers the MCU down until the next SQW edge. Pins 2 & 3 (INT4/5)
+     *            only see edges while the I/O clock runs, so the edge wakes it as
+     *            a LOW level - the line has to be high going down (second half
+     *            of the second). timer0 stands still meanwhile: millis() is put
+     *            where the anchor says the edge was (micros() stays behind)
+     *    @return true if it slept
+     */
+    /**************************************************************************/
+    bool Timebase::sleep_to_edge()
+    {
+      if (!have_lock || !sqw_alive || digitalRead(RTC_SQW_PIN) == LOW)
+        return false;
+
+      uint8_t n = sqw_latest(NULL);
+      attachInterrupt(digitalPinToInterrupt(RTC_SQW_PIN), sqw_wake_isr, LOW);
+      set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+      noInterrupts();
+      bool slept = sqw_edges == n;    //not if the edge beat us to it
+      if (slept)  {
+        sleep_enable();
+        interrupts();                 //the instruction after sei runs first: no edge lost
+        sleep_cpu();
+        sleep_disable();
+      } //if (slept)
+      interrupts();
+
+      uint32_t isr_ms;
+      uint8_t since = sqw_latest(&isr_ms) - sqw_seen;
+      if (since != 0)  {
+        uint32_t edge_ms = anchor_ms + (uint32_t)since * 1000;
+        noInterrupts();
+        timer0_millis += edge_ms - isr_ms;
+        sqw_ms = edge_ms;
+        interrupts();
+      } //if (woken by the edge)
+      attachInterrupt(digitalPinToInterrupt(RTC_SQW_PIN), sqw_isr, FALLING);
+      return slept;
+    }
+  #endif //SLEEP_ENABLED && SLEEP_DEEP_ENABLED
+#endif //RTC_SQW_ENABLED
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * @file    timebase_module.h
+ * @brief   RTC-disciplined millisecond clock: the DS3231 is read at boot and
+ *          then once every TIMEBASE_SYNC_MS, around the second edge millis()
+ *          predicts, to find where its second really starts. In between, times
+ *          come from that anchor + millis() - no I2C per row, and ms resolution.
+ *          With RTC_SQW_ENABLED the DS3231's 1 Hz square wave interrupts on every
+ *          second edge instead: the anchor follows each edge, and a sync is one
+ *          read straight after an edge
+ *
+ * @author  Percy Smith, percy.smith@colorado.edu
+ * @date    October 17, 2026
+ ******************************************************************************/
+#ifndef _TIMEBASE_MODULE_H
+#define _TIMEBASE_MODULE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <RTClib.h>           //last tested with "RTClib@2.1.4"
+
+#include "xpod_node.h"
+
+/****************** SET ADDR & CONST ********************/
+#define TIMEBASE_GUARD_MS     20      //edge search starts this long before the predicted edge
+#define TIMEBASE_SQW_SAME_MS  500     //SQW interrupts closer than this are one edge (half its period)
+#define TIMEBASE_SEARCH_MS    1200    //no second edge seen in this long: RTC not answering, keep the anchor
+                                      //(RTC_SQW_ENABLED: no SQW edge - back to reading around the edge)
+
+/****************** CLASSES ********************/
+/*! Second "anchor_unix" of the RTC started at millis() "anchor_ms". An edge
+ *  search is start() then poll() once per tick until true, then collect():
+ *  the RTC is read each tick from TIMEBASE_GUARD_MS before the predicted edge
+ *  until its seconds change, so the new anchor is good to half a tick.
+ *  RTC_SQW_ENABLED: the search is one read after the next SQW edge, and edge()
+ *  (from loop()) moves the anchor onto every edge in between. sleep_to_edge()
+ *  powers the MCU down until the next one (SLEEP_DEEP_ENABLED) */
+class Timebase {
+  public:
+    Timebase();
+    void begin(RTC_DS3231 *clock);
+    void start();
+    bool poll();
+    void collect();
+
+    uint32_t unixtime(uint32_t ms);
+    uint16_t msec(uint32_t ms);
+    bool locked();
+    int16_t step_ms();
+    #if RTC_SQW_ENABLED
+      bool edge(uint32_t &ms);
+      #if SLEEP_ENABLED && SLEEP_DEEP_ENABLED
+        bool sleep_to_edge();
+      #endif //SLEEP_ENABLED && SLEEP_DEEP_ENABLED
+    #endif //RTC_SQW_ENABLED
+
+  private:
+    uint32_t edge_after(uint32_t ms);
+    #if RTC_SQW_ENABLED
+      bool poll_sqw();
+    #endif //RTC_SQW_ENABLED
+
+    RTC_DS3231 *rtc;
+    uint32_t anchor_unix;
+    uint32_t anchor_ms;
+    bool have_lock;             //anchor from a seen edge (not just the boot read)
+    int16_t last_step_ms;       //how far the last search moved the anchor
+
+    uint32_t search_from_ms;    //edge search: first read from here...
+    uint32_t prev_unix;         //...last read & when (have_prev)
+    uint32_t prev_ms;
+    bool have_prev;
+    uint32_t found_unix;        //edge seen: this second started at found_ms
+    uint32_t found_ms;
+    bool found;
+
+    #if RTC_SQW_ENABLED
+      bool sqw_alive;           //edges seen (else: searches read around the edge)
+      uint8_t sqw_seen;         //SQW edge count edge() got to...
+      uint8_t search_edges;     //...and at start() (the search waits for the next)
+      uint8_t found_edges;      //count at the edge the search found
+    #endif //RTC_SQW_ENABLED
+};
+
+#endif //_TIMEBASE_MODULE_H
@@ -9,8 +9,44 @@
  * @date 	  August 8, 2025 
  * @log     Completely re-did PM code to timeout when no response from plantower 
  *          Did initial visualization analysis to confirm consistent behavior (looks correct)
+ *          Oct 2026: loop() is now a fixed-tick cooperative scheduler (scheduler.h),
+ *          every module is a start/poll/collect task - no more delay() between reads
+ *          Oct 2026: log file stays open all day (sd_module.h), preallocated & written in sectors
+ *          Oct 2026: optional packed binary log (SD_BINARY_ENABLED, record_module.h, host/)
+ *          Oct 2026: columns are defined once (row_schema.h); row formatted once for SD & Serial
+ *          Oct 2026: optional averaged rows (STATS_ENABLED, stats_module.h): modules oversample,
+ *          each row logs mean/sd/min/max/count per channel over STATS_PERIOD_MS
+ *          Oct 2026: optional hot-path profiler (PROFILE_ENABLED, profile_module.h): per-stage
+ *          min/mean/max micros() as "#prof," lines or per-row columns
+ *          Oct 2026: optional health columns (HEALTH_ENABLED, health_module.h): boot count,
+ *          reset cause, tick time & jitter, free stack, I2C/PMS/SD error counters
+ *          Oct 2026: PMS in active mode is drained every tick and every frame between
+ *          rows averaged into the row (PMS_AVERAGE_ENABLED), + frame & checksum drop columns
+ *          Oct 2026: optional PMS duty cycle (PMS_DUTY_ENABLED): asleep between windows, woken
+ *          PMS_DUTY_LEAD_MS early, frames before its 30 s steady state discarded
+ *          Oct 2026: S300 read once per its 3 s update without delay(), frame checked; rows
+ *          log the cached value, empty once it is older than CO2_STALE_MS
+ *          Oct 2026: file names built only when the date changes; tomorrow's file is made
+ *          ahead before midnight (SD_ROLLOVER_ENABLED) so the rollover only swaps handles
+ *          Oct 2026: rows queue until the card has them (SD_SPOOL_ENABLED, spool_module.h): card
+ *          out, they spill to EEPROM/FRAM and are replayed in order once it is back; reopen
+ *          retried with backoff, no more blocking retry loops
+ *          Oct 2026: rows stamped from an RTC-disciplined millis() timebase (timebase_module.h):
+ *          DS3231 read around a second edge once a minute instead of every row
+ *          Oct 2026: optional DS3231 1 Hz SQW interrupt (RTC_SQW_ENABLED): timebase follows every
+ *          second edge, frames & rows start on it (Scheduler::align())
+ *          Oct 2026: optional MCU sleep (SLEEP_ENABLED): idle between ticks, powered down from
+ *          the end of a frame to the next SQW edge, millis() put back on the edge
+ *          Oct 2026: optional change-based SD rows (SD_DEADBAND_ENABLED): columns within their
+ *          deadband log "=", whole rows every SD_DEADBAND_HEARTBEAT_S (host/xpod_expand)
+ *          Oct 2026: optional packed binary blocks (SD_BINARY_PACKED_ENABLED): rows delta,
+ *          zig-zag & varint coded into self-contained 512 byte blocks (host/xpod_bin2csv)
  ******************************************************************************/
 #include "xpod_node.h"
+#include "scheduler.h"
+#include "record_module.h"
+#include "profile_module.h"
+#include "health_module.h"
 
 // Communication Protocol Libraries
 #include <Wire.h>
@@ -18,24 +54,106 @@
 
 // Conditional Global Declarations
 #if SD_ENABLED
-  #include <SdFat.h>
-  SdFat sd;
-  File file;
-  char fileName[] = "XPODID_YYYY_MM_DD.CSV";
+  #if SD_PERSISTENT_ENABLED
+    #include "sd_module.h"
+    SD_Module sd_module;
+  #else
+    #include <SdFat.h>
+    SdFat sd;
+    File file;
+  #endif //SD_PERSISTENT_ENABLED
+  #if SD_PERSISTENT_ENABLED && SD_BINARY_ENABLED
+    #define LOG_EXT "BIN"
+  #else
+    #define LOG_EXT "CSV"
+  #endif //SD_PERSISTENT_ENABLED && SD_BINARY_ENABLED
+  #define LOG_NAME_BYTES    (sizeof(XPODID) + sizeof("_65535_255_255." LOG_EXT) - 1) //log_name()'s widest fields
+  char fileName[LOG_NAME_BYTES] = "XPODID_YYYY_MM_DD.CSV";
+  #if SD_PERSISTENT_ENABLED && SD_ROLLOVER_ENABLED && RTC_ENABLED
+    #define SD_ROLLOVER       1
+    char nextFileName[LOG_NAME_BYTES] = "XPODID_YYYY_MM_DD.CSV";  //tomorrow's, made ahead by sd_module.prepare()
+  #else
+    #define SD_ROLLOVER       0
+  #endif //SD_PERSISTENT_ENABLED && SD_ROLLOVER_ENABLED && RTC_ENABLED
+  #if SD_PERSISTENT_ENABLED && SD_SPOOL_ENABLED
+    #define SD_SPOOL          1
+    #include "spool_module.h"
+    Row_Spool sd_spool;                         //rows until the card has them (oldest first)
+    uint8_t sd_staged;                          //oldest spooled rows staged for the card, not on it yet...
+    uint32_t sd_staged_end[SD_SPOOL_RAM_ROWS];  //...and where each ends in the file
+    bool sd_text_newest;                        //row_text holds the newest spooled row
+  #else
+    #define SD_SPOOL          0
+  #endif //SD_PERSISTENT_ENABLED && SD_SPOOL_ENABLED
+  #if SD_SPOOL && SD_DEADBAND_ENABLED && !SD_BINARY_ENABLED
+    #define SD_DEADBAND       1
+    #define SD_DEADBAND_FLUSH_ROWS (SD_SPOOL_RAM_ROWS > 2 ? SD_SPOOL_RAM_ROWS - 2 : 1) //staged rows written out short of a sector
+    Row_Deadband sd_deadband;                   //what the file shows: SD rows log only what moved
+  #else
+    static_assert(!SD_DEADBAND_ENABLED, "SD_DEADBAND_ENABLED needs SD_SPOOL_ENABLED & CSV rows (SD_BINARY_ENABLED 0)");
+    #define SD_DEADBAND       0
+  #endif //SD_SPOOL && SD_DEADBAND_ENABLED && !SD_BINARY_ENABLED
+  #if SD_SPOOL && SD_BINARY_ENABLED && SD_BINARY_PACKED_ENABLED
+    #define SD_PACKED         1
+    #define SD_BIN_UNIT_BYTES XPOD_BIN_BLOCK_BYTES
+    #define ROW_PACK_MAX(member, label, type, en, src, scale, valid) \
+      + ROW_CAT(ROW_PACK_MAX_, en)(type)
+    #define ROW_PACK_MAX_1(type)  (sizeof(ROW_CTYPE_##type) == 1 ? 2 : sizeof(ROW_CTYPE_##type) == 2 ? 3 : 5)
+    #define ROW_PACK_MAX_0(type)  0
+    #define ROW_PACK_MAX_STAT(...) ROW_STAT(ROW_PACK_MAX, __VA_ARGS__)
+    static_assert(2 XPOD_LOG_SCHEMA(ROW_PACK_MAX) <= XPOD_BIN_BLOCK_BYTES - XPOD_BIN_BLOCK_HEAD,
+                  "a packed row can be bigger than a block");
+    Row_Pack sd_pack;                           //rows taken off the queue, coded into the next block...
+    char sd_pack_name[sizeof(fileName)];        //...for this file...
+    uint32_t sd_pack_ms;                        //...since millis() (out within SD_SYNC_MS)
+  #else
+    static_assert(!SD_BINARY_ENABLED || !SD_BINARY_PACKED_ENABLED, "SD_BINARY_PACKED_ENABLED needs SD_SPOOL_ENABLED");
+    #define SD_PACKED         0
+    #define SD_BIN_UNIT_BYTES XPOD_RECORD_BYTES
+  #endif //SD_SPOOL && SD_BINARY_ENABLED && SD_BINARY_PACKED_ENABLED
+  #if SD_PERSISTENT_ENABLED
+    uint32_t sd_retry_ms;       //last failed open...
+    uint32_t sd_backoff_ms;     //...and the wait before the next (0 = none failed)
+  #endif //SD_PERSISTENT_ENABLED
 #endif //SD_ENABLED
 
 #if RTC_ENABLED
   #include <RTClib.h>
+  #include "timebase_module.h"
   RTC_DS3231 rtc;
   DateTime rtc_date_time;
-  char bufftime[] = "YYYY-MM-DDThh:mm:ss";
-  int Y,M,D,h,m,s;
+  Timebase timebase;    //RTC read once a minute, rows stamped from millis()
+  uint32_t row_ms;      //millis() the row was stamped at...
+  uint32_t row_time;    //...its unixtime (printed YYYY-MM-DDThh:mm:ss)
+  uint32_t row_day;     //row_time / 86400 of the last row (file names)
+  int Y,M,D;
 #endif //RTC_ENABLED
 
+#if INPUTVOLT_ENABLED
+  float in_volt_val;
+#endif //INPUTVOLT_ENABLED
+
+#if STATS_ENABLED
+  #include "stats_module.h"
+  xpod_stats_t row_stats;     //this interval's samples, per channel
+  uint8_t stats_seen;         //XPOD_REC_* bits of the modules that sampled this interval
+#endif //STATS_ENABLED
+
 #if ADS_ENABLED
   #include "ads_module.h"
   ADS_Module ads_module;
   ADS_Data ads_data;
+  #if ADS_RDY_ENABLED
+    static_assert(ADS_PERIOD_MS >= SCHED_TICK_MS, "ADS_RDY_MIN_MS: an averaging interval is at least a tick");
+    constexpr uint8_t ads_rdy_pins[] = ADS_RDY_PINS;
+    constexpr bool ads_rdy_uses(uint8_t pin, uint8_t i = 0)  {
+      return i < sizeof(ads_rdy_pins) && (ads_rdy_pins[i] == pin || ads_rdy_uses(pin, i + 1));
+    } //constexpr bool ads_rdy_uses()
+    static_assert(!PMS_ENABLED || !(ads_rdy_uses(18) || ads_rdy_uses(19)),
+                  "ADS_RDY_PINS 18/19 are Serial1 (TX1/RX1), the PMS's UART");
+    static_assert(!(RTC_ENABLED && RTC_SQW_ENABLED) || !ads_rdy_uses(RTC_SQW_PIN),
+                  "RTC_SQW_PIN is one of ADS_RDY_PINS: a pin has one interrupt");
+  #endif //ADS_RDY_ENABLED
 #endif //ADS_ENABLED
 
 #if CO2_ENABLED
@@ -60,12 +178,692 @@
   #include "PMS.h"
   PMS pms(Serial1);
   PMS::DATA pms_data;
+  bool pm_returned = false;
+  #if PMS_AVERAGE_ENABLED
+    uint16_t pms_frames = 0;  //frames in this row's PM values
+  #else
+    static_assert(!PMS_DUTY_ENABLED, "PMS_DUTY_ENABLED averages its window: needs PMS_AVERAGE_ENABLED");
+    uint32_t pms_request_ms;
+  #endif //PMS_AVERAGE_ENABLED
+  #if PMS_DUTY_ENABLED
+    static_assert(PMS_DUTY_LEAD_MS + PMS_DUTY_WINDOW_MS <= PMS_DUTY_PERIOD_MS, "PMS duty window + lead > period");
+    /*! Where the sensor is in its duty cycle */
+    enum pms_duty_e
+    {
+      PMS_ASLEEP,             //fan & laser off (standby, ~0.2 mA)
+      PMS_WARMING,            //woken: frames discarded
+      PMS_MEASURING           //window: frames averaged once STEADY_RESPONSE_TIME after wake
+    }; //enum pms_duty_e
+    pms_duty_e pms_duty = PMS_MEASURING;    //awake at power-up - the first tick puts it to sleep
+    uint32_t pms_duty_origin_ms;            //scheduler start: periods count from here (like the rows)
+    uint32_t pms_woke_ms;
+    bool pms_counting = false;              //frames go into rows (window & steady)
+  #elif PMS_AVERAGE_ENABLED
+    const bool pms_counting = true;
+  #endif //PMS_DUTY_ENABLED
 #endif //PMS_ENABLED
 
 #if THE_DAWG
   #include <avr/wdt.h>
 #endif //THE_DAWG
 
+#if SLEEP_ENABLED
+  #include <avr/sleep.h>
+  #define SLEEP_DEEP          (SLEEP_DEEP_ENABLED && RTC_ENABLED && RTC_SQW_ENABLED)
+#endif //SLEEP_ENABLED
+
+Scheduler scheduler;
+xpod_record_t row_record;   //this row's values (row_schema.h)
+Row_Text row_text;          //...and its CSV text, shared by every sink
+#if SERIAL_ENABLED
+  char serial_text[ROW_TEXT_BYTES];   //the row going out of Serial...
+  uint16_t serial_len;
+  uint16_t serial_pos;                //...and how much of it is in the TX buffer
+#endif //SERIAL_ENABLED
+
+#if SD_ENABLED && SD_PERSISTENT_ENABLED
+  static_assert(ROW_TEXT_BYTES <= SD_RINGBUF_BYTES, "SD_RINGBUF_BYTES can't stage a whole row");
+#endif //SD_ENABLED && SD_PERSISTENT_ENABLED
+
+/***************************************************************************************/
+/*  AVERAGING - every collect() folds its module's fresh values into row_stats          */
+#if STATS_ENABLED
+  // module: XPOD_REC_* bits of the module that just collected (picks its columns)
+  void stats_sample(uint8_t module)  {
+    XPOD_ROW_SCHEMA(ROW_ACCUMULATE)
+    stats_seen |= module;
+  } //void stats_sample()
+#else
+  inline void stats_sample(uint8_t) {}          //rows take the latest reading
+#endif //STATS_ENABLED
+
+/***************************************************************************************/
+/*  SCHEDULER TASKS - start() kicks off work, poll() true when ready, collect() stores  */
+#if RTC_ENABLED
+  // Once a TIMEBASE_SYNC_MS: RTC read each tick around the predicted second edge
+  void time_start()  {
+    timebase.start();
+  } //void time_start()
+
+  bool time_poll()  {
+    PROFILE_SCOPE(RTC);
+    return timebase.poll();
+  } //bool time_poll()
+
+  void time_collect()  {
+    timebase.collect();
+  } //void time_collect()
+
+  #if TIMEBASE_COLUMNS_ENABLED
+    // ms from a module's last collect to the row stamp (65535: none yet / older)
+    uint16_t sample_age(sched_task_id_e id)  {
+      uint32_t age = row_ms - scheduler.stats(id).collected_ms;
+      return (age > 0xFFFF) ? 0xFFFF : age;
+    } //uint16_t sample_age()
+  #endif //TIMEBASE_COLUMNS_ENABLED
+#endif //RTC_ENABLED
+
+#if INPUTVOLT_ENABLED
+  void volt_collect()  {
+    PROFILE_SCOPE(VOLT);
+    in_volt_val = (analogRead(IN_VOLT_PIN) * 5.02 * 5) / 1023.0; //Follow up with rylee
+    stats_sample(XPOD_REC_VOLT);
+  } //void volt_collect()
+#endif //INPUTVOLT_ENABLED
+
+#if ADS_ENABLED
+  void ads_start()    { PROFILE_SCOPE(ADS); ads_module.start(); }
+  bool ads_poll()     { PROFILE_SCOPE(ADS); return ads_module.poll(); }
+  void ads_collect()  {
+    PROFILE_SCOPE(ADS);
+    ads_data = ads_module.collect();
+    stats_sample(XPOD_REC_ADS);
+  } //void ads_collect()
+#endif //ADS_ENABLED
+
+#if CO2_ENABLED
+  void co2_collect()  {
+    PROFILE_SCOPE(CO2);
+    if (CO2_module.read())  {
+      CO2 = CO2_module.getS300CO2();
+      stats_sample(XPOD_REC_CO2);
+    } //if (CO2_module.read())
+  } //void co2_collect()
+#endif //CO2_ENABLED
+
+#if BME_ENABLED
+  void bme_start()    { PROFILE_SCOPE(BME); bme_module.start(); }
+  bool bme_poll()     { PROFILE_SCOPE(BME); return bme_module.poll(); }    //heater phase - other tasks keep running
+  void bme_collect()  {
+    PROFILE_SCOPE(BME);
+    bme_data = bme_module.collect();
+    stats_sample(XPOD_REC_BME);
+  } //void bme_collect()
+#endif //BME_ENABLED
+
+#if QUAD_ENABLED
+  void quad_start()   { PROFILE_SCOPE(QUAD); quad_module.start(); }
+  bool quad_poll()    { PROFILE_SCOPE(QUAD); return quad_module.poll(); }
+  void quad_collect() {
+    PROFILE_SCOPE(QUAD);
+    quadstat_data = quad_module.collect();
+    stats_sample(XPOD_REC_QUAD);
+  } //void quad_collect()
+#endif //QUAD_ENABLED
+
+#if PMS_ENABLED && PMS_DUTY_ENABLED
+  // Duty cycle from the time within the period: asleep, then woken PMS_DUTY_LEAD_MS
+  // before the window, which ends on the period boundary. Commands go out on a change
+  // only. Frames count from STEADY_RESPONSE_TIME after wake to the window's last row
+  // (pms_row()); whatever came in before that (warm-up, stragglers) is dropped
+  void pms_duty_step()  {
+    uint32_t now = millis();
+    uint32_t phase = (now - pms_duty_origin_ms) % PMS_DUTY_PERIOD_MS;
+    pms_duty_e duty = (phase >= PMS_DUTY_PERIOD_MS - PMS_DUTY_WINDOW_MS) ? PMS_MEASURING :
+                      (phase >= PMS_DUTY_PERIOD_MS - PMS_DUTY_WINDOW_MS - PMS_DUTY_LEAD_MS) ? PMS_WARMING :
+                      PMS_ASLEEP;
+    if (duty != pms_duty)  {
+      if (duty == PMS_ASLEEP)  {
+        pms.sleep();
+      } else if (pms_duty == PMS_ASLEEP)  {
+        pms.wakeUp();
+        pms_woke_ms = now;
+      } //if (duty == PMS_ASLEEP)
+      pms_duty = duty;
+    } //if (duty != pms_duty)
+
+    if (pms_duty == PMS_ASLEEP)
+      return;
+    bool counting = pms_duty == PMS_MEASURING && (now - pms_woke_ms) >= PMS::STEADY_RESPONSE_TIME;
+    if (counting && !pms_counting)  {
+      PMS::DATA unsteady;
+      pms.takeMean(unsteady);
+    } //if (counting && !pms_counting)
+    pms_counting = counting;
+  } //void pms_duty_step()
+#endif //PMS_ENABLED && PMS_DUTY_ENABLED
+
+#if PMS_ENABLED && PMS_AVERAGE_ENABLED
+  // Active mode: a frame ~1/s, drained every tick (the UART holds only 2). The row
+  // takes the mean of every frame since the last one (pms.takeMean() in encode_row());
+  // averaged rows take each frame as a sample of its own instead
+  void pms_collect()  {
+    PROFILE_SCOPE(PMS);
+    pms.poll();
+    #if PMS_DUTY_ENABLED
+      pms_duty_step();
+    #endif //PMS_DUTY_ENABLED
+    #if STATS_ENABLED
+      if (!pms_counting)
+        return;
+      uint16_t frames = pms.takeMean(pms_data);    //1, or 2 after a long tick
+      if (frames)  {
+        pms_frames += frames;
+        stats_sample(XPOD_REC_PM_RETURNED | (pms_data.hasParticles ? XPOD_REC_PM_PARTICLES : 0));
+      } //if (frames)
+    #endif //STATS_ENABLED
+  } //void pms_collect()
+#elif PMS_ENABLED
+  void pms_start()  {
+    PROFILE_SCOPE(PMS);
+    pms_request_ms = millis();
+    pms.requestRead();
+  } //void pms_start()
+
+  // pms.read() drains whatever the UART holds in one go and never waits;
+  // give up after the same timeout readUntil() used. pm_returned only changes
+  // here, so a row taken while a request is out still gets the last frame
+  bool pms_poll()  {
+    PROFILE_SCOPE(PMS);
+    if (pms.read(pms_data))  {
+      pm_returned = true;
+      return true;
+    } //if (pms.read(pms_data))
+    if ((millis() - pms_request_ms) < PMS::SINGLE_RESPONSE_TIME)
+      return false;
+    pm_returned = false;
+    return true;
+  } //bool pms_poll()
+
+  // pms_data holds the newest verified frame (pms.read())
+  void pms_collect()  {
+    if (pm_returned)
+      stats_sample(XPOD_REC_PM_RETURNED | (pms_data.hasParticles ? XPOD_REC_PM_PARTICLES : 0));
+    else
+      HEALTH_COUNT(PMS_TIMEOUT);
+  } //void pms_collect()
+#endif //PMS_ENABLED && PMS_AVERAGE_ENABLED
+
+#if PMS_ENABLED && PMS_AVERAGE_ENABLED
+  // This row's PM: the mean of its frames. A row between two frames keeps the
+  // previous mean (PM_frames 0); after TOTAL_RESPONSE_TIME without one it is empty.
+  // Duty cycled, rows while frames don't count are empty (not a timeout)
+  void pms_row()  {
+    #if !STATS_ENABLED
+      if (pms_counting)
+        pms_frames = pms.takeMean(pms_data);
+    #endif //!STATS_ENABLED
+    if (pms_frames > 0)  {
+      pm_returned = true;
+    } else if (!pms_counting)  {
+      pm_returned = false;
+    } else if (millis() - pms.latestMs() >= PMS::TOTAL_RESPONSE_TIME)  {
+      pm_returned = false;
+      HEALTH_COUNT(PMS_TIMEOUT);
+    } //if (pms_frames > 0)
+    #if PMS_DUTY_ENABLED
+      if (pms_duty == PMS_ASLEEP)
+        pms_counting = false;       //this was the window's last row
+    #endif //PMS_DUTY_ENABLED
+  } //void pms_row()
+#endif //PMS_ENABLED && PMS_AVERAGE_ENABLED
+
+// Fills the record from the latest module data (every enabled schema column),
+// or with STATS_ENABLED from the interval's statistics - then starts the next interval
+void encode_row(xpod_record_t *rec)  {
+  record_clear(rec);
+  #if PMS_ENABLED && PMS_AVERAGE_ENABLED
+    pms_row();
+  #endif //PMS_ENABLED && PMS_AVERAGE_ENABLED
+  #if STATS_ENABLED
+    rec->f.status = stats_seen;
+  #else
+    rec->f.status = ROW_OK_LATEST;
+    #if CO2_ENABLED
+      if (!CO2_module.fresh())
+        rec->f.status &= ~XPOD_REC_CO2;   //no good S300 frame for CO2_STALE_MS: empty, not the old value
+    #endif //CO2_ENABLED
+    #if PMS_ENABLED
+      if (pm_returned)  {
+        rec->f.status |= XPOD_REC_PM_RETURNED;
+        if (pms_data.hasParticles)
+          rec->f.status |= XPOD_REC_PM_PARTICLES;
+      } //if (pm_returned)
+    #endif //PMS_ENABLED
+  #endif //STATS_ENABLED
+  XPOD_LOG_SCHEMA(ROW_ENCODE)
+  #if STATS_ENABLED
+    row_stats = xpod_stats_t();
+    stats_seen = 0;
+  #endif //STATS_ENABLED
+  #if PMS_ENABLED && PMS_AVERAGE_ENABLED
+    pms_frames = 0;
+  #endif //PMS_ENABLED && PMS_AVERAGE_ENABLED
+  #if HEALTH_ENABLED
+    health.next_row();
+  #endif //HEALTH_ENABLED
+  #if PROFILE_ENABLED && PROFILE_COLUMNS_ENABLED
+    profiler.reset();
+  #endif //PROFILE_ENABLED && PROFILE_COLUMNS_ENABLED
+} //void encode_row()
+
+#if SD_ENABLED && RTC_ENABLED
+  // Log file name for the date of "day" (FORMATTING HAS TO BE CONSISTENT WITH GLOBAL DECLARATION!!)
+  void log_name(char *name, const DateTime &day)  {
+    snprintf(name, sizeof(fileName), "%s_%04u_%02u_%02u." LOG_EXT, XPODID,
+             (uint16_t)day.year(), (uint8_t)day.month(), (uint8_t)day.day());
+  } //void log_name()
+
+  // Today's (and with SD_ROLLOVER tomorrow's) file name
+  void log_names(const DateTime &day)  {
+    log_name(fileName, day);
+    #if SD_ROLLOVER
+      log_name(nextFileName, day + TimeSpan(1, 0, 0, 0));
+    #endif //SD_ROLLOVER
+  } //void log_names()
+#endif //SD_ENABLED && RTC_ENABLED
+
+// Builds the row every LOG_PERIOD_MS: timestamp (timebase, no RTC read), then the
+// record & its CSV text - formatted once here, the SD & Serial tasks only copy it out
+void row_collect()  {
+  digitalWrite(RED_LED, HIGH);
+  #if RTC_ENABLED
+    row_ms = millis();
+    row_time = timebase.unixtime(row_ms);
+    if (row_time / 86400UL != row_day)  {           //names only change with the date
+      DateTime now(row_time);
+      row_day = row_time / 86400UL;
+      Y = now.year();  M = now.month();  D = now.day();
+      #if SD_ENABLED
+        log_names(now);
+      #endif //SD_ENABLED
+    } //if (new day)
+  #endif //RTC_ENABLED
+
+  PROFILE_SCOPE(ROW);
+  encode_row(&row_record);
+  record_format_csv(&row_record, row_text);
+} //void row_collect()
+
+#if SD_ENABLED
+  #if SD_PERSISTENT_ENABLED
+    // Opens a day's file; a new file gets its header (binary: padded to XPOD_HEADER_BYTES)
+    bool sd_open_log(const char *name)  {
+      PROFILE_SCOPE(SD_OPEN);
+      #if SD_BINARY_ENABLED
+        if (!sd_module.open(name, SD_BIN_UNIT_BYTES, XPOD_HEADER_BYTES))
+          return false;
+        if (sd_module.length() == 0)
+          record_header(sd_module, SD_PACKED ? XPOD_BIN_PACK_DELTA : XPOD_BIN_PACK_NONE);
+      #else
+        if (!sd_module.open(name))
+          return false;
+        if (sd_module.length() == 0)
+          record_print_labels(sd_module);
+      #endif //SD_BINARY_ENABLED
+      #if SD_DEADBAND
+        sd_deadband.reset();          //first row in (or back in) a file is whole
+      #endif //SD_DEADBAND
+      return true;
+    } //bool sd_open_log()
+
+    // A failed open waits SD_RETRY_MIN_MS, doubling to SD_RETRY_MAX_MS, before the next try
+    bool sd_retry_due()  {
+      return sd_backoff_ms == 0 || (millis() - sd_retry_ms) >= sd_backoff_ms;
+    } //bool sd_retry_due()
+
+    // Opens a day's file (new day, or the card came back) - one attempt, then back off
+    bool sd_reopen(const char *name)  {
+      if (!sd_retry_due())
+        return false;
+      if (sd_open_log(name))  {
+        sd_backoff_ms = 0;
+        return true;
+      } //if (sd_open_log(name))
+      HEALTH_COUNT(SD_RETRY);
+      sd_retry_ms = millis();
+      sd_backoff_ms = (sd_backoff_ms == 0) ? SD_RETRY_MIN_MS :
+                      (sd_backoff_ms >= SD_RETRY_MAX_MS / 2) ? SD_RETRY_MAX_MS : 2 * sd_backoff_ms;
+      return false;
+    } //bool sd_reopen()
+
+    #if SD_SPOOL
+      void sd_spool_stage();
+
+      // The row joins the queue; with nothing queued ahead of it it is staged
+      // right away, else sd_spool_collect() gets to it in order (SD_DEADBAND:
+      // always - its SD text must not replace row_text before the Serial copy)
+      void sd_start()  {
+        sd_text_newest = sd_spool.push(row_record);
+        if (!sd_text_newest)
+          HEALTH_COUNT(SD_LOST);
+        else if (!SD_DEADBAND && sd_spool.count() == sd_staged + 1)
+          sd_spool_stage();
+      } //void sd_start()
+
+      // Rows the card has leave the queue (a failed write: stage them again,
+      // open() resumes the file at the last commit). SD_PACKED: the one staged
+      // "row" is the block, its rows left the queue when they were packed
+      void sd_spool_done()  {
+        uint8_t done = 0;
+        if (!sd_module.is_open())  {
+          sd_staged = 0;
+          return;
+        } //if (!sd_module.is_open())
+        while (done < sd_staged && sd_module.written() >= sd_staged_end[done])
+          done++;
+        if (done > 0)  {
+          sd_module.commit(sd_staged_end[done - 1]);
+          #if SD_PACKED
+            sd_pack.clear();
+          #else
+            sd_spool.pop(done);
+          #endif //SD_PACKED
+          sd_staged -= done;
+          memmove(sd_staged_end, sd_staged_end + done, sd_staged * sizeof(sd_staged_end[0]));
+        } //if (done > 0)
+      } //void sd_spool_done()
+
+      // The file a spooled row goes in: its own date's (a backlog keeps its days)
+      void sd_name_for(const xpod_record_t &rec, char *name)  {
+        #if RTC_ENABLED
+          log_name(name, DateTime(rec.f.time));
+        #else
+          strcpy(name, fileName);
+        #endif //RTC_ENABLED
+      } //void sd_name_for()
+
+      // Makes name the open log: rows staged for another file go on the card first
+      bool sd_open_name(const char *name)  {
+        if (sd_module.is_open() && strcmp(sd_module.name(), name) == 0)
+          return true;
+        if (sd_module.is_open())  {
+          sd_module.write_out();      //rows staged for the other file: on the card first
+          sd_spool_done();
+        } //if (sd_module.is_open())
+        return sd_reopen(name);
+      } //bool sd_open_name()
+
+      bool sd_open_for(const xpod_record_t &rec)  {
+        char name[sizeof(fileName)];
+        sd_name_for(rec, name);
+        return sd_open_name(name);
+      } //bool sd_open_for()
+
+      #if SD_PACKED
+        // Hands the block to the card as one "row" (its own file: rows of a
+        // backlog can be another day's than the one open)
+        void sd_pack_stage()  {
+          if (!sd_open_name(sd_pack_name) || sd_staged > 0)
+            return;
+          if (sd_module.start_row(XPOD_BIN_BLOCK_BYTES))  {
+            sd_module.row().write(sd_pack.block(), XPOD_BIN_BLOCK_BYTES);
+            sd_staged_end[sd_staged++] = sd_module.length();
+            digitalWrite(GREEN_LED, HIGH);
+          } //if (sd_module.start_row(...))
+        } //void sd_pack_stage()
+
+        // Packs the oldest queued row into the block (the block holds it from then
+        // on). The block goes to the card once the next row doesn't fit, is another
+        // day's, or it is SD_SYNC_MS old; rows wait in the queue until it is on it.
+        // A row is only packed with its file open: card out, the queue spills
+        void sd_spool_stage()  {
+          if (sd_staged > 0 || (!sd_module.is_open() && !sd_retry_due()))
+            return;
+          if (sd_pack.rows() > 0 && (millis() - sd_pack_ms) >= SD_SYNC_MS)  {
+            sd_pack_stage();
+            return;
+          } //if (block SD_SYNC_MS old)
+          if (sd_spool.count() == 0)
+            return;
+
+          xpod_record_t rec;
+          char name[sizeof(fileName)];
+          sd_spool.get(0, rec);
+          sd_name_for(rec, name);
+          if (sd_pack.rows() > 0)  {
+            if (strcmp(name, sd_pack_name) != 0 || !sd_pack.add(&rec))  {
+              sd_pack_stage();
+              return;
+            } //if (another day's row, or block full)
+          } else {
+            if (!sd_open_name(name) || sd_staged > 0)
+              return;
+            sd_pack.add(&rec);              //fits an empty block (static_assert)
+            strcpy(sd_pack_name, name);
+            sd_pack_ms = millis();
+          } //if (sd_pack.rows() > 0)
+          sd_spool.pop(1);
+        } //void sd_spool_stage()
+      #else
+        // Stages the oldest row not staged yet for the card (a backlog row's text
+        // is made again in row_text, so only after the Serial copy)
+        void sd_spool_stage()  {
+          if (sd_spool.count() <= sd_staged || sd_staged >= SD_SPOOL_RAM_ROWS ||
+              (!sd_module.is_open() && !sd_retry_due()))
+            return;
+          xpod_record_t rec;
+          uint8_t staged = sd_staged;
+          bool newest = sd_text_newest && staged + 1 == sd_spool.count();
+          sd_spool.get(staged, rec);
+          if (!sd_open_for(rec) || sd_staged != staged)   //moved file: the queue moved too, next tick
+            return;
+          #if SD_BINARY_ENABLED
+            (void)newest;
+            if (sd_module.start_row(sizeof(rec.raw)))  {
+              sd_module.row().write(rec.raw, sizeof(rec.raw));
+              sd_staged_end[sd_staged++] = sd_module.length();
+            } //if (sd_module.start_row(...))
+          #elif SD_DEADBAND
+            (void)newest;
+            sd_deadband.format(&rec, row_text);     //against what the file shows, not the Serial row
+            sd_text_newest = false;
+            if (sd_module.start_row(row_text.length()))  {
+              sd_module.row().write(row_text.c_str(), row_text.length());
+              sd_staged_end[sd_staged++] = sd_module.length();
+              sd_deadband.commit();
+            } //if (sd_module.start_row(...))
+          #else
+            if (!newest)  {
+              record_format_csv(&rec, row_text);    //backlog row: same text as it would have had
+              sd_text_newest = false;
+            } //if (!newest)
+            if (sd_module.start_row(row_text.length()))  {
+              sd_module.row().write(row_text.c_str(), row_text.length());
+              sd_staged_end[sd_staged++] = sd_module.length();
+            } //if (sd_module.start_row(...))
+          #endif //SD_BINARY_ENABLED
+          digitalWrite(GREEN_LED, HIGH);
+        } //void sd_spool_stage()
+      #endif //SD_PACKED
+
+      // Every tick, after the row's Serial copy: rows the card has leave the
+      // queue, the next one is staged, and while the card is out the queue
+      // spills to EEPROM/FRAM a step at a time
+      void sd_spool_collect()  {
+        sd_spool_done();
+        sd_spool_stage();
+        #if SD_DEADBAND
+          if (sd_staged >= SD_DEADBAND_FLUSH_ROWS && sd_module.is_open())
+            sd_module.write_out();      //short rows: the queue would fill before a sector does
+        #endif //SD_DEADBAND
+        if (!sd_module.is_open())
+          sd_spool.spill();
+        else
+          sd_spool.tidy();              //replayed slots freed, a write at a time
+      } //void sd_spool_collect()
+    #else
+      // File stays open; the row is staged in RAM and written out sector by sector
+      void sd_start()  {
+        if (!sd_module.is_open() || strcmp(sd_module.name(), fileName) != 0)
+          sd_reopen(fileName);        //new day (or card came back)
+        #if SD_BINARY_ENABLED
+          if (sd_module.start_row(sizeof(row_record.raw)))  {
+            digitalWrite(GREEN_LED, HIGH);
+            sd_module.row().write(row_record.raw, sizeof(row_record.raw));
+          } //if (sd_module.start_row(...))
+        #else
+          if (sd_module.start_row(row_text.length()))  {
+            digitalWrite(GREEN_LED, HIGH);
+            sd_module.row().write(row_text.c_str(), row_text.length());
+          } //if (sd_module.start_row(...))
+        #endif //SD_BINARY_ENABLED
+      } //void sd_start()
+    #endif //SD_SPOOL
+
+    bool sd_poll()  {
+      return sd_module.poll();
+    } //bool sd_poll()
+
+    void sd_collect()  {
+      sd_module.collect();
+      digitalWrite(GREEN_LED, LOW);
+    } //void sd_collect()
+
+    #if SD_ROLLOVER
+      // Half a row after the row, when nothing else runs: trims & closes yesterday's
+      // file after the swap, and in the last SD_ROLLOVER_LEAD_S of the day makes
+      // tomorrow's (a step each), so at midnight sd_start() only swaps handles
+      void sd_next_collect()  {
+        bool lead = (row_time % 86400UL) >= 86400UL - SD_ROLLOVER_LEAD_S;
+        sd_module.prepare(lead ? nextFileName : NULL);
+      } //void sd_next_collect()
+    #endif //SD_ROLLOVER
+  #else
+    void sd_collect()  {
+      bool mounted;
+      digitalWrite(SD_CS, LOW);
+      {
+        PROFILE_SCOPE(SD_OPEN);
+        // beginning sd object to then open file - one attempt per row (a retry
+        // loop here starved the watchdog while the card was out)
+        mounted = sd.begin(SD_CS);
+        if (!mounted)
+          HEALTH_COUNT(SD_RETRY);
+        if (mounted)
+          file.open(fileName, O_CREAT | O_APPEND | O_WRITE); 
+      }
+      if(mounted){
+        if(file.isOpen()){
+          digitalWrite(GREEN_LED, HIGH);
+          {
+            PROFILE_SCOPE(SD_WRITE);
+            if (file.fileSize() == 0)
+              record_print_labels(file);
+            file.write(row_text.c_str(), row_text.length());
+          }
+          {
+            PROFILE_SCOPE(SD_SYNC);
+            file.sync();
+          }
+          PROFILE_SCOPE(SD_CLOSE);
+          file.close();
+        } //if(file.isOpen())
+      } //if(mounted)
+      digitalWrite(SD_CS, HIGH);
+      digitalWrite(GREEN_LED, LOW);
+    } //void sd_collect()
+  #endif //SD_PERSISTENT_ENABLED
+#endif //SD_ENABLED
+
+#if SERIAL_ENABLED
+  // The row's own copy: row_text moves on (backlog rows, the next row) while
+  // 9600 baud takes ~1 ms a byte to send it
+  void serial_start()  {
+    serial_len = row_text.length();
+    memcpy(serial_text, row_text.c_str(), serial_len);
+    serial_pos = 0;
+  } //void serial_start()
+
+  // As much of it as the TX buffer has room for - never waits for the UART
+  bool serial_poll()  {
+    PROFILE_SCOPE(SERIAL_OUT);
+    uint16_t n = serial_len - serial_pos;
+    int room = Serial.availableForWrite();
+    if (n > room)
+      n = room;
+    if (n > 0)  {
+      Serial.write(serial_text + serial_pos, n);
+      serial_pos += n;
+    } //if (n > 0)
+    return serial_pos >= serial_len;
+  } //bool serial_poll()
+
+  void serial_collect()  {}         //the row is all in the TX buffer
+
+  // Reports wait for the row to be out, else they land in the middle of it
+  bool serial_idle()  {
+    return serial_pos >= serial_len;
+  } //bool serial_idle()
+
+  #if SCHED_REPORT_ENABLED
+    void report_collect() { scheduler.report(Serial); }
+  #endif //SCHED_REPORT_ENABLED
+  #if PROFILE_ENABLED && !PROFILE_COLUMNS_ENABLED
+    void profile_collect() { profiler.report(Serial); }
+  #endif //PROFILE_ENABLED && !PROFILE_COLUMNS_ENABLED
+#endif //SERIAL_ENABLED
+
+#if SLEEP_ENABLED
+  #if SLEEP_DEEP
+    // Power-down only once the frame is done: no task due before the next edge,
+    // every row handed to the card, nothing to lose on a UART with its clock off
+    bool sleep_deep_ok()  {
+      uint32_t now = millis();
+      uint32_t to_edge = 1000 - timebase.msec(now);
+      if (to_edge < SLEEP_DEEP_MIN_MS || scheduler.quiet_ms(now) < to_edge)
+        return false;
+      #if STATS_ENABLED && STATS_SAMPLE_MS == 0
+        return false;                   //modules sample back to back
+      #endif //STATS_ENABLED && STATS_SAMPLE_MS == 0
+      #if SD_ENABLED && SD_PERSISTENT_ENABLED && SD_SPOOL_ENABLED
+        if (sd_spool.count() > sd_staged)
+          return false;                 //rows not handed to the card yet (or it is out)
+      #endif //SD_ENABLED && SD_PERSISTENT_ENABLED && SD_SPOOL_ENABLED
+      #if PMS_ENABLED && PMS_AVERAGE_ENABLED && PMS_DUTY_ENABLED
+        if (pms_duty != PMS_ASLEEP)
+          return false;                 //active mode: a frame every second
+      #elif PMS_ENABLED && PMS_AVERAGE_ENABLED
+        return false;
+      #endif //PMS_ENABLED && PMS_AVERAGE_ENABLED
+      #if SERIAL_ENABLED
+        if (Serial.availableForWrite() < SERIAL_TX_BUFFER_SIZE - 1)
+          return false;
+        Serial.flush();                 //the last byte out of the shift register
+      #endif //SERIAL_ENABLED
+      return true;
+    } //bool sleep_deep_ok()
+  #endif //SLEEP_DEEP
+
+  // Instead of spinning to the next tick: idle (CPU clock off, timers & UARTs on -
+  // timer0 wakes it within a ms), or power-down to the next SQW edge
+  void sleep_step()  {
+    #if SLEEP_DEEP
+      if (sleep_deep_ok())  {
+        #if THE_DAWG
+          wdt_reset();                  //< 1 s down, the dog keeps counting
+        #endif //THE_DAWG
+        if (timebase.sleep_to_edge())  {
+          scheduler.resume();
+          return;
+        } //if (slept)
+      } //if (sleep_deep_ok())
+    #endif //SLEEP_DEEP
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_mode();
+  } //void sleep_step()
+#endif //SLEEP_ENABLED
+
 /***************************************************************************************/
 void setup() {
   /*    COMMUNICATIONS SETUP    */
@@ -103,6 +901,9 @@ void setup() {
   #endif //QUAD_ENABLED
   #if PMS_ENABLED
     Serial1.begin(9600);
+    #if PMS_AVERAGE_ENABLED
+      pms.activeMode();     //its power-up default - but it keeps passive mode across our resets
+    #endif //PMS_AVERAGE_ENABLED
   #endif //PMS_ENABLED
 
   /*    PIN DECLARATIONS    */
@@ -132,37 +933,62 @@ void setup() {
         rtc_date_time = rtc.now();
       #endif //ADJUST_DATETIME
     }
+    timebase.begin(&rtc);         //anchored to one read; TASK_TIME finds the second edge (or SQW's)
   #endif //RTC_ENABLED
 
   /*  SD CARD & FILE SETUP  */
   #if SD_ENABLED
     digitalWrite(SD_CS, LOW);       //Pull SD_CS pin LOW to initialize SPI comms
-    sd.begin(SD_CS);                //Initialize SD Card with relevant chip select pin
-    // Establish contact with SD card - if initialization fails, run until success
-    while (!sd.begin(SD_CS)) {
-      digitalWrite(GREEN_LED, LOW);
-      digitalWrite(RED_LED, HIGH);
-      #if SERIAL_ENABLED
-        Serial.println("insert sd card to begin");
-      #endif  //SERIAL_ENABLED
-      sd.begin(SD_CS);      //attempt to initialize again
-    } //while(!sd.begin(SD_CS))
+    #if SD_SPOOL
+      sd_spool.begin();               //rows spilled before a reset go first
+      if (!sd_module.begin())         //no card: rows queue (and spill) until there is one
+        HEALTH_COUNT(SD_RETRY);
+    #elif SD_PERSISTENT_ENABLED
+      // Establish contact with SD card - if mounting fails, run until success
+      while (!sd_module.begin()) {
+        HEALTH_COUNT(SD_RETRY);
+        digitalWrite(GREEN_LED, LOW);
+        digitalWrite(RED_LED, HIGH);
+        #if SERIAL_ENABLED
+          Serial.println("insert sd card to begin");
+        #endif  //SERIAL_ENABLED
+      } //while (!sd_module.begin())
+    #else
+      sd.begin(SD_CS);                //Initialize SD Card with relevant chip select pin
+      // Establish contact with SD card - if initialization fails, run until success
+      while (!sd.begin(SD_CS)) {
+        HEALTH_COUNT(SD_RETRY);
+        digitalWrite(GREEN_LED, LOW);
+        digitalWrite(RED_LED, HIGH);
+        #if SERIAL_ENABLED
+          Serial.println("insert sd card to begin");
+        #endif  //SERIAL_ENABLED
+        sd.begin(SD_CS);      //attempt to initialize again
+      } //while(!sd.begin(SD_CS))
+    #endif //SD_PERSISTENT_ENABLED
 
     #if RTC_ENABLED
       if(rtc.begin()) {
-        //File Naming (FORMATTING HAS TO BE CONSISTENT WITH GLOBAL DECLARATION!!)
+        //File Naming (log_names())
         DateTime now = rtc.now();     //pulls setup() time so we have one file name per run in a day
         Y = now.year();    M = now.month();    D = now.day();
-        sprintf(fileName, "%s_%04u_%02u_%02u.CSV", XPODID, Y, M, D);    //char array for fileName
+        row_day = now.unixtime() / 86400UL;
+        log_names(now);
         delay(100);
       } //if(rtc.begin())
     #endif //RTC_ENABLED
 
-    file.open(fileName, O_CREAT | O_APPEND | O_WRITE);  //open with create, append, write permissions
-    delay(100);    
-    digitalWrite(GREEN_LED, HIGH);
-    digitalWrite(RED_LED, HIGH);
-    file.close();                                       //close file, we opened so loop() is faster 
+    #if SD_PERSISTENT_ENABLED
+      sd_open_log(fileName);      //stays open until the day rolls over
+      digitalWrite(GREEN_LED, HIGH);
+      digitalWrite(RED_LED, HIGH);
+    #else
+      file.open(fileName, O_CREAT | O_APPEND | O_WRITE);  //open with create, append, write permissions
+      delay(100);    
+      digitalWrite(GREEN_LED, HIGH);
+      digitalWrite(RED_LED, HIGH);
+      file.close();                                       //close file, we opened so loop() is faster 
+    #endif //SD_PERSISTENT_ENABLED
     digitalWrite(SD_CS, HIGH);    //release chip select on SD - allow other comm with SPI
   #endif //SD_ENABLED
   
@@ -170,336 +996,89 @@ void setup() {
   #if THE_DAWG
     wdt_enable(WDTO_8S);
   #endif //THE_DAWG
-} //void setup()
 
-/***************************************************************************************/
-void loop() {
-  /*  SETTING UP LOOP  */
-  digitalWrite(RED_LED, HIGH);
-  #if THE_DAWG
-    wdt_reset();
-  #endif //THE_DAWG
-
-  /*  COLLECT DATA  */
+  /*  SCHEDULER  */
   #if RTC_ENABLED
-    DateTime now = rtc.now();
-    Y = now.year();  M = now.month();  D = now.day();  h = now.hour();  m = now.minute();  s = now.second();
-    sprintf(bufftime, "%04u-%02u-%02uT%02u:%02u:%02u", Y, M, D, h, m, s); //normal timestamp format?
-    delay(100);
-    #if SD_ENABLED
-      sprintf(fileName, "%s_%04u_%02u_%02u.CSV", XPODID, Y, M, D);    //char array for fileName
-    #endif
+    scheduler.add(TASK_TIME, "TIME", TIMEBASE_SYNC_MS, 0, time_start, time_poll, time_collect);
   #endif //RTC_ENABLED
-  
   #if INPUTVOLT_ENABLED
-    float in_volt_val;
-    in_volt_val = (analogRead(IN_VOLT_PIN) * 5.02 * 5) / 1023.0; //Follow up with rylee
-  #endif
-
+    scheduler.add(TASK_VOLT, "VOLT", VOLT_PERIOD_MS, 0, NULL, NULL, volt_collect);
+  #endif //INPUTVOLT_ENABLED
   #if ADS_ENABLED
-    ads_data = ads_module.return_updated();
-    delay(100);
+    scheduler.add(TASK_ADS, "ADS", ADS_PERIOD_MS, 0, ads_start, ads_poll, ads_collect);
   #endif //ADS_ENABLED
-
   #if CO2_ENABLED
-    CO2 = CO2_module.getS300CO2();
-    delay(100);
+    scheduler.add(TASK_CO2, "CO2", CO2_PERIOD_MS, 0, NULL, NULL, co2_collect);
   #endif //CO2_ENABLED
-
   #if BME_ENABLED
-    bme_data = bme_module.return_updated();
-    delay(100);
-  #endif //CO2_ENABLED
-
+    scheduler.add(TASK_BME, "BME", BME_PERIOD_MS, 0, bme_start, bme_poll, bme_collect);
+  #endif //BME_ENABLED
   #if QUAD_ENABLED
-    quadstat_data = quad_module.return_updated();
-    delay(100);
+    scheduler.add(TASK_QUAD, "QUAD", QUAD_PERIOD_MS, 0, quad_start, quad_poll, quad_collect);
   #endif //QUAD_ENABLED
-  
-
-  #if PMS_ENABLED
-  bool pm_returned;
-    pms.requestRead();
-    if (pms.readUntil(pms_data)) {
-      pm_returned = true;
-    } else {
-      pm_returned = false;
-    } //if (pms.readUntil(pms_data)) 
-    delay(100);
-  #endif 
-
-  /*  PRINT TO SD  */
+  #if PMS_ENABLED && PMS_AVERAGE_ENABLED
+    scheduler.add(TASK_PMS, "PMS", 0, 0, NULL, NULL, pms_collect);
+  #elif PMS_ENABLED
+    scheduler.add(TASK_PMS, "PMS", PMS_PERIOD_MS, 0, pms_start, pms_poll, pms_collect);
+  #endif //PMS_ENABLED && PMS_AVERAGE_ENABLED
+  // Rows go out one period after boot so every module has finished a frame (or interval)
+  scheduler.add(TASK_ROW, "ROW", LOG_PERIOD_MS, LOG_PERIOD_MS, NULL, NULL, row_collect);
   #if SD_ENABLED
-    digitalWrite(SD_CS, LOW);
-    sd.begin(SD_CS);
-    // beginning sd object to then open file
-    while (!sd.begin(SD_CS)) {
-      #if SERIAL_ENABLED
-        Serial.println("error in loop");
-      #endif  //SERIAL_ENABLED
-      sd.begin(SD_CS);
-    } //while (!sd.begin(SD_CS))
-    if(sd.begin(SD_CS)){
-      file.open(fileName, O_CREAT | O_APPEND | O_WRITE); 
-      delay(100);
-
-      if(file.isOpen()){
-        digitalWrite(GREEN_LED, HIGH);
-        file.println();
-
-        #if RTC_ENABLED
-          file.print(bufftime);
-          file.print(F(","));
-          #else
-            file.print(F(",");
-        #endif //RTC_ENABLED
-
-        #if INPUTVOLT_ENABLED
-          file.print(in_volt_val);
-          file.print(F(","));
-          #else
-          file.print(F(","));
-        #endif //INPUTVOLT_ENABLED
-
-        #if ADS_ENABLED
-          file.print(ads_data.Fig1);
-          file.print(F(","));
-          file.print(ads_data.Fig2);
-          file.print(F(","));
-          file.print(ads_data.Fig3);
-          file.print(F(","));
-          file.print(ads_data.Fig3_heater);
-          file.print(F(","));
-          file.print(ads_data.Fig4);
-          file.print(F(","));
-          file.print(ads_data.Fig4_heater);
-          file.print(F(","));
-          #if MQ_ENABLED
-            file.print(ads_data.Mq);
-            file.print(F(","));
-          #endif //MQ_ENABLED
-          #if PID_ENABLED
-            file.print(ads_data.Pid);
-          #endif //PID_ENABLED
-          file.print(F(","));
-          file.print(ads_data.Misc2611);
-          file.print(F(","));
-          file.print(ads_data.Auxiliary);
-          file.print(F(","));
-          file.print(ads_data.Worker);
-          file.print(F(","));
-          #else 
-            file.print(F(",,,,,,,,,,")); //10 commas
-        #endif //ADS_ENABLED
-
-        #if CO2_ENABLED
-          file.print(CO2);
-          file.print(F(","));
-          #else
-            file.print(F(","));
-        #endif //CO2_ENABLED
-
-        #if BME_ENABLED
-          file.print(bme_data.T);
-          file.print(F(","));
-          file.print(bme_data.P / 100.0);
-          file.print(F(","));
-          file.print(bme_data.RH);
-          file.print(F(","));
-          file.print(bme_data.GR / 1000.0);
-          file.print(F(","));
-          #else
-            file.print(F(",,,,"));
-        #endif //BME_ENABLED
-
-        #if QUAD_ENABLED
-          file.print(quadstat_data.QS1_C1);
-          file.print(F(","));
-          file.print(quadstat_data.QS1_C2);
-          file.print(F(","));
-          file.print(quadstat_data.QS2_C1);
-          file.print(F(","));
-          file.print(quadstat_data.QS2_C2);
-          file.print(F(","));
-          file.print(quadstat_data.QS3_C1);
-          file.print(F(","));
-          file.print(quadstat_data.QS3_C2);
-          file.print(F(","));
-          file.print(quadstat_data.QS4_C1);
-          file.print(F(","));
-          file.print(quadstat_data.QS4_C2);
-          file.print(F(","));
-          #else
-            file.print(F(",,,,,,,,"));
-        #endif //QUAD_ENABLED
-
-        #if PMS_ENABLED
-        if(pm_returned) {
-          file.print(pms_data.pm10_env);
-          file.print(F(","));
-          delay(100);
-          file.print(pms_data.pm25_env);
-          file.print(F(","));
-          delay(100);
-          file.print(pms_data.pm100_env);
-          file.print(F(","));
-          delay(100);
-          #if INCLUDE_STANDARD
-            file.print(pms_data.pm10_standard);
-            file.print(F(","));
-            file.print(pms_data.pm25_standard);
-            file.print(F(","));
-            file.print(pms_data.pm100_standard);
-            file.print(F(","));
-          #else
-            file.print(F(",,,"));
-          #endif //INCLUDE_STANDARD
-          delay(100);
-          #if INCLUDE_PARTICLES
-            if(pms_data.hasParticles) {
-              file.print(pms_data.particles_03um);
-              file.print(F(","));
-              file.print(pms_data.particles_05um);
-              file.print(F(","));
-              file.print(pms_data.particles_10um);
-              file.print(F(","));
-              file.print(pms_data.particles_25um);
-              file.print(F(","));
-              file.print(pms_data.particles_50um);
-              file.print(F(","));
-              file.print(pms_data.particles_100um);
-              file.print(F(","));
-            } // if(pms_data.hasParticles)
-          #else 
-            file.print(F(",,,,,,"));
-          #endif  //INCLUDE_PARTICLES
-          delay(100);
-        } else {
-          file.print(F(",,,,,,,,,,,,"));
-        } //if(pm_returned)
-        #else 
-          file.print(F(",,,,,,,,,,,,"));
-        #endif //PMS_ENABLED
-        delay(50);
-        file.sync();
-        file.close();
-      } //if(file.isOpen())
-    } //if(sd.begin(SD_CS))
-    digitalWrite(SD_CS, HIGH);
-    digitalWrite(GREEN_LED, LOW);
+    #if SD_PERSISTENT_ENABLED
+      scheduler.add(TASK_SD, "SD", LOG_PERIOD_MS, LOG_PERIOD_MS, sd_start, sd_poll, sd_collect);
+      #if SD_SPOOL
+        scheduler.add(TASK_SD_SPOOL, "SPOOL", 0, 0, NULL, NULL, sd_spool_collect);
+      #endif //SD_SPOOL
+      #if SD_ROLLOVER
+        scheduler.add(TASK_SD_NEXT, "SDNEXT", LOG_PERIOD_MS, LOG_PERIOD_MS + LOG_PERIOD_MS / 2, NULL, NULL, sd_next_collect);
+      #endif //SD_ROLLOVER
+    #else
+      scheduler.add(TASK_SD, "SD", LOG_PERIOD_MS, LOG_PERIOD_MS, NULL, NULL, sd_collect);
+    #endif //SD_PERSISTENT_ENABLED
   #endif //SD_ENABLED
-
-  /*  PRINT TO SERIAL  */
+  #if SERIAL_ENABLED
+    scheduler.add(TASK_SERIAL, "SERIAL", LOG_PERIOD_MS, LOG_PERIOD_MS, serial_start, serial_poll, serial_collect);
+    #if SCHED_REPORT_ENABLED
+      scheduler.add(TASK_REPORT, "REPORT", SCHED_REPORT_MS, SCHED_REPORT_MS, NULL, serial_idle, report_collect);
+    #endif //SCHED_REPORT_ENABLED
+    #if PROFILE_ENABLED && !PROFILE_COLUMNS_ENABLED
+      scheduler.add(TASK_PROFILE, "PROFILE", PROFILE_REPORT_MS, PROFILE_REPORT_MS, NULL, serial_idle, profile_collect);
+    #endif //PROFILE_ENABLED && !PROFILE_COLUMNS_ENABLED
+  #endif //SERIAL_ENABLED
   #if SERIAL_ENABLED
     Serial.println();
-    #if RTC_ENABLED
-      Serial.print(bufftime);
-      Serial.print(F(","));
-    #endif //RTC_ENABLED
-    #if INPUTVOLT_ENABLED
-      Serial.print(in_volt_val);
-      Serial.print(F(","));
-    #endif
-    #if ADS_ENABLED
-      Serial.print(ads_data.Fig1);
-      Serial.print(F(","));
-      Serial.print(ads_data.Fig2);
-      Serial.print(F(","));
-      Serial.print(ads_data.Fig3);
-      Serial.print(F(","));
-      Serial.print(ads_data.Fig3_heater);
-      Serial.print(F(","));
-      Serial.print(ads_data.Fig4);
-      Serial.print(F(","));
-      Serial.print(ads_data.Fig4_heater);
-      Serial.print(F(","));
-      #if MQ_ENABLED
-        Serial.print(ads_data.Mq);
-        Serial.print(F(","));
-      #endif //MQ_ENABLED
-      #if PID_ENABLED
-        Serial.print(ads_data.Pid);
-        Serial.print(F(","));
-      #endif //PID_ENABLED
-      Serial.print(ads_data.Misc2611);
-      Serial.print(F(","));
-      Serial.print(ads_data.Auxiliary);
-      Serial.print(F(","));
-      Serial.print(ads_data.Worker);
-      Serial.print(F(","));
-    #endif //ADS_ENABLED
-    #if CO2_ENABLED
-      Serial.print(CO2);
-      Serial.print(F(","));
-    #endif //CO2_ENABLED
-    #if BME_ENABLED
-      Serial.print(bme_data.T);
-      Serial.print(F(","));
-      Serial.print(bme_data.P / 100.0);
-      Serial.print(F(","));
-      Serial.print(bme_data.RH);
-      Serial.print(F(","));
-      Serial.print(bme_data.GR / 1000.0);
-      Serial.print(F(","));
-    #endif //BME_ENABLED
-    #if QUAD_ENABLED
-      Serial.print(quadstat_data.QS1_C1);
-      Serial.print(F(","));
-      Serial.print(quadstat_data.QS1_C2);
-      Serial.print(F(","));
-      Serial.print(quadstat_data.QS2_C1);
-      Serial.print(F(","));
-      Serial.print(quadstat_data.QS2_C2);
-      Serial.print(F(","));
-      Serial.print(quadstat_data.QS3_C1);
-      Serial.print(F(","));
-      Serial.print(quadstat_data.QS3_C2);
-      Serial.print(F(","));
-      Serial.print(quadstat_data.QS4_C1);
-      Serial.print(F(","));
-      Serial.print(quadstat_data.QS4_C2);
-      Serial.print(F(","));
-    #endif //QUAD_ENABLED
-    #if PMS_ENABLED
-    if(pm_returned){
-      Serial.print(pms_data.pm10_env);
-      Serial.print(F(","));
-      delay(100);
-      Serial.print(pms_data.pm25_env);
-      Serial.print(F(","));
-      delay(100);
-      Serial.print(pms_data.pm100_env);
-      Serial.print(F(","));
-      delay(100);
-      #if INCLUDE_STANDARD
-        Serial.print(pms_data.pm10_standard);
-        Serial.print(F(","));
-        Serial.print(pms_data.pm25_standard);
-        Serial.print(F(","));
-        Serial.print(pms_data.pm100_standard);
-        Serial.print(F(","));
-      #endif //INCLUDE_STANDARD
-      delay(100);
-      #if INCLUDE_PARTICLES
-        if(pms_data.hasParticles) {
-          Serial.print(pms_data.particles_03um);
-          Serial.print(F(","));
-          Serial.print(pms_data.particles_05um);
-          Serial.print(F(","));
-          Serial.print(pms_data.particles_10um);
-          Serial.print(F(","));
-          Serial.print(pms_data.particles_25um);
-          Serial.print(F(","));
-          Serial.print(pms_data.particles_50um);
-          Serial.print(F(","));
-          Serial.print(pms_data.particles_100um);
-          Serial.print(F(","));
-        } //if(pms_data.hasParticles)
-      #endif  //INCLUDE_PARTICLES
-      delay(100);
-    } else {
-      Serial.print(F("Error reaching PMS5003"));
-    } //if(pm_returned)
-    #endif //PMS_ENABLED
+    record_print_labels(Serial);    //CSV header - every row starts with a newline
   #endif //SERIAL_ENABLED
+  #if HEALTH_ENABLED
+    health.begin();               //last: paints the stack the libraries' begin()s left free
+  #endif //HEALTH_ENABLED
+  #if PMS_ENABLED && PMS_DUTY_ENABLED
+    pms_duty_origin_ms = millis();
+  #endif //PMS_ENABLED && PMS_DUTY_ENABLED
+  scheduler.begin();
+} //void setup()
+
+/***************************************************************************************/
+void loop() {
+  #if THE_DAWG
+    wdt_reset();
+  #endif //THE_DAWG
+
+  #if RTC_ENABLED && RTC_SQW_ENABLED
+    uint32_t edge_ms;
+    if (timebase.edge(edge_ms))
+      scheduler.align(edge_ms, timebase.unixtime(edge_ms));
+  #endif //RTC_ENABLED && RTC_SQW_ENABLED
+
+  #if HEALTH_ENABLED
+    uint32_t tick_us = micros();
+    if (scheduler.run())
+      health.tick(micros() - tick_us, scheduler.tick_late_ms());
+  #else
+    scheduler.run();
+  #endif //HEALTH_ENABLED
+
+  #if SLEEP_ENABLED
+    sleep_step();
+  #endif //SLEEP_ENABLED
 } //void loop()
@@ -19,23 +19,93 @@ const uint8_t UTC_CONV = 6; //for MST choose 6, MDT choose 7
 /****************** CONFIG/SETTING ********************/
 #define SERIAL_ENABLED        1
 #define SD_ENABLED            1 //SPI (CS: D53)
+  #define SD_PERSISTENT_ENABLED 1 //keep the day's file open, RingBuf-backed (0 = reopen every row)
+    #define SD_RINGBUF_BYTES  (STATS_ENABLED ? 2048 : 1024) //staged rows (>= 2 sectors & >= one whole row)
+    #define SD_PREALLOC_BYTES (16UL * 1024 * 1024) //contiguous extent per daily .BIN file (~5 days of 1 Hz rows)
+      #define SD_PREALLOC_CSV_ENABLED 0           //CSV too: until closed the file is the whole extent, erased tail and all (host/xpod_expand skips it)
+    #define SD_SYNC_MS        60000UL             //flush + dir entry update (bounds loss on power cut)
+    #define SD_BINARY_ENABLED 0                   //packed records to .BIN (host/xpod_bin2csv -> CSV) instead of CSV text
+      #define SD_BINARY_PACKED_ENABLED 0          //needs SPOOL: rows delta/zig-zag/varint coded into 512 byte blocks (record_format.h)
+    #define SD_ROLLOVER_ENABLED 1                 //next day's file made ahead (needs RTC), midnight only swaps handles
+      #define SD_ROLLOVER_LEAD_S 600              //starts this long before midnight: create, allocate, erase - a row each
+      #define SD_TRIM_STEP_BYTES (1024UL * 1024)  //after it: yesterday's unused extent freed this much a row
+    #define SD_SPOOL_ENABLED  1                   //rows queue until the card has them; card out: spill to EEPROM/FRAM, replay later
+      #define SD_SPOOL_RAM_ROWS (STATS_ENABLED ? 3 : 12) //records in RAM: staged for the card (not yet written) + waiting
+      #define SD_SPOOL_NV_ADDR  16                //EEPROM spill ring: from here to the end (boot counter below)
+      #define SD_SPOOL_FRAM_ENABLED 0             //spill to an SPI FRAM (MB85RS64V) instead of EEPROM
+        #define SD_SPOOL_FRAM_CS  49
+        #define SD_SPOOL_FRAM_BYTES 8192
+    #define SD_DEADBAND_ENABLED 0                 //CSV only, needs SPOOL: a column moved less than its band (row_schema.h) logs "=" (host/xpod_expand)
+      #define SD_DEADBAND_HEARTBEAT_S 60          //every column logged whole at least this often (and in each file's first row)
+    #define SD_RETRY_MIN_MS   1000UL              //card out: reopen retried after this...
+    #define SD_RETRY_MAX_MS   60000UL             //...doubling up to this (never blocks the tick)
 #define RTC_ENABLED           1 //I2C (ADR: 0x68)
   #define ADJUST_DATETIME     0
   #define USE_UTC             0
+  #define TIMEBASE_SYNC_MS    60000UL //RTC read around a second edge this often; rows stamped from millis() in between
+  #define TIMEBASE_COLUMNS_ENABLED 0  //row's ms into its second & each module's sample age (ms) as columns
+  #define RTC_SQW_ENABLED     0 //DS3231 1 Hz SQW on an interrupt pin: frames start on the RTC's second edges
+    #define RTC_SQW_PIN       2 //open drain, INPUT_PULLUP (INT pins 2/3/18/19 are also ADS_RDY_PINS: not with ADS_RDY_ENABLED)
 #define INPUTVOLT_ENABLED     1
 
 #define ADS_ENABLED           1 //I2C (ADR: 0x48, 0x49, 0x4A, 0x4B)
   #define PID_ENABLED         0
   #define MQ_ENABLED          1
+  #define ADS_PARALLEL_ENABLED 1 //convert on all 4 chips at once (0 = one channel at a time)
+  #define ADS_RDY_ENABLED     0 //continuous mode, ALERT/RDY pins wired to interrupts (overrides PARALLEL)
+    #define ADS_RDY_PINS      {2, 3, 18, 19}      //ALERT/RDY of 0x48, 0x49, 0x4A, 0x4B (18/19 clash w/ PMS Serial1)
+    #define ADS_RDY_DATA_RATE RATE_ADS1115_250SPS //setDataRate() while oversampling
+    #define ADS_RING_DEPTH    32                  //samples kept per channel (power of 2)
+    #define ADS_RDY_MIN_MS    100                 //shortest averaging interval (STATS back to back): samples on every channel
 #define CO2_ENABLED           1 //I2C (ADR: 0x31)
 #define BME_ENABLED           1 //I2C (ADR: 0x76)
 #define QUAD_ENABLED          1 //I2C (ADR: 0x6E, 0x69)
+  #define QUAD_LOCKSTEP_ENABLED 1 //general-call trigger: both boards convert the same channel together
 #define PMS_ENABLED           0 //UART (TX/RX: Serial1)
   #define INCLUDE_STANDARD    0
   #define INCLUDE_PARTICLES   0
+  #define PMS_AVERAGE_ENABLED 1 //active mode: every frame between rows averaged into the row (0 = one frame per row)
+  #define PMS_DUTY_ENABLED    0 //fan only on for a window each PMS_DUTY_PERIOD_MS, asleep in between (needs AVERAGE)
+    #define PMS_DUTY_PERIOD_MS  300000UL  //one window per period; the window ends on the period boundary
+    #define PMS_DUTY_WINDOW_MS  60000UL   //frames averaged into the rows (= STATS_PERIOD_MS: one averaged row)
+    #define PMS_DUTY_LEAD_MS    30000UL   //woken this long before the window, frames discarded (>= 30 s steady state)
+
+#define STATS_ENABLED         0 //oversample every module, log one mean/sd/min/max row per interval
+  #define STATS_PERIOD_MS     60000UL //averaging interval = row cadence
+  #define STATS_SAMPLE_MS     0       //module cadence while averaging (0 = back to back, as fast as they go)
+
+#define HEALTH_ENABLED        0 //boot count, reset cause, tick time, free stack & error counters as row columns
+  #define HEALTH_EEPROM_ADDR  0 //boot counter (4 bytes)
+
+#define SLEEP_ENABLED         0 //MCU sleeps instead of spinning: idle between ticks (timer0 wakes it every ms)
+  #define SLEEP_DEEP_ENABLED  1 //power-down once the frame is done, woken by the next SQW edge (needs RTC_SQW_ENABLED)
+    #define SLEEP_DEEP_MIN_MS 50 //less than this left to the edge: idle instead
 
 #define THE_DAWG              1 //say hi to mr watchdog - he is needed for CO2 - this is a dev feature.
 
+/****************** SCHEDULER (ms) ********************/
+#define SCHED_TICK_MS         10    //every task gets stepped once per tick
+#if STATS_ENABLED
+  #define LOG_PERIOD_MS       STATS_PERIOD_MS
+  #define SAMPLE_PERIOD_MS    STATS_SAMPLE_MS
+#else
+  #define LOG_PERIOD_MS       1000  //row cadence for SD & Serial (1 Hz or faster)
+  #define SAMPLE_PERIOD_MS    LOG_PERIOD_MS   //rows take each module's latest reading
+#endif //STATS_ENABLED
+#define SCHED_FRAME_MS        (LOG_PERIOD_MS < 1000 ? 1000 : LOG_PERIOD_MS) //RTC_SQW_ENABLED: starts on a unixtime multiple of this
+  #define SCHED_ALIGN_SLACK_MS 2    //frames start 0 to 2x this after the edge (millis() steps 2 ms at times)
+#define VOLT_PERIOD_MS        SAMPLE_PERIOD_MS
+#define ADS_PERIOD_MS         ((ADS_RDY_ENABLED && SAMPLE_PERIOD_MS < ADS_RDY_MIN_MS) ? ADS_RDY_MIN_MS : SAMPLE_PERIOD_MS)
+#define CO2_PERIOD_MS         (SAMPLE_PERIOD_MS < 3000 ? 3000 : SAMPLE_PERIOD_MS)   //S300 updates every 3 s (CO2_UPDATE_MS), read ~1 ms
+#define BME_PERIOD_MS         SAMPLE_PERIOD_MS
+#define QUAD_PERIOD_MS        SAMPLE_PERIOD_MS
+#define PMS_PERIOD_MS         (SAMPLE_PERIOD_MS < 1000 ? 1000 : SAMPLE_PERIOD_MS)   //~1 frame/s (PMS_AVERAGE_ENABLED: every tick)
+#define SCHED_REPORT_ENABLED  0     //prints "#task," timing lines to Serial
+  #define SCHED_REPORT_MS     60000
+#define PROFILE_ENABLED       0     //micros() around each hot-path stage (profile_module.h)
+  #define PROFILE_COLUMNS_ENABLED 0 //per-row mean & max columns (window = row) instead of "#prof," lines
+  #define PROFILE_REPORT_MS   60000 //"#prof," lines to Serial: window length
+
 /****************** SET ADDR & CONST ********************/
 #define BME_SENSOR_ADDR       0x76
 #define CO2_I2C_ADDR          0x31